@@ -0,0 +1,836 @@
+// MIT License
+//
+// Copyright (c) 2024 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <zscript/base/zbase.h>
+#include <zscript/base/sys/assert.h>
+#include <zscript/base/memory/memory.h>
+#include <zscript/base/crypto/hash.h>
+#include <bit>
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#if __ZBASE_SSE2__
+#include <emmintrin.h>
+#endif
+
+ZBASE_BEGIN_NAMESPACE
+
+namespace flat_hash_detail {
+  /// Control byte of a slot.
+  /// - full: the 7 low bits of the hash (h2), always positive.
+  /// - empty, deleted or sentinel: negative.
+  using ctrl_t = int8_t;
+
+  inline constexpr ctrl_t k_empty = -128;
+  inline constexpr ctrl_t k_deleted = -2;
+  inline constexpr ctrl_t k_sentinel = -1;
+
+  ZB_CK_INLINE_CXPR bool is_full(ctrl_t c) noexcept { return c >= 0; }
+  ZB_CK_INLINE_CXPR bool is_empty(ctrl_t c) noexcept { return c == k_empty; }
+
+  /// Control bytes of a table without capacity.
+  /// Lookups see a sentinel followed by empty slots and stop right away.
+  alignas(16) inline constexpr ctrl_t k_empty_group[16] = { k_sentinel, k_empty, k_empty, k_empty, k_empty,
+    k_empty, k_empty, k_empty, k_empty, k_empty, k_empty, k_empty, k_empty, k_empty, k_empty, k_empty };
+
+  /// Set of matching positions in a group, one bit (or one byte) per position.
+  template <size_t Width, size_t Shift>
+  class bitmask {
+  public:
+    ZB_INLINE_CXPR explicit bitmask(uint64_t mask) noexcept
+        : _mask(mask) {}
+
+    ZB_CK_INLINE_CXPR explicit operator bool() const noexcept { return _mask != 0; }
+
+    ZB_CK_INLINE_CXPR uint32_t lowest() const noexcept { return trailing_zeros(); }
+
+    ZB_CK_INLINE_CXPR uint32_t trailing_zeros() const noexcept {
+      return (uint32_t)std::countr_zero(_mask) >> Shift;
+    }
+
+    ZB_CK_INLINE_CXPR uint32_t leading_zeros() const noexcept {
+      constexpr uint32_t k_extra_bits = 64 - (Width << Shift);
+      return (uint32_t)(std::countl_zero(_mask) - k_extra_bits) >> Shift;
+    }
+
+    ZB_INLINE_CXPR bitmask& operator++() noexcept {
+      _mask &= _mask - 1;
+      return *this;
+    }
+
+    ZB_CK_INLINE_CXPR uint32_t operator*() const noexcept { return lowest(); }
+
+    ZB_CK_INLINE_CXPR bitmask begin() const noexcept { return *this; }
+    ZB_CK_INLINE_CXPR bitmask end() const noexcept { return bitmask(0); }
+
+    ZB_CK_INLINE_CXPR bool operator!=(const bitmask& b) const noexcept { return _mask != b._mask; }
+
+  private:
+    uint64_t _mask;
+  };
+
+#if __ZBASE_SSE2__
+  /// Group of 16 control bytes, matched with SSE2.
+  struct group {
+    static constexpr size_t width = 16;
+    using bitmask_type = bitmask<16, 0>;
+
+    ZB_INLINE explicit group(const ctrl_t* ctrl) noexcept
+        : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+    ZB_CK_INLINE bitmask_type match(ctrl_t h2) const noexcept {
+      return bitmask_type((uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl)));
+    }
+
+    ZB_CK_INLINE bitmask_type match_empty() const noexcept { return match(k_empty); }
+
+    ZB_CK_INLINE bitmask_type match_empty_or_deleted() const noexcept {
+      return bitmask_type((uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(k_sentinel), _ctrl)));
+    }
+
+    __m128i _ctrl;
+  };
+#else
+  /// Group of 8 control bytes, matched with plain 64-bit integer operations.
+  struct group {
+    static constexpr size_t width = 8;
+    using bitmask_type = bitmask<8, 3>;
+
+    static constexpr uint64_t k_lsbs = 0x0101010101010101ULL;
+    static constexpr uint64_t k_msbs = 0x8080808080808080ULL;
+
+    ZB_INLINE explicit group(const ctrl_t* ctrl) noexcept {
+      __zb::memcpy(&_ctrl, ctrl, sizeof(_ctrl));
+#if !__ZBASE_LITTLE_ENDIAN__
+      _ctrl = __builtin_bswap64(_ctrl);
+#endif
+    }
+
+    /// Can have false positives (only next to a real match), the keys are compared anyway.
+    ZB_CK_INLINE bitmask_type match(ctrl_t h2) const noexcept {
+      const uint64_t x = _ctrl ^ (k_lsbs * (uint8_t)h2);
+      return bitmask_type((x - k_lsbs) & ~x & k_msbs);
+    }
+
+    ZB_CK_INLINE bitmask_type match_empty() const noexcept {
+      return bitmask_type(_ctrl & ~(_ctrl << 6) & k_msbs);
+    }
+
+    ZB_CK_INLINE bitmask_type match_empty_or_deleted() const noexcept {
+      return bitmask_type(_ctrl & ~(_ctrl << 7) & k_msbs);
+    }
+
+    uint64_t _ctrl;
+  };
+#endif
+
+  /// Capacities are always `2^n - 1`.
+  ZB_CK_INLINE_CXPR size_t normalize_capacity(size_t n) noexcept {
+    return n ? ~size_t{} >> std::countl_zero(n) : 1;
+  }
+
+  /// Maximum number of elements for a capacity (7/8 load factor).
+  ZB_CK_INLINE_CXPR size_t capacity_to_growth(size_t capacity) noexcept {
+    // With 8 wide groups, a full table of 7 would have no empty slot to stop a lookup.
+    if (group::width == 8 and capacity == 7) {
+      return 6;
+    }
+
+    return capacity - capacity / 8;
+  }
+
+  ZB_CK_INLINE_CXPR size_t growth_to_capacity(size_t growth) noexcept {
+    if (growth == 0) {
+      return 0;
+    }
+
+    if (group::width == 8 and growth == 7) {
+      return 8;
+    }
+
+    return growth + (growth - 1) / 7;
+  }
+
+  /// The user hashes are not always well distributed in the low bits (e.g. pointers),
+  /// they are mixed before being split into h1 (position) and h2 (control byte).
+  ZB_CK_INLINE_CXPR uint64_t mix_hash(uint64_t h) noexcept {
+    h *= 0x9E3779B97F4A7C15ULL;
+    return h ^ (h >> 32);
+  }
+
+  ZB_CK_INLINE_CXPR size_t h1(uint64_t h) noexcept { return (size_t)(h >> 7); }
+  ZB_CK_INLINE_CXPR ctrl_t h2(uint64_t h) noexcept { return (ctrl_t)(h & 0x7F); }
+
+  /// Quadratic probing over groups.
+  class probe_seq {
+  public:
+    ZB_INLINE_CXPR probe_seq(size_t hash, size_t mask) noexcept
+        : _mask(mask)
+        , _offset(hash & mask) {}
+
+    ZB_CK_INLINE_CXPR size_t offset() const noexcept { return _offset; }
+    ZB_CK_INLINE_CXPR size_t offset(size_t i) const noexcept { return (_offset + i) & _mask; }
+
+    ZB_INLINE_CXPR void next() noexcept {
+      _index += group::width;
+      _offset = (_offset + _index) & _mask;
+    }
+
+  private:
+    size_t _mask;
+    size_t _offset;
+    size_t _index = 0;
+  };
+
+  template <class K, class V>
+  struct map_policy {
+    using key_type = K;
+    using value_type = std::pair<const K, V>;
+
+    ZB_CK_INLINE_CXPR static const key_type& key(const value_type& v) noexcept { return v.first; }
+  };
+
+  template <class K>
+  struct set_policy {
+    using key_type = K;
+    using value_type = K;
+
+    ZB_CK_INLINE_CXPR static const key_type& key(const value_type& v) noexcept { return v; }
+  };
+
+  /// Open addressing hash table with SIMD group probing (swiss table).
+  ///
+  /// The elements are stored in a single allocation along with one control byte per slot.
+  /// A lookup matches the 7 low bits of the hash against a whole group of control bytes
+  /// at once, and only compares the keys of the matching slots.
+  ///
+  /// The lookup functions are transparent when `Hash` and `Eq` accept the key type,
+  /// e.g. `std::string_view` with `zs::object_table_hash`.
+  /// @warning Any insertion can invalidate iterators and value references.
+  template <class Policy, class Hash, class Eq, class Alloc>
+  class raw_hash_table {
+  protected:
+    using policy_type = Policy;
+
+  public:
+    using key_type = typename Policy::key_type;
+    using value_type = typename Policy::value_type;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+    using allocator_type = Alloc;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+
+    template <bool IsConst>
+    class basic_iterator {
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type = typename Policy::value_type;
+      using difference_type = ptrdiff_t;
+      using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+      using reference = std::conditional_t<IsConst, const value_type&, value_type&>;
+
+      basic_iterator() noexcept = default;
+
+      template <bool C = IsConst, std::enable_if_t<C, int> = 0>
+      ZB_INLINE basic_iterator(const basic_iterator<false>& it) noexcept
+          : _ctrl(it._ctrl)
+          , _slot(it._slot) {}
+
+      ZB_CK_INLINE reference operator*() const noexcept { return *_slot; }
+      ZB_CK_INLINE pointer operator->() const noexcept { return _slot; }
+
+      ZB_INLINE basic_iterator& operator++() noexcept {
+        ++_ctrl;
+        ++_slot;
+        skip_empty_or_deleted();
+        return *this;
+      }
+
+      ZB_INLINE basic_iterator operator++(int) noexcept {
+        basic_iterator it = *this;
+        ++*this;
+        return it;
+      }
+
+      ZB_CK_INLINE friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+        return a._ctrl == b._ctrl;
+      }
+
+      ZB_CK_INLINE friend bool operator!=(const basic_iterator& a, const basic_iterator& b) noexcept {
+        return a._ctrl != b._ctrl;
+      }
+
+    private:
+      friend class raw_hash_table;
+      friend class basic_iterator<!IsConst>;
+
+      ZB_INLINE basic_iterator(const ctrl_t* ctrl, pointer slot) noexcept
+          : _ctrl(ctrl)
+          , _slot(slot) {}
+
+      ZB_INLINE void skip_empty_or_deleted() noexcept {
+        while (*_ctrl < k_sentinel) {
+          ++_ctrl;
+          ++_slot;
+        }
+      }
+
+      const ctrl_t* _ctrl = nullptr;
+      pointer _slot = nullptr;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    ZB_INLINE explicit raw_hash_table(const allocator_type& alloc) noexcept
+        : _alloc(alloc) {}
+
+    ZB_INLINE raw_hash_table(
+        size_type bucket_count, const hasher& h = hasher(), const key_equal& eq = key_equal(), const allocator_type& alloc = allocator_type())
+        : _alloc(alloc)
+        , _hash(h)
+        , _eq(eq) {
+      reserve(bucket_count);
+    }
+
+    ZB_INLINE raw_hash_table(size_type bucket_count, const allocator_type& alloc)
+        : raw_hash_table(bucket_count, hasher(), key_equal(), alloc) {}
+
+    ZB_INLINE raw_hash_table(const raw_hash_table& t)
+        : _alloc(t._alloc)
+        , _hash(t._hash)
+        , _eq(t._eq) {
+      reserve(t.size());
+      for (const value_type& v : t) {
+        emplace_unique_at(prepare_insert(hash_key(policy_type::key(v))), v);
+      }
+    }
+
+    ZB_INLINE raw_hash_table(raw_hash_table&& t) noexcept
+        : _ctrl(std::exchange(t._ctrl, (ctrl_t*)k_empty_group))
+        , _slots(std::exchange(t._slots, nullptr))
+        , _size(std::exchange(t._size, 0))
+        , _capacity(std::exchange(t._capacity, 0))
+        , _growth_left(std::exchange(t._growth_left, 0))
+        , _alloc(t._alloc)
+        , _hash(std::move(t._hash))
+        , _eq(std::move(t._eq)) {}
+
+    ZB_INLINE ~raw_hash_table() noexcept { destroy_and_deallocate(); }
+
+    ZB_INLINE raw_hash_table& operator=(const raw_hash_table& t) {
+      if (this != &t) {
+        clear();
+        _hash = t._hash;
+        _eq = t._eq;
+        reserve(t.size());
+        for (const value_type& v : t) {
+          emplace_unique_at(prepare_insert(hash_key(policy_type::key(v))), v);
+        }
+      }
+      return *this;
+    }
+
+    ZB_INLINE raw_hash_table& operator=(raw_hash_table&& t) noexcept {
+      if (this != &t) {
+        destroy_and_deallocate();
+        _ctrl = std::exchange(t._ctrl, (ctrl_t*)k_empty_group);
+        _slots = std::exchange(t._slots, nullptr);
+        _size = std::exchange(t._size, 0);
+        _capacity = std::exchange(t._capacity, 0);
+        _growth_left = std::exchange(t._growth_left, 0);
+        _alloc = t._alloc;
+        _hash = std::move(t._hash);
+        _eq = std::move(t._eq);
+      }
+      return *this;
+    }
+
+    ZB_CK_INLINE allocator_type get_allocator() const noexcept { return allocator_type(_alloc); }
+    ZB_CK_INLINE hasher hash_function() const noexcept { return _hash; }
+    ZB_CK_INLINE key_equal key_eq() const noexcept { return _eq; }
+
+    ZB_CK_INLINE size_type size() const noexcept { return _size; }
+    ZB_CK_INLINE bool empty() const noexcept { return _size == 0; }
+    ZB_CK_INLINE size_type capacity() const noexcept { return _capacity; }
+
+    ZB_CK_INLINE iterator begin() noexcept {
+      iterator it(_ctrl, _slots);
+      it.skip_empty_or_deleted();
+      return it;
+    }
+
+    ZB_CK_INLINE iterator end() noexcept { return iterator(_ctrl + _capacity, nullptr); }
+
+    ZB_CK_INLINE const_iterator begin() const noexcept { return const_cast<raw_hash_table*>(this)->begin(); }
+    ZB_CK_INLINE const_iterator end() const noexcept { return const_cast<raw_hash_table*>(this)->end(); }
+    ZB_CK_INLINE const_iterator cbegin() const noexcept { return begin(); }
+    ZB_CK_INLINE const_iterator cend() const noexcept { return end(); }
+
+    template <class K>
+    ZB_CK_INLINE iterator find(const K& key) noexcept {
+      if constexpr (is_transparent_key<K>()) {
+        return find_impl(key);
+      }
+      else {
+        return find_impl(key_type(key));
+      }
+    }
+
+    template <class K>
+    ZB_CK_INLINE const_iterator find(const K& key) const noexcept {
+      return const_cast<raw_hash_table*>(this)->find(key);
+    }
+
+    template <class K>
+    ZB_CK_INLINE bool contains(const K& key) const noexcept {
+      return find(key) != end();
+    }
+
+    template <class K>
+    ZB_CK_INLINE size_type count(const K& key) const noexcept {
+      return find(key) != end();
+    }
+
+    template <class K>
+    inline size_type erase(const K& key) noexcept {
+      if (iterator it = find(key); it != end()) {
+        erase_at(it);
+        return 1;
+      }
+
+      return 0;
+    }
+
+    /// Unlike the std containers, nothing is moved on erase: the returned iterator
+    /// is simply the next element.
+    inline iterator erase(const_iterator cit) noexcept {
+      iterator it(cit._ctrl, const_cast<value_type*>(cit._slot));
+      erase_at(it);
+      ++it;
+      return it;
+    }
+
+    inline iterator erase(iterator it) noexcept { return erase(const_iterator(it)); }
+
+    inline void clear() noexcept {
+      if (!_capacity) {
+        return;
+      }
+
+      destroy_slots();
+      reset_ctrl();
+      _size = 0;
+      _growth_left = capacity_to_growth(_capacity);
+    }
+
+    /// Make room for at least `n` elements without rehashing.
+    inline void reserve(size_type n) {
+      if (n > _size + _growth_left) {
+        resize(normalize_capacity(growth_to_capacity(n)));
+      }
+    }
+
+    inline void rehash(size_type n) {
+      if (n == 0 and _size == 0) {
+        destroy_and_deallocate();
+        reset_to_empty();
+        return;
+      }
+
+      resize(normalize_capacity((std::max)(n, growth_to_capacity(_size))));
+    }
+
+    inline void swap(raw_hash_table& t) noexcept {
+      std::swap(_ctrl, t._ctrl);
+      std::swap(_slots, t._slots);
+      std::swap(_size, t._size);
+      std::swap(_capacity, t._capacity);
+      std::swap(_growth_left, t._growth_left);
+      std::swap(_alloc, t._alloc);
+      std::swap(_hash, t._hash);
+      std::swap(_eq, t._eq);
+    }
+
+    ZB_CK_INLINE friend bool operator==(const raw_hash_table& a, const raw_hash_table& b) noexcept {
+      if (a.size() != b.size()) {
+        return false;
+      }
+
+      for (const value_type& v : a) {
+        const_iterator it = b.find(policy_type::key(v));
+        if (it == b.end() or !(*it == v)) {
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+  protected:
+    using slot_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<uint8_t>;
+
+    static_assert(alignof(value_type) <= alignof(std::max_align_t), "unsupported value alignment");
+
+    ctrl_t* _ctrl = (ctrl_t*)k_empty_group;
+    value_type* _slots = nullptr;
+    size_type _size = 0;
+    size_type _capacity = 0;
+    size_type _growth_left = 0;
+    slot_allocator_type _alloc;
+    hasher _hash;
+    key_equal _eq;
+
+    template <class K>
+    ZB_CK_INLINE static constexpr bool is_transparent_key() noexcept {
+      return std::is_same_v<K, key_type>
+          or (std::is_invocable_v<const hasher&, const K&>
+              and std::is_invocable_r_v<bool, const key_equal&, const key_type&, const K&>);
+    }
+
+    template <class K>
+    ZB_CK_INLINE uint64_t hash_key(const K& key) const noexcept {
+      return mix_hash((uint64_t)_hash(key));
+    }
+
+    template <class K>
+    ZB_CK_INLINE iterator find_impl(const K& key) noexcept {
+      const uint64_t hash = hash_key(key);
+      const ctrl_t tag = h2(hash);
+      probe_seq seq(h1(hash), _capacity);
+
+      while (true) {
+        const group g(_ctrl + seq.offset());
+
+        for (uint32_t i : g.match(tag)) {
+          const size_type idx = seq.offset(i);
+          if (ZBASE_LIKELY(_eq(policy_type::key(_slots[idx]), key))) {
+            return iterator_at(idx);
+          }
+        }
+
+        if (ZBASE_LIKELY((bool)g.match_empty())) {
+          return end();
+        }
+
+        seq.next();
+      }
+    }
+
+    /// Find the position of `key` or prepare a new slot for it.
+    /// Returns the slot index and whether it needs to be constructed.
+    template <class K>
+    inline std::pair<size_type, bool> find_or_prepare_insert(const K& key) {
+      const uint64_t hash = hash_key(key);
+      const ctrl_t tag = h2(hash);
+      probe_seq seq(h1(hash), _capacity);
+
+      while (true) {
+        const group g(_ctrl + seq.offset());
+
+        for (uint32_t i : g.match(tag)) {
+          const size_type idx = seq.offset(i);
+          if (ZBASE_LIKELY(_eq(policy_type::key(_slots[idx]), key))) {
+            return { idx, false };
+          }
+        }
+
+        if (ZBASE_LIKELY((bool)g.match_empty())) {
+          return { prepare_insert(hash), true };
+        }
+
+        seq.next();
+      }
+    }
+
+    template <class K>
+    inline std::pair<size_type, bool> find_or_prepare_insert_key(const K& key) {
+      if constexpr (is_transparent_key<K>()) {
+        return find_or_prepare_insert(key);
+      }
+      else {
+        return find_or_prepare_insert(key_type(key));
+      }
+    }
+
+    ZB_CK_INLINE size_type find_first_non_full(uint64_t hash) const noexcept {
+      probe_seq seq(h1(hash), _capacity);
+
+      while (true) {
+        const group g(_ctrl + seq.offset());
+        if (auto mask = g.match_empty_or_deleted()) {
+          return seq.offset(mask.lowest());
+        }
+
+        seq.next();
+      }
+    }
+
+    /// True when inserting a new key can grow the table and move its elements.
+    ZB_CK_INLINE bool is_growth_needed() const noexcept { return _growth_left == 0; }
+
+    /// Reserve a slot for a key that is known not to be in the table.
+    inline size_type prepare_insert(uint64_t hash) {
+      size_type idx = find_first_non_full(hash);
+
+      if (ZBASE_UNLIKELY(_growth_left == 0 and !(_ctrl[idx] == k_deleted))) {
+        rehash_and_grow_if_necessary();
+        idx = find_first_non_full(hash);
+      }
+
+      _growth_left -= is_empty(_ctrl[idx]);
+      set_ctrl(idx, h2(hash));
+      ++_size;
+      return idx;
+    }
+
+    ZB_CK_INLINE iterator iterator_at(size_type idx) noexcept { return iterator(_ctrl + idx, _slots + idx); }
+
+    template <class... Args>
+    ZB_INLINE iterator emplace_unique_at(size_type idx, Args&&... args) {
+      zb_placement_new(_slots + idx) value_type(std::forward<Args>(args)...);
+      return iterator_at(idx);
+    }
+
+    ZB_INLINE void set_ctrl(size_type idx, ctrl_t c) noexcept {
+      _ctrl[idx] = c;
+      // The first `width - 1` bytes are cloned after the sentinel so that a group can be
+      // loaded from any position without wrapping around.
+      constexpr size_type k_cloned_bytes = group::width - 1;
+      _ctrl[((idx - k_cloned_bytes) & _capacity) + (k_cloned_bytes & _capacity)] = c;
+    }
+
+    inline void erase_at(iterator it) noexcept {
+      const size_type idx = (size_type)(it._ctrl - _ctrl);
+      std::destroy_at(it._slot);
+      --_size;
+
+      // If the slot was never part of a full group, no lookup could have probed past it
+      // and it can be marked empty instead of deleted.
+      const size_type idx_before = (idx - group::width) & _capacity;
+      const auto empty_after = group(_ctrl + idx).match_empty();
+      const auto empty_before = group(_ctrl + idx_before).match_empty();
+
+      const bool was_never_full = empty_before and empty_after
+          and (size_type)(empty_after.trailing_zeros() + empty_before.leading_zeros()) < group::width;
+
+      set_ctrl(idx, was_never_full ? k_empty : k_deleted);
+      _growth_left += was_never_full;
+    }
+
+    inline void rehash_and_grow_if_necessary() {
+      // Lots of tombstones: rehash at the same capacity to clean them up.
+      if (_capacity > group::width and _size * 32 <= _capacity * 25) {
+        resize(_capacity);
+      }
+      else {
+        resize(_capacity * 2 + 1);
+      }
+    }
+
+    inline void resize(size_type new_capacity) {
+      ctrl_t* old_ctrl = _ctrl;
+      value_type* old_slots = _slots;
+      const size_type old_capacity = _capacity;
+
+      allocate(new_capacity);
+
+      for (size_type i = 0; i < old_capacity; i++) {
+        if (is_full(old_ctrl[i])) {
+          const uint64_t hash = hash_key(policy_type::key(old_slots[i]));
+          const size_type idx = find_first_non_full(hash);
+          set_ctrl(idx, h2(hash));
+          zb_placement_new(_slots + idx) value_type(std::move(old_slots[i]));
+          std::destroy_at(old_slots + i);
+        }
+      }
+
+      _growth_left = capacity_to_growth(_capacity) - _size;
+
+      if (old_capacity) {
+        _alloc.deallocate((uint8_t*)old_ctrl, allocation_size(old_capacity));
+      }
+    }
+
+    ZB_CK_INLINE static size_type slot_offset(size_type capacity) noexcept {
+      constexpr size_type k_align = alignof(value_type);
+      return (capacity + group::width + k_align - 1) & ~(k_align - 1);
+    }
+
+    ZB_CK_INLINE static size_type allocation_size(size_type capacity) noexcept {
+      return slot_offset(capacity) + capacity * sizeof(value_type);
+    }
+
+    inline void allocate(size_type capacity) {
+      zbase_assert(((capacity + 1) & capacity) == 0, "capacity must be 2^n - 1");
+      uint8_t* mem = _alloc.allocate(allocation_size(capacity));
+      _ctrl = (ctrl_t*)mem;
+      _slots = (value_type*)(mem + slot_offset(capacity));
+      _capacity = capacity;
+      reset_ctrl();
+    }
+
+    ZB_INLINE void reset_ctrl() noexcept {
+      __zb::memset(_ctrl, k_empty, _capacity + group::width);
+      _ctrl[_capacity] = k_sentinel;
+    }
+
+    ZB_INLINE void reset_to_empty() noexcept {
+      _ctrl = (ctrl_t*)k_empty_group;
+      _slots = nullptr;
+      _size = 0;
+      _capacity = 0;
+      _growth_left = 0;
+    }
+
+    ZB_INLINE void destroy_slots() noexcept {
+      if constexpr (!std::is_trivially_destructible_v<value_type>) {
+        for (size_type i = 0; i < _capacity; i++) {
+          if (is_full(_ctrl[i])) {
+            std::destroy_at(_slots + i);
+          }
+        }
+      }
+    }
+
+    ZB_INLINE void destroy_and_deallocate() noexcept {
+      if (_capacity) {
+        destroy_slots();
+        _alloc.deallocate((uint8_t*)_ctrl, allocation_size(_capacity));
+      }
+    }
+  };
+} // namespace flat_hash_detail.
+
+/// Open addressing hash map (swiss table), see `flat_hash_detail::raw_hash_table`.
+template <class Key, class T, class Hash = __zb::rapid_hasher<Key>, class Eq = std::equal_to<Key>,
+    class Alloc = std::allocator<std::pair<const Key, T>>>
+class flat_hash_map
+    : public flat_hash_detail::raw_hash_table<flat_hash_detail::map_policy<Key, T>, Hash, Eq, Alloc> {
+  using base = flat_hash_detail::raw_hash_table<flat_hash_detail::map_policy<Key, T>, Hash, Eq, Alloc>;
+
+public:
+  using mapped_type = T;
+  using typename base::iterator;
+  using typename base::key_type;
+  using typename base::value_type;
+
+  using base::base;
+
+  flat_hash_map() noexcept(std::is_nothrow_default_constructible_v<Alloc>)
+      : base(Alloc()) {}
+
+  template <class K, class... Args>
+  inline std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+    // The arguments can refer to an element (e.g. `m.try_emplace(k, m[other])`),
+    // the value is constructed before the table grows and moves them.
+    if (ZBASE_UNLIKELY(this->is_growth_needed())) {
+      if (iterator it = this->find(key); it != this->end()) {
+        return { it, false };
+      }
+
+      value_type value(std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+          std::forward_as_tuple(std::forward<Args>(args)...));
+      const auto idx = this->prepare_insert(this->hash_key(value.first));
+      return { this->emplace_unique_at(idx, std::move(value)), true };
+    }
+
+    const auto [idx, inserted] = this->find_or_prepare_insert_key(key);
+
+    if (inserted) {
+      return { this->emplace_unique_at(idx, std::piecewise_construct, std::forward_as_tuple(std::forward<K>(key)),
+                   std::forward_as_tuple(std::forward<Args>(args)...)),
+        true };
+    }
+
+    return { this->iterator_at(idx), false };
+  }
+
+  /// Same as `try_emplace`, nothing is constructed if the key already exists.
+  template <class K, class... Args>
+  ZB_INLINE std::pair<iterator, bool> emplace(K&& key, Args&&... args) {
+    return try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+  }
+
+  ZB_INLINE std::pair<iterator, bool> insert(const value_type& v) { return try_emplace(v.first, v.second); }
+
+  ZB_INLINE std::pair<iterator, bool> insert(value_type&& v) {
+    return try_emplace(std::move(const_cast<key_type&>(v.first)), std::move(v.second));
+  }
+
+  template <class K, class V>
+  inline std::pair<iterator, bool> insert_or_assign(K&& key, V&& value) {
+    auto res = try_emplace(std::forward<K>(key), std::forward<V>(value));
+    if (!res.second) {
+      res.first->second = std::forward<V>(value);
+    }
+    return res;
+  }
+
+  template <class K>
+  ZB_CK_INLINE mapped_type& operator[](K&& key) {
+    return try_emplace(std::forward<K>(key)).first->second;
+  }
+};
+
+/// Open addressing hash set (swiss table), see `flat_hash_detail::raw_hash_table`.
+template <class Key, class Hash = __zb::rapid_hasher<Key>, class Eq = std::equal_to<Key>,
+    class Alloc = std::allocator<Key>>
+class flat_hash_set : public flat_hash_detail::raw_hash_table<flat_hash_detail::set_policy<Key>, Hash, Eq, Alloc> {
+  using base = flat_hash_detail::raw_hash_table<flat_hash_detail::set_policy<Key>, Hash, Eq, Alloc>;
+
+public:
+  using typename base::iterator;
+  using typename base::key_type;
+  using typename base::value_type;
+
+  using base::base;
+
+  flat_hash_set() noexcept(std::is_nothrow_default_constructible_v<Alloc>)
+      : base(Alloc()) {}
+
+  template <class K>
+  inline std::pair<iterator, bool> insert(K&& key) {
+    const auto [idx, inserted] = this->find_or_prepare_insert_key(key);
+
+    if (inserted) {
+      return { this->emplace_unique_at(idx, std::forward<K>(key)), true };
+    }
+
+    return { this->iterator_at(idx), false };
+  }
+
+  template <class K>
+  ZB_INLINE std::pair<iterator, bool> emplace(K&& key) {
+    return insert(std::forward<K>(key));
+  }
+};
+
+ZBASE_END_NAMESPACE
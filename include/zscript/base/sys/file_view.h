@@ -67,7 +67,13 @@ public:
     return *this;
   }
 
-  [[nodiscard]] __zb::error_result open(const char* file_path) noexcept;
+  /// With `copy_on_write`, the mapped pages can be written through `mutable_data()`.
+  /// They stay shared with the other mappings of the file until written, the
+  /// changes are private and never reach the file.
+  enum class open_mode { read_only, copy_on_write };
+
+  [[nodiscard]] __zb::error_result open(
+      const char* file_path, open_mode mode = open_mode::read_only) noexcept;
 
   [[nodiscard]] inline __zb::error_result open(const std::string& file_path) noexcept {
     return open(file_path.c_str());
@@ -118,6 +124,9 @@ public:
 
   [[nodiscard]] inline const_pointer data() const noexcept { return _data; }
 
+  /// Only writable when opened with `open_mode::copy_on_write`.
+  [[nodiscard]] inline pointer mutable_data() noexcept { return _data; }
+
   [[nodiscard]] inline const_pointer data(size_type offset) const noexcept {
     assert(is_open() && "access nullptr");
     assert(offset < size() && "offset out of bounds");
@@ -9,6 +9,7 @@
 #include <zscript/base/utility/integer_enum.h>
 
 #include <zscript/base/crypto/hash.h>
+#include <zscript/base/container/flat_hash_map.h>
 #include <zscript/base/container/small_vector.h>
 #include <zscript/base/container/span.h>
 #include <zscript/base/container/vector.h>
@@ -79,6 +80,14 @@
 #error "ZS_MEMORY_PROFILER requires a value"
 #endif // ZS_MEMORY_PROFILER.
 
+/// Sampling profiler of the script code (see `virtual_machine::start_profiler()`).
+/// When disabled, the interpreter loop has no safe point check.
+#ifndef ZS_SCRIPT_PROFILER
+#define ZS_SCRIPT_PROFILER 1
+#elif ZBASE_IS_MACRO_EMPTY(ZS_SCRIPT_PROFILER)
+#error "ZS_SCRIPT_PROFILER requires a value"
+#endif // ZS_SCRIPT_PROFILER.
+
 /// Exceptions.
 #ifndef ZS_CONFIG_USE_EXCEPTION
 #define ZS_CONFIG_USE_EXCEPTION 1
@@ -86,6 +95,17 @@
 #error "ZS_CONFIG_USE_EXCEPTION requires a value"
 #endif // ZS_CONFIG_USE_EXCEPTION.
 
+/// Threaded dispatch in the interpreter loop (requires labels as values).
+#ifndef ZS_USE_COMPUTED_GOTO
+#if __ZBASE_CLANG__ || __ZBASE_GCC__
+#define ZS_USE_COMPUTED_GOTO 1
+#else
+#define ZS_USE_COMPUTED_GOTO 0
+#endif
+#elif ZBASE_IS_MACRO_EMPTY(ZS_USE_COMPUTED_GOTO)
+#error "ZS_USE_COMPUTED_GOTO requires a value"
+#endif // ZS_USE_COMPUTED_GOTO.
+
 #if ZS_MEMORY_PROFILER
 #define ZS_IF_MEMORY_PROFILER(...) __VA_ARGS__
 #define ZS_IF_MEMORY_PROFILER_OR(A, B) A
@@ -578,6 +598,7 @@ enum class meta_method : uint32_t {
 #define _X(name, str) name,
   ZS_META_METHOD_ENUM(_X)
 #undef _X
+  count
 };
 
 static_assert(uint8_t(zs::object_type::k_small_string) == 0, "object_type::k_small_string must be zero.");
@@ -610,7 +631,7 @@ void* reallocate(
 /// Deallocate memory.
 void deallocate(zs::engine* eng, void* ptr, alloc_info_t ainfo = alloc_info_t{});
 
-enum class memory_tag {
+enum class memory_tag : alloc_info_t {
   nt_unknown,
   nt_engine,
   nt_vm,
@@ -808,13 +829,13 @@ using small_vector = zb::small_vector<_T, _Size, zs::allocator<_T>>;
 template <class Key, class Value>
 using unordered_map_allocator = zs::allocator<std::pair<const Key, Value>>;
 
-/// unordered_map.
+/// unordered_map (open addressing, see zb::flat_hash_map).
 template <class Key, class T, class Hash = zb::rapid_hasher<Key>, class Pred = std::equal_to<Key>>
-using unordered_map = std::unordered_map<Key, T, Hash, Pred, zs::unordered_map_allocator<Key, T>>;
+using unordered_map = zb::flat_hash_map<Key, T, Hash, Pred, zs::unordered_map_allocator<Key, T>>;
 
-/// unordered_set.
+/// unordered_set (open addressing, see zb::flat_hash_set).
 template <class T, class Hash = zb::rapid_hasher<T>, class Pred = std::equal_to<T>>
-using unordered_set = std::unordered_set<T, Hash, Pred, zs::allocator<T>>;
+using unordered_set = zb::flat_hash_set<T, Hash, Pred, zs::allocator<T>>;
 
 using ostringstream = std::basic_ostringstream<char, std::char_traits<char>, zs::string_allocator>;
 
@@ -859,12 +880,18 @@ using object_unordered_map = zs::unordered_map<object, T, object_table_hash, obj
 
 using object_map = zs::object_unordered_map<object>;
 
+/// Key/value pair stored in a table.
+using table_value_type = std::pair<const object, object>;
+
+class table_map;
+
 using object_unordered_set = zs::unordered_set<object, object_table_hash, object_table_equal_to>;
 
 class reference_counted_object : public engine_holder {
 public:
   ZS_OBJECT_CLASS_COMMON;
   friend class weak_ref_object;
+  friend class garbage_collector;
 
   reference_counted_object(zs::engine* eng, object_type obj_type) noexcept;
 
@@ -893,7 +920,11 @@ private:
   ZBASE_PRAGMA_PUSH()
   ZBASE_CLANG_DIAGNOSTIC(ignored, "-Wgnu-anonymous-struct")
   struct {
-    size_t _ref_count : 56;
+    size_t _ref_count : 54;
+    // Set while the object is in the garbage collector possible roots.
+    size_t _gc_possible_root : 1;
+    // Set while the object is part of the garbage collector graph.
+    size_t _gc_node : 1;
     object_type _obj_type : 8;
   };
   ZBASE_PRAGMA_POP()
@@ -1076,6 +1107,9 @@ inline constexpr const char* meta_method_name(meta_method mm) noexcept {
 
     ZS_META_METHOD_ENUM(_X)
 #undef _X
+
+  case meta_method::count:
+    break;
   }
 
   ZS_ERROR("invalid meta method");
@@ -1138,6 +1172,33 @@ namespace constants {
   inline constexpr size_t k_small_string_max_size
       = k_object_size - (sizeof(object_flags_t) + sizeof(object_type));
 
+  /// Longest string interned by `object::create_interned_string()`, longer ones are
+  /// created as regular strings.
+  inline constexpr size_t k_max_interned_string_size = 64;
+
+  /// Number of possible cycle roots that starts a collection (see `engine::set_garbage_collector_threshold()`).
+  inline constexpr size_t k_default_gc_threshold = 4096;
+
+  /// Maximum number of objects traversed by a collection step.
+  inline constexpr size_t k_default_gc_step_budget = 1024;
+
+  /// Number of created objects between two steps of a collection in progress.
+  inline constexpr size_t k_gc_step_interval = 64;
+
+  /// Size of the first chunk of an arena (see `engine::begin_arena()`).
+  inline constexpr size_t k_default_arena_chunk_size = 64 * 1024;
+
+  /// The arena chunks double in size up to this size.
+  inline constexpr size_t k_max_arena_chunk_size = 16 * 1024 * 1024;
+
+  /// Largest buffer created by `bytes(size)`, the mapped files aren't limited.
+  inline constexpr size_t k_max_bytes_size = (size_t)1 << 31;
+
+  /// Set on the `alloc_info_t` of the storage of a container that lives outside
+  /// of the arena, it is removed before calling the allocator callback
+  /// (see `engine::get_storage_alloc_info()`).
+  inline constexpr alloc_info_t k_outside_arena_alloc_flag = 0x80000000;
+
   inline constexpr alloc_info_t k_engine_deallocation = 80198;
   inline constexpr alloc_info_t k_user_pointer_deallocation = 80199;
 
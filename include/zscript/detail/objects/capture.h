@@ -14,6 +14,7 @@ public:
   ZS_CHECK static capture& as_capture(const object_base& obj) noexcept;
 
   ZS_CHECK static bool is_capture(const object_base& obj) noexcept;
+  ZS_CHECK static bool is_capture(const user_data_object& uobj) noexcept;
 
   ZS_CK_INLINE bool is_baked() const noexcept { return _is_baked; }
 
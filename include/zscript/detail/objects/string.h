@@ -10,6 +10,11 @@ public:
   ZS_CHECK static string_object* create(zs::engine* eng, std::string_view s);
   ZS_CHECK static string_object* create(zs::engine* eng, size_t n);
 
+  /// Returns the engine's unique string_object for `s`, creating it if needed.
+  /// Interned strings are held weakly by the engine, two of them with the
+  /// same content are always the same object and can be compared by pointer.
+  ZS_CHECK static string_object* create_interned(zs::engine* eng, std::string_view s);
+
   ZS_CK_INLINE std::string_view get_string() const noexcept { return std::string_view(_str, _size); }
   ZS_CK_INLINE const char* get_cstring() const noexcept { return _str; }
 
@@ -26,6 +31,8 @@ public:
 
   void update_hash() const noexcept;
 
+  ZS_CK_INLINE bool is_interned() const noexcept { return _interned; }
+
 private:
   inline string_object(zs::engine* eng) noexcept
       : reference_counted_object(eng, object_type::k_long_string) {}
@@ -34,6 +41,7 @@ private:
 
   size_t _size;
   mutable uint64_t _hash = 0;
+  bool _interned = false;
   char _str[1];
 
   static void destroy_callback(zs::engine* eng, reference_counted_object* obj) noexcept;
@@ -208,6 +208,10 @@ public:
 
   ZS_CK_INLINE bool has_default_constructor() const noexcept { return _has_default_constructor; }
 
+  /// @brief Engine unique version tag of this struct.
+  /// Members are never reordered, a member slot index stays valid for the struct lifetime.
+  ZS_CK_INLINE uint64_t get_version() const noexcept { return _version; }
+
   ZS_CK_INLINE bool has_constructors() const noexcept {
     return _constructors.is_function() or _constructors.is_array();
   }
@@ -224,6 +228,7 @@ private:
   ~struct_object() noexcept = default;
 
   object _name;
+  uint64_t _version;
   static_member_vector _statics;
   method_vector _methods;
   zs::object _constructors;
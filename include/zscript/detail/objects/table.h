@@ -4,16 +4,11 @@
 
 namespace zs {
 
-struct object_map_content : zs::object_map {
-  using base = object_map;
-  using base::base;
-};
-
 class table_object final : public delegable_object {
 public:
   ZS_OBJECT_CLASS_COMMON;
 
-  using map_type = object_map_content;
+  using map_type = table_map;
   using value_type = map_type::value_type;
   using size_type = map_type::size_type;
   using iterator = map_type::iterator;
@@ -32,8 +27,15 @@ public:
   ZS_CK_INLINE int_t size() const noexcept { return (int_t)_map->size(); }
   ZS_CK_INLINE bool empty() const noexcept { return _map->empty(); }
 
-  ZS_INLINE void reserve(size_type n) noexcept { _map->reserve(n); }
-  ZS_INLINE void clear() noexcept { _map->clear(); }
+  ZS_INLINE void reserve(size_type n) noexcept {
+    _map->reserve(n);
+    update_version();
+  }
+
+  ZS_INLINE void clear() noexcept {
+    _map->clear();
+    update_version();
+  }
 
   //
   // MARK: Queries.
@@ -69,12 +71,21 @@ public:
 
   template <class K>
   ZS_CK_INLINE object& operator[](K&& key) noexcept {
+    const size_type sz = _map->size();
+    object* obj;
+
     if constexpr (std::is_constructible_v<std::string_view, K>) {
-      return (*_map)[zs::_s(get_engine(), key)];
+      obj = &(*_map)[zs::_s(get_engine(), key)];
     }
     else {
-      return (*_map)[std::forward<K>(key)];
+      obj = &(*_map)[std::forward<K>(key)];
+    }
+
+    if (_map->size() != sz) {
+      update_version();
     }
+
+    return *obj;
   }
 
   zs::error_result get(const object& key, object& dst) const noexcept;
@@ -99,12 +110,17 @@ public:
   inline zs::error_result set(Key&& key, Value&& obj) noexcept {
 
     if constexpr (std::is_constructible_v<std::string_view, Key>) {
-      _map->insert_or_assign(zs::_s(get_engine(), key), std::forward<Value>(obj));
+      if (_map->insert_or_assign(zs::_s(get_engine(), key), std::forward<Value>(obj)).second) {
+        update_version();
+      }
     }
     else {
-      _map->insert_or_assign(std::forward<Key>(key), std::forward<Value>(obj));
-      return {};
+      if (_map->insert_or_assign(std::forward<Key>(key), std::forward<Value>(obj)).second) {
+        update_version();
+      }
     }
+
+    return {};
   }
 
   template <class Key, class Value>
@@ -116,12 +132,13 @@ public:
 
     if constexpr (std::is_constructible_v<std::string_view, Key>) {
       _map->emplace(zs::_s(get_engine(), std::string_view(key)), std::forward<Value>(obj));
-      return {};
     }
     else {
       _map->emplace(std::forward<Key>(key), std::forward<Value>(obj));
-      return {};
     }
+
+    update_version();
+    return {};
   }
 
   template <class Key, class Value>
@@ -136,24 +153,55 @@ public:
 
   template <class K, class T>
   ZS_INLINE std::pair<iterator, bool> insert_or_assign(K&& key, T&& val) {
-    return _map->insert_or_assign(std::forward<K>(key), std::forward<T>(val));
+    auto res = _map->insert_or_assign(std::forward<K>(key), std::forward<T>(val));
+
+    if (res.second) {
+      update_version();
+    }
+
+    return res;
   }
 
   template <class K, class... _Args>
   inline std::pair<iterator, bool> emplace(K&& key, _Args&&... args) {
+    std::pair<iterator, bool> res;
+
     if constexpr (std::is_constructible_v<std::string_view, K>) {
-      return _map->emplace(zs::_s(get_engine(), std::string_view(key)), std::forward<_Args>(args)...);
+      res = _map->emplace(zs::_s(get_engine(), std::string_view(key)), std::forward<_Args>(args)...);
     }
     else {
-      return _map->emplace(std::forward<K>(key), std::forward<_Args>(args)...);
+      res = _map->emplace(std::forward<K>(key), std::forward<_Args>(args)...);
     }
+
+    if (res.second) {
+      update_version();
+    }
+
+    return res;
   }
 
   zs::error_result erase(const object& key) noexcept;
 
-  ZS_CK_INLINE map_type& get_map() noexcept { return *_map; }
+  /// @warning The map can be modified directly, the version is renewed on every call.
+  ZS_CK_INLINE map_type& get_map() noexcept {
+    update_version();
+    return *_map;
+  }
+
   ZS_CK_INLINE const map_type& get_map() const noexcept { return *_map; }
 
+  /// @brief Version tag of the table layout.
+  ///
+  /// A new tag is assigned on every structural change (insertion, erase, clear, rehash).
+  /// Values pointers remain valid as long as the version doesn't change.
+  ZS_CK_INLINE uint64_t get_version() const noexcept { return _version; }
+
+  /// @brief Returns the meta method `mt` if it is a key of this table, or nullptr.
+  ///
+  /// Which meta methods the table has is remembered until the next structural
+  /// change, looking for a missing one in a delegate chain doesn't hash its name.
+  ZS_CHECK const zs::object* get_meta_method(meta_method mt) const noexcept;
+
   /// @brief Compare the content of two tables.
   ZS_CK_INLINE bool operator==(const table_object& tbl) const noexcept { return *_map == *tbl._map; }
 
@@ -161,9 +209,16 @@ public:
 
 private:
   map_type* _map;
-  uint8_t _data[1];
+  uint64_t _version;
+
+  // One bit per `meta_method`, cleared by `update_version()`.
+  mutable uint64_t _meta_method_known_mask;
+  mutable uint64_t _meta_method_mask;
+  alignas(map_type) uint8_t _data[1];
 
   table_object(zs::engine* eng);
+
+  void update_version() noexcept;
   ~table_object() noexcept = default;
 
   static void destroy_callback(zs::engine* eng, reference_counted_object* obj) noexcept;
@@ -0,0 +1,223 @@
+#ifndef ZS_SCRIPT_INCLUDE_OBJECTS
+#error This file should only be included in object.h
+#endif // ZS_SCRIPT_INCLUDE_OBJECTS
+
+namespace zs {
+
+/// Key/value storage of a table.
+///
+/// The pairs are stored contiguously in insertion order, the first `k_inline_capacity`
+/// ones directly inside the map (no allocation). Up to `k_small_size` pairs, lookups
+/// are a linear scan. Past that, an open addressing index (linear probing) pointing
+/// into the pairs is built.
+///
+/// Erasing a pair moves the last one in its place.
+/// @warning Any insertion, erase or reserve can invalidate iterators and value pointers.
+class table_map {
+public:
+  using key_type = object;
+  using mapped_type = object;
+  using value_type = zs::table_value_type;
+  using size_type = size_t;
+  using iterator = value_type*;
+  using const_iterator = const value_type*;
+  using hasher = object_table_hash;
+  using key_equal = object_table_equal_to;
+
+  static constexpr size_type k_inline_capacity = 4;
+  static constexpr size_type k_small_size = 8;
+  static constexpr size_type npos = (size_type)-1;
+
+  table_map(zs::engine* eng) noexcept;
+  table_map(const table_map&) = delete;
+  table_map(table_map&&) = delete;
+
+  ~table_map() noexcept;
+
+  table_map& operator=(const table_map& m) noexcept;
+  table_map& operator=(table_map&&) = delete;
+
+  ZS_CK_INLINE zs::engine* get_engine() const noexcept { return _engine; }
+
+  ZS_CK_INLINE size_type size() const noexcept { return _size; }
+  ZS_CK_INLINE bool empty() const noexcept { return _size == 0; }
+  ZS_CK_INLINE size_type capacity() const noexcept { return _capacity; }
+
+  void reserve(size_type n) noexcept;
+  void clear() noexcept;
+
+  ZS_CK_INLINE iterator begin() noexcept { return _data; }
+  ZS_CK_INLINE iterator end() noexcept { return _data + _size; }
+  ZS_CK_INLINE const_iterator begin() const noexcept { return _data; }
+  ZS_CK_INLINE const_iterator end() const noexcept { return _data + _size; }
+  ZS_CK_INLINE const_iterator cbegin() const noexcept { return _data; }
+  ZS_CK_INLINE const_iterator cend() const noexcept { return _data + _size; }
+
+  template <class K>
+  ZS_CK_INLINE iterator find(const K& key) noexcept {
+    const size_type idx = find_index(key);
+    return idx == npos ? end() : _data + idx;
+  }
+
+  template <class K>
+  ZS_CK_INLINE const_iterator find(const K& key) const noexcept {
+    const size_type idx = find_index(key);
+    return idx == npos ? end() : _data + idx;
+  }
+
+  template <class K>
+  ZS_CK_INLINE bool contains(const K& key) const noexcept {
+    return find_index(key) != npos;
+  }
+
+  template <class K>
+  ZS_CK_INLINE size_type count(const K& key) const noexcept {
+    return find_index(key) != npos;
+  }
+
+  template <class K>
+  ZS_CK_INLINE object& operator[](K&& key) noexcept {
+    return try_emplace(std::forward<K>(key)).first->second;
+  }
+
+  template <class K, class... Args>
+  inline std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) noexcept {
+    if (const size_type idx = find_index(key); idx != npos) {
+      return { _data + idx, false };
+    }
+
+    return { push_back(std::forward<K>(key), std::forward<Args>(args)...), true };
+  }
+
+  template <class K, class... Args>
+  ZS_INLINE std::pair<iterator, bool> emplace(K&& key, Args&&... args) noexcept {
+    return try_emplace(std::forward<K>(key), std::forward<Args>(args)...);
+  }
+
+  template <class K, class V>
+  inline std::pair<iterator, bool> insert_or_assign(K&& key, V&& value) noexcept {
+    if (const size_type idx = find_index(key); idx != npos) {
+      _data[idx].second = std::forward<V>(value);
+      return { _data + idx, false };
+    }
+
+    return { push_back(std::forward<K>(key), std::forward<V>(value)), true };
+  }
+
+  template <class K>
+  inline size_type erase(const K& key) noexcept {
+    if (const size_type idx = find_index(key); idx != npos) {
+      erase_index(idx);
+      return 1;
+    }
+
+    return 0;
+  }
+
+  ZS_INLINE iterator erase(const_iterator it) noexcept {
+    const size_type idx = it - _data;
+    erase_index(idx);
+    return _data + idx;
+  }
+
+  /// Compare the content of two maps (the order doesn't matter).
+  ZS_CHECK bool operator==(const table_map& m) const noexcept;
+
+  template <class K>
+  ZS_CK_INLINE size_type find_index(const K& key) const noexcept {
+    if constexpr (!std::is_base_of_v<object_base, K> and !std::is_convertible_v<const K&, std::string_view>) {
+      return find_index(object(key));
+    }
+    else {
+      return find_index_impl(key);
+    }
+  }
+
+private:
+  template <class K>
+  ZS_CK_INLINE size_type find_index_impl(const K& key) const noexcept {
+    if (!_index) {
+      for (size_type i = 0; i < _size; i++) {
+        if (key_equal{}(_data[i].first, key)) {
+          return i;
+        }
+      }
+
+      return npos;
+    }
+
+    const uint32_t tag = hash_tag(hasher{}(key));
+
+    for (size_t pos = tag & _index_mask;; pos = (pos + 1) & _index_mask) {
+      const index_slot& slot = _index[pos];
+
+      if (!slot.index) {
+        return npos;
+      }
+
+      if (slot.tag == tag and key_equal{}(_data[slot.index - 1].first, key)) {
+        return slot.index - 1;
+      }
+    }
+  }
+
+  struct index_slot {
+    /// One past the index of the pair in `_data`, zero means empty.
+    uint32_t index;
+    uint32_t tag;
+  };
+
+  zs::engine* _engine;
+  value_type* _data;
+  index_slot* _index = nullptr;
+  uint32_t _size = 0;
+  uint32_t _capacity = k_inline_capacity;
+  size_t _index_mask = 0;
+  alignas(value_type) uint8_t _inline_data[k_inline_capacity * sizeof(value_type)];
+
+  /// The low bits of the hash, also used as start position in the index.
+  ZS_CK_INLINE static uint32_t hash_tag(size_t h) noexcept { return (uint32_t)h; }
+
+  ZS_CK_INLINE bool is_inline() const noexcept { return (const uint8_t*)_data == _inline_data; }
+
+  template <class K, class... Args>
+  inline iterator push_back(K&& key, Args&&... args) noexcept {
+    // The arguments could refer to the current pairs, the new pair is constructed
+    // before moving them to a bigger buffer.
+    const bool needs_grow = _size == _capacity;
+    value_type* data = needs_grow ? allocate_data(_capacity * 2) : _data;
+
+    zb_placement_new(data + _size) value_type(std::piecewise_construct,
+        std::forward_as_tuple(std::forward<K>(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+
+    if (needs_grow) {
+      relocate(data, _capacity * 2);
+    }
+
+    value_type* p = _data + _size++;
+
+    if (_index) {
+      if (_size * 2 > _index_mask + 1) {
+        rebuild_index(_size * 2);
+      }
+      else {
+        insert_index_slot(_size - 1);
+      }
+    }
+    else if (_size > k_small_size) {
+      rebuild_index(_size * 2);
+    }
+
+    return p;
+  }
+
+  ZS_CHECK value_type* allocate_data(size_type n) noexcept;
+
+  /// Move the pairs to `data` (with capacity `n`) and release the previous buffer.
+  void relocate(value_type* data, size_type n) noexcept;
+  void rebuild_index(size_type n) noexcept;
+  void insert_index_slot(size_type idx) noexcept;
+  void erase_index(size_type idx) noexcept;
+  void release_index() noexcept;
+};
+} // namespace zs.
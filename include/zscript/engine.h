@@ -5,20 +5,95 @@
 namespace zs {
 
 class garbage_collector_rc_proxy;
-
+class instruction_iterator;
+
+/// Tracks all the reference counted objects of an engine and collects the
+/// unreachable reference cycles.
+///
+/// Reference counting frees everything but cycles. When a reference counted
+/// object is released without being destroyed, it is buffered as a possible
+/// cycle root. A collection cycle takes some possible roots, builds the
+/// graph of objects reachable from them and subtracts the references that
+/// are internal to that graph (trial deletion). Objects still referenced
+/// from outside the graph, and everything reachable from them, are alive.
+/// The others are only referenced by each other and get cleared, which
+/// breaks the cycles and lets reference counting free them.
+///
+/// A cycle is incremental: each step traverses at most `_step_budget` objects
+/// and the state is kept until the next step. The program runs in between, so
+/// the garbage found at the end is only cleared after checking that all the
+/// references to it still come from the garbage itself.
+///
+/// Only the references that are known to be counted are followed, anything
+/// else (e.g. the content of a user data) is seen as an external reference.
 class garbage_collector : zs::engine_holder {
   friend class zs::engine;
   friend class zs::garbage_collector_rc_proxy;
   using unordered_set_type = zs::unordered_set<zs::reference_counted_object*>;
 
+  enum class phase : uint8_t {
+    idle,
+
+    /// Building the graph of the objects reachable from the roots.
+    mark,
+
+    /// Subtracting the internal references.
+    trial_deletion,
+
+    /// Propagating the externally referenced objects.
+    scan
+  };
+
+  struct node {
+    /// Null once the object was destroyed.
+    zs::reference_counted_object* obj;
+
+    /// Number of references from outside the graph, `k_alive` once scanned.
+    size_t count;
+  };
+
+  static constexpr size_t k_alive = (size_t)-1;
+
   garbage_collector(zs::engine* eng);
 
   static void add(zs::engine* eng, zs::reference_counted_object* obj);
   static void remove(zs::engine* eng, zs::reference_counted_object* obj);
+  static void add_possible_root(zs::engine* eng, zs::reference_counted_object* obj);
+
+  /// Only these objects can hold references to other reference counted objects.
+  ZS_CK_INLINE_CXPR static bool is_traversable(object_type t) noexcept {
+    return t != object_type::k_long_string and t != object_type::k_weak_ref;
+  }
+
+  /// Runs the current collection cycle for at most `budget` traversed objects,
+  /// starting a new one from the possible roots when none is in progress.
+  /// Returns the number of objects freed when the cycle is done in this step.
+  size_t step(size_t budget);
+
+  /// Collect the cycles among all the tracked objects.
+  size_t collect();
+
+  /// Runs a step when the threshold is reached or when a cycle is in progress.
+  void step_if_needed();
+
+  void add_node(zs::reference_counted_object* obj);
+  size_t run(size_t budget);
+  size_t finish();
+  void reset_cycle();
 
   void finalize();
 
   zb::aligned_type_storage<unordered_set_type> _objs;
+  unordered_set_type _possible_roots;
+  zs::vector<node> _nodes;
+  zs::unordered_map<zs::reference_counted_object*, size_t> _node_indices;
+  zs::vector<size_t> _alive;
+  size_t _cursor = 0;
+  size_t _step_countdown = 0;
+  size_t _threshold = constants::k_default_gc_threshold;
+  size_t _step_budget = constants::k_default_gc_step_budget;
+  phase _phase = phase::idle;
+  bool _is_collecting = false;
 };
 
 class garbage_collector_rc_proxy {
@@ -31,6 +106,161 @@ class garbage_collector_rc_proxy {
   ZS_INLINE static void remove(zs::engine* eng, zs::reference_counted_object* obj) {
     garbage_collector::remove(eng, obj);
   }
+
+  ZS_INLINE static void add_possible_root(zs::engine* eng, zs::reference_counted_object* obj) {
+    garbage_collector::add_possible_root(eng, obj);
+  }
+
+  ZS_CK_INLINE_CXPR static bool is_traversable(object_type t) noexcept {
+    return garbage_collector::is_traversable(t);
+  }
+};
+
+/// Bump pointer arena used by the engine between `engine::begin_arena()` and
+/// `engine::end_arena()`.
+///
+/// Only the memory of the short lived objects (strings, tables, arrays, ...)
+/// comes from the arena, anything else still goes to the engine allocator.
+/// Freeing an arena block only decrements the number of live blocks, the
+/// chunks are released at once when the arena is destroyed.
+class arena_allocator : zs::engine_holder {
+  ZS_CLASS_COMMON;
+  friend class zs::engine;
+
+  struct chunk {
+    uint8_t* data;
+    size_t size;
+  };
+
+  arena_allocator(zs::engine* eng, size_t chunk_size);
+  ~arena_allocator();
+
+  /// Returns true if allocations with this `memory_tag` are made in the arena.
+  ZS_CK_INLINE_CXPR static bool is_arena_tag(alloc_info_t info) noexcept {
+    switch ((memory_tag)info) {
+    case memory_tag::nt_array:
+    case memory_tag::nt_table:
+    case memory_tag::nt_struct:
+    case memory_tag::nt_string:
+    case memory_tag::nt_user_data:
+    case memory_tag::nt_native_closure:
+    case memory_tag::nt_weak_ptr:
+      return true;
+    default:
+      return false;
+    }
+  }
+
+  ZS_CHECK void* allocate(size_t size);
+  ZS_CHECK void* reallocate(void* ptr, size_t size);
+  void deallocate(void* ptr) noexcept;
+
+  /// Binary search in the chunks, sorted by address.
+  ZS_CHECK bool contains(const void* ptr) const noexcept;
+
+  ZS_CHECK bool add_chunk(size_t min_size);
+
+  zs::vector<chunk> _chunks;
+  uint8_t* _begin = nullptr;
+  uint8_t* _end = nullptr;
+  uint8_t* _last_block = nullptr;
+  size_t _chunk_size;
+  size_t _live_count = 0;
+  bool _is_open = true;
+};
+
+/// Allocation counters of a `memory_tag` or of a script call site
+/// (see `engine::start_allocation_tracking()`).
+struct allocation_stats {
+  size_t live_bytes = 0;
+  size_t peak_bytes = 0;
+  size_t live_count = 0;
+
+  /// Number of allocations since the tracking started, reallocations included.
+  size_t allocation_count = 0;
+};
+
+/// Allocations made while running a line of a script function.
+struct allocation_site_stats {
+  zs::string name;
+  zs::string source_name;
+  uint32_t line = 0;
+  allocation_stats stats;
+};
+
+/// Counts the engine allocations between `engine::start_allocation_tracking()`
+/// and `engine::stop_allocation_tracking()`.
+///
+/// The allocator callback isn't given the size of a freed block, every block
+/// allocated while tracking is kept in a side table with its size, tag and call
+/// site. Blocks allocated before the tracking started are ignored when freed.
+///
+/// The call site is the function and line of the script instruction being run
+/// (see `engine::script_position`), allocations made from C++ outside of any
+/// script call only count for their tag. A reallocation counts as a free of the
+/// old block followed by an allocation at the current site.
+///
+/// The tables are allocated by the engine with `memory_tag::nt_allocator`, the
+/// tracker is paused while it updates them, its own blocks are never counted.
+class allocation_tracker : zs::engine_holder {
+  ZS_CLASS_COMMON;
+  friend class zs::engine;
+
+public:
+  static constexpr size_t k_tag_count = (size_t)memory_tag::nt_allocator + 1;
+
+  /// Tag name without its `nt_` prefix (e.g. "table").
+  ZS_CHECK static std::string_view get_tag_name(memory_tag tag) noexcept;
+
+private:
+  static constexpr uint32_t k_no_site = (uint32_t)-1;
+
+  struct block {
+    size_t size;
+    uint32_t tag;
+    uint32_t site;
+  };
+
+  struct site_key {
+    const void* fct;
+    uint32_t line;
+
+    ZS_CK_INLINE friend bool operator==(const site_key& lhs, const site_key& rhs) noexcept {
+      return lhs.fct == rhs.fct and lhs.line == rhs.line;
+    }
+  };
+
+  struct site_key_hash {
+    ZS_CK_INLINE size_t operator()(const site_key& key) const noexcept {
+      return std::hash<const void*>()(key.fct) ^ ((size_t)key.line * 0x9E3779B97F4A7C15ull);
+    }
+  };
+
+  struct site {
+    zs::string name;
+    zs::string source_name;
+    uint32_t line;
+    allocation_stats stats;
+  };
+
+  allocation_tracker(zs::engine* eng);
+
+  void add(const void* ptr, size_t size, alloc_info_t ainfo);
+  void remove(const void* ptr) noexcept;
+
+  /// Index in `_sites` of the current script position, `k_no_site` outside of a script call.
+  ZS_CHECK uint32_t get_site_index();
+
+  ZS_CHECK zs::vector<allocation_site_stats> get_site_stats();
+
+  std::array<allocation_stats, k_tag_count> _tag_stats = {};
+  zs::unordered_map<const void*, block> _blocks;
+  zs::unordered_map<site_key, uint32_t, site_key_hash> _site_indices;
+  zs::vector<site> _sites;
+
+  /// Set while the tracker allocates (its tables or the copied stats), these
+  /// allocations and deallocations are ignored.
+  bool _is_paused = false;
 };
 
 class engine_rc_proxy;
@@ -89,6 +319,29 @@ public:
 
   ZS_CHECK zs::error_result resolve_file_path(std::string_view import_value, object& result);
 
+  /// Adds a zip archive as an import root. Its central directory is indexed
+  /// once and the modules are read straight from the archive.
+  /// The archives are searched before the import directories.
+  zs::error_result add_import_archive(const std::filesystem::path& archive);
+
+  ZS_INLINE zs::error_result add_import_archive(zb::string_view archive) {
+    return add_import_archive(std::filesystem::path(std::string_view(archive)));
+  }
+
+  ZS_INLINE zs::error_result add_import_archive(const char* archive) {
+    return add_import_archive(std::filesystem::path(archive));
+  }
+
+  /// Array of the import archives (see `zs::import_archive`).
+  ZS_CHECK const object& get_import_archives() const noexcept;
+
+  /// Directory where the compiled modules are cached by `compile_or_load_file()`,
+  /// it is created if needed. An empty path disables the cache (the default).
+  ZS_CHECK zs::error_result set_bytecode_cache_directory(const std::filesystem::path& directory);
+
+  /// Returns the cache directory string, or null when the cache is disabled.
+  ZS_CHECK const object& get_bytecode_cache_directory() const noexcept;
+
   ZS_CHECK object& get_registry_table() noexcept;
   ZS_CHECK const object& get_registry_table() const noexcept;
 
@@ -99,17 +352,156 @@ public:
 
   ZS_CK_INLINE uint8_t get_engine_idx() const noexcept { return _engine_idx; }
 
+  /// Returns a new version tag, unique for this engine.
+  /// Used to validate the vm inline caches (see `table_object::get_version()`).
+  ZS_CK_INLINE uint64_t new_version_tag() noexcept { return ++_version_tag; }
+
+  /// Collect all the unreachable reference cycles.
+  /// Returns the number of objects that were freed.
+  size_t collect_garbage();
+
+  /// Runs one step of the incremental collection, which traverses at most
+  /// `get_garbage_collector_step_budget()` objects. A new collection cycle is
+  /// started from the possible cycle roots when none is in progress.
+  /// Returns the number of objects freed when the cycle completed in this step.
+  size_t collect_garbage_step();
+
+  /// Number of possible cycle roots that starts an incremental collection,
+  /// zero disables the automatic steps.
+  ///
+  /// The threshold is checked when a reference counted object is created. Once a
+  /// collection cycle started, a step runs every `constants::k_gc_step_interval`
+  /// created objects until it is done.
+  void set_garbage_collector_threshold(size_t threshold) noexcept;
+  ZS_CHECK size_t get_garbage_collector_threshold() const noexcept;
+
+  /// Maximum number of objects traversed by a collection step.
+  void set_garbage_collector_step_budget(size_t budget) noexcept;
+  ZS_CHECK size_t get_garbage_collector_step_budget() const noexcept;
+
+  /// Start allocating the short lived objects (strings, tables, arrays, ...)
+  /// in a bump pointer arena.
+  ///
+  /// Meant for a vm that runs a single script invocation and throws
+  /// everything away: the objects are still reference counted, but freeing
+  /// them is almost free and all the arena memory is released at once by
+  /// `end_arena()`.
+  ///
+  /// The storage of a container follows the container: a table created in the
+  /// scope grows in the arena, a long lived one (e.g. the global table) keeps
+  /// using the allocator callback (see `get_storage_alloc_info()`).
+  ZS_CHECK zs::error_result begin_arena(size_t chunk_size = constants::k_default_arena_chunk_size);
+
+  /// Stop allocating in the arena and release it.
+  ///
+  /// The vm inline caches and the string template cache are cleared first,
+  /// they could otherwise keep some arena objects alive.
+  ///
+  /// Returns `errc::invalid_operation` if some arena objects escaped the scope
+  /// (e.g. stored in the global table or the registry) and are still alive
+  /// after a garbage collection. The arena memory is then kept until the last
+  /// of them is destroyed, and no new arena can begin until then.
+  ZS_CHECK zs::error_result end_arena();
+
+  /// Returns true between `begin_arena()` and `end_arena()`.
+  ZS_CK_INLINE bool is_arena_open() const noexcept { return _arena and _arena->_is_open; }
+
+  /// Returns true if `ptr` is a block of the arena.
+  ZS_CK_INLINE bool is_arena_allocation(const void* ptr) const noexcept {
+    return _arena and _arena->contains(ptr);
+  }
+
+  /// Returns the `alloc_info_t` of a block owned by the object at `owner`
+  /// (e.g. the storage of a table). The arena is chosen by the scope of the
+  /// owner rather than by the tag: the storage of an object created before
+  /// `begin_arena()` never goes in the arena, even if it grows in the scope.
+  ZS_CK_INLINE alloc_info_t get_storage_alloc_info(const void* owner, memory_tag tag) const noexcept {
+    return is_arena_allocation(owner) ? (alloc_info_t)tag
+                                      : ((alloc_info_t)tag | constants::k_outside_arena_alloc_flag);
+  }
+
+  /// Number of live interned strings (see `string_object::create_interned()`).
+  ZS_CK_INLINE size_t get_interned_string_count() const noexcept { return _interned_strings.size(); }
+
+  /// Position of the script instruction being run by a vm.
+  /// Both pointers refer to the locals of the vm executor.
+  struct script_position {
+    zs::function_prototype_object* const* fct;
+    const zs::instruction_iterator* it;
+  };
+
+  /// Set by the vm while it runs script code, returns the previous position.
+  ZS_INLINE const script_position* set_script_position(const script_position* pos) noexcept {
+    return std::exchange(_script_position, pos);
+  }
+
+  ZS_CK_INLINE const script_position* get_script_position() const noexcept { return _script_position; }
+
+  /// Start counting the live bytes, peak bytes and number of allocations per
+  /// `memory_tag` and per script call site (see `allocation_tracker`).
+  /// The previous counters are cleared.
+  /// Does nothing when `ZS_MEMORY_PROFILER` is disabled.
+  void start_allocation_tracking();
+
+  /// Stop counting, the counters are released.
+  void stop_allocation_tracking() noexcept;
+
+  ZS_CK_INLINE bool is_tracking_allocations() const noexcept { return _alloc_tracker; }
+
+  /// Counters of a `memory_tag`, all zero when the tracking is off.
+  ZS_CHECK allocation_stats get_allocation_stats(memory_tag tag) const noexcept;
+
+  /// Counters of every script call site that allocated, sorted by live bytes.
+  ZS_CHECK zs::vector<allocation_site_stats> get_allocation_site_stats() const;
+
 private:
+  /// Interned strings are hashed and compared by value, a lookup can be done
+  /// directly with a `std::string_view`.
+  struct interned_string_hash {
+    using is_transparent = void;
+    ZS_CHECK size_t operator()(const string_object* sobj) const noexcept;
+    ZS_CHECK size_t operator()(std::string_view s) const noexcept;
+  };
+
+  struct interned_string_equal_to {
+    using is_transparent = void;
+    ZS_CK_INLINE bool operator()(const string_object* lhs, const string_object* rhs) const noexcept {
+      return lhs == rhs;
+    }
+
+    ZS_CHECK bool operator()(const string_object* lhs, std::string_view rhs) const noexcept;
+  };
+
+  using interned_string_set = zs::unordered_set<string_object*, interned_string_hash, interned_string_equal_to>;
+
+  /// Calls the user pointer release hook of the engine when destroyed.
+  /// Declared before the members that allocate, it is destroyed after them.
+  struct user_pointer_releaser {
+    engine* eng;
+    ~user_pointer_releaser();
+  };
+
   allocate_t _allocator;
   raw_pointer_t _user_pointer;
   raw_pointer_release_hook_t _user_pointer_release;
+  user_pointer_releaser _user_pointer_releaser;
   stream_getter_t _stream_getter;
   engine_initializer_t _initializer;
-  std::array<uint8_t, 2 * constants::k_object_size> _objects;
+  std::array<uint8_t, 4 * constants::k_object_size> _objects;
   uint8_t _engine_idx;
+  uint64_t _version_tag = 0;
+  arena_allocator* _arena = nullptr;
+  allocation_tracker* _alloc_tracker = nullptr;
+  const script_position* _script_position = nullptr;
+
+  // Weak references, an interned string removes itself from the set when destroyed.
+  interned_string_set _interned_strings;
 
   friend class engine_rc_proxy;
+  friend class zs::string_object;
   friend class zs::garbage_collector;
+  friend class zs::arena_allocator;
+  friend class zs::allocation_tracker;
   ZS_IF_GARBAGE_COLLECTOR(zs::garbage_collector _gc);
 
   ZS_IF_USE_ENGINE_GLOBAL_REF_COUNT(int_t _global_ref_count = 0);
@@ -96,7 +96,7 @@ struct object_base {
     alignas(uint64_t) char _sbuffer[8];
 
     alignas(uint64_t) union {
-      alignas(uint64_t) zb::aligned_type_storage<zs::object_map::iterator> table_it;
+      alignas(uint64_t) zb::aligned_type_storage<zs::table_value_type*> table_it;
     } _atom;
   };
 
@@ -397,7 +397,7 @@ public:
   // MARK: Table
   //
 
-  ZS_CHECK zs::object_map* get_table_internal_map() const noexcept;
+  ZS_CHECK zs::table_map* get_table_internal_map() const noexcept;
 
   //
   // MARK: Array
@@ -783,6 +783,11 @@ public:
 
   ZS_CHECK static object create_concat_string(zs::engine* eng, std::string_view s1, std::string_view s2);
 
+  /// Same as `object(eng, s)` but long strings of up to `constants::k_max_interned_string_size`
+  /// bytes are interned (see `string_object::create_interned()`).
+  /// Meant for identifiers and compiler constants.
+  ZS_CHECK static object create_interned_string(zs::engine* eng, std::string_view s);
+
   //
   // MARK: Raw pointer.
   //
@@ -1183,6 +1188,7 @@ namespace literals {
 #define ZS_SCRIPT_INCLUDE_OBJECTS 1
 #include <zscript/detail/objects/delegate.h>
 #include <zscript/detail/objects/weak_ref.h>
+#include <zscript/detail/objects/table_map.h>
 #include <zscript/detail/objects/table.h>
 #include <zscript/detail/objects/array.h>
 #include <zscript/detail/objects/struct.h>
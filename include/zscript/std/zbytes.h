@@ -0,0 +1,65 @@
+// MIT License
+//
+// Copyright (c) 2024 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <zscript/zscript.h>
+
+namespace zs {
+
+/// Read only view over a memory mapped file or an owned allocation.
+///
+/// The memory is held by a shared storage object, slices point into the
+/// same storage and are never copied.
+struct bytes {
+  /// `zb::file_view` or `zs::vector<uint8_t>` user data.
+  zs::object storage;
+  const uint8_t* data = nullptr;
+  size_t size = 0;
+
+  ZS_CK_INLINE zb::byte_view view() const noexcept { return zb::byte_view(data, size); }
+
+  static bytes& as_bytes(const object& obj) noexcept;
+};
+
+/// Creates a zero initialized buffer of `size` bytes. Returns null when out of memory.
+object create_bytes(zs::vm_ref vm, size_t size) noexcept;
+
+/// Creates a buffer with a copy of `content`. Returns null when out of memory.
+object create_bytes(zs::vm_ref vm, zb::byte_view content) noexcept;
+
+/// Maps the file at `path`. Returns null if the file can't be mapped or when out of memory.
+object create_mapped_bytes(zs::vm_ref vm, const char* path) noexcept;
+
+/// `bytes(size)`, `bytes(string)` or `bytes([u8, ...])`.
+int_t vm_create_bytes(zs::vm_ref vm);
+
+/// Returns true if 'obj' is a bytes object.
+bool is_bytes(const object& obj) noexcept;
+
+/// Bytes parameter parser.
+struct bytes_parameter {
+  static zs::error_result parse(zs::parameter_stream& s, bool output_error, zs::bytes*& value);
+};
+
+} // namespace zs.
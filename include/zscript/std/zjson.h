@@ -0,0 +1,46 @@
+// MIT License
+//
+// Copyright (c) 2024 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <zscript/zscript.h>
+
+namespace zs {
+
+/// `json_document(content)`, the content is a string or a bytes object.
+///
+/// The content is indexed once, the returned value reads the members on access
+/// and only creates objects for what is read:
+///
+///   var doc = zs.json_document(fs.map_file("data.json"));
+///   var name = doc.items[3].name;
+///
+/// Objects and arrays are returned as json values, scalars as regular objects.
+/// Members named like a method (`get`, `size`, `to_object`) and null values are
+/// read with `get(key)`, which returns none for a missing key.
+int_t vm_create_json_document(zs::vm_ref vm);
+
+/// Returns true if 'obj' is a value of a json document.
+bool is_json_value(const object& obj) noexcept;
+
+} // namespace zs.
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <zscript/zscript.h>
+
+namespace zs {
+
+/// Size class pool allocator.
+///
+/// An alternative to `default_allocate`, the pool is given to the engine as its
+/// user pointer and `pool_allocator::allocate_callback` as its allocate callback.
+///
+/// Allocations up to `k_max_small_size` bytes are rounded up to a multiple of
+/// `k_size_class_step` and served from the free list of their size class.
+/// Each size class carves its blocks out of `k_slab_size` slabs that are aligned
+/// on their size, a block finds its slab (and size class) by masking its address.
+/// Bigger allocations go to `malloc`.
+///
+/// Freed blocks go back to their free list and the slabs are only released
+/// in bulk, when the pool is destroyed.
+///
+/// The pool is not thread safe, it should only be used by a single engine.
+///
+/// @code
+///   // The vm owns the pool, it is deleted after the engine.
+///   zs::vm vm(zs::pool_allocator::create_config());
+///
+///   // Or the pool is owned by the caller and must outlive the engine.
+///   zs::pool_allocator pool;
+///   zs::vm vm(ZS_DEFAULT_STACK_SIZE, zs::pool_allocator::allocate_callback, &pool);
+/// @endcode
+class pool_allocator {
+public:
+  static constexpr size_t k_size_class_step = 16;
+  static constexpr size_t k_max_small_size = 512;
+  static constexpr size_t k_size_class_count = k_max_small_size / k_size_class_step;
+  static constexpr size_t k_slab_size = 64 * 1024;
+  static constexpr size_t k_memory_tag_count = (size_t)memory_tag::nt_allocator + 1;
+
+  /// Statistics of a `memory_tag`.
+  ///
+  /// Allocations are counted with the tag given to `allocate()`, deallocations
+  /// with the one given to `deallocate()` (`nt_unknown` for an untagged `zs_delete`).
+  struct tag_stats {
+    size_t allocations = 0;
+    size_t reallocations = 0;
+    size_t deallocations = 0;
+
+    /// Total number of requested bytes.
+    size_t allocated_bytes = 0;
+  };
+
+  struct stats {
+    std::array<tag_stats, k_memory_tag_count> tags = {};
+
+    /// Bytes currently in use, rounded up to the size classes.
+    size_t live_bytes = 0;
+    size_t peak_live_bytes = 0;
+
+    size_t slab_count = 0;
+    size_t large_allocation_count = 0;
+
+    ZS_CK_INLINE const tag_stats& operator[](memory_tag tag) const noexcept { return tags[(size_t)tag]; }
+  };
+
+  pool_allocator() noexcept = default;
+  pool_allocator(const pool_allocator&) = delete;
+  pool_allocator(pool_allocator&&) = delete;
+
+  /// Releases all the slabs and large allocations at once.
+  ~pool_allocator();
+
+  pool_allocator& operator=(const pool_allocator&) = delete;
+  pool_allocator& operator=(pool_allocator&&) = delete;
+
+  /// The `allocate_t` callback, `user_ptr` must be a `pool_allocator*`.
+  static void* allocate_callback(zs::engine* eng, raw_pointer_t user_ptr, void* ptr, size_t size,
+      size_t old_size, alloc_info_t info);
+
+  /// The `raw_pointer_release_hook_t` of a pool created by `create_config()`.
+  static void release(allocate_t alloc_cb, raw_pointer_t user_ptr);
+
+  /// Returns a config with a new heap allocated pool that gets deleted with its engine.
+  ZS_CHECK static config_t create_config(size_t stack_size = ZS_DEFAULT_STACK_SIZE);
+
+  /// Returns the pool of an engine, or nullptr if the engine doesn't use a pool_allocator.
+  ZS_CHECK static pool_allocator* get(zs::engine* eng) noexcept;
+
+  ZS_CHECK void* allocate(size_t size, alloc_info_t info);
+  ZS_CHECK void* reallocate(void* ptr, size_t size, alloc_info_t info);
+  void deallocate(void* ptr, alloc_info_t info);
+
+  ZS_CK_INLINE const stats& get_stats() const noexcept { return _stats; }
+
+private:
+  struct free_block {
+    free_block* next;
+  };
+
+  struct slab_header;
+  struct large_header;
+
+  ZS_CK_INLINE static size_t get_size_class(size_t size) noexcept {
+    return (size - 1) / k_size_class_step;
+  }
+
+  ZS_CK_INLINE static size_t get_class_size(size_t size_class) noexcept {
+    return (size_class + 1) * k_size_class_step;
+  }
+
+  void* allocate_small(size_t size_class);
+  void* allocate_large(size_t size);
+
+  /// Returns the slab containing `ptr`, or nullptr if `ptr` is a large allocation.
+  ZS_CHECK slab_header* find_slab(void* ptr) const noexcept;
+
+  ZS_CHECK size_t get_block_size(void* ptr) const noexcept;
+
+  void add_live_bytes(size_t size) noexcept;
+
+  ZS_CHECK tag_stats& get_tag_stats(alloc_info_t info) noexcept;
+
+  /// Unused part of the last slab of a size class.
+  struct slab_range {
+    uint8_t* begin = nullptr;
+    uint8_t* end = nullptr;
+  };
+
+  std::array<free_block*, k_size_class_count> _free_lists = {};
+  std::array<slab_range, k_size_class_count> _slab_ranges = {};
+  zb::flat_hash_set<uintptr_t> _slabs;
+  large_header* _large_allocations = nullptr;
+  stats _stats;
+};
+
+} // namespace zs.
@@ -3,6 +3,58 @@
 #include <zscript/zscript.h>
 
 namespace zs {
-zs::string render_template_string(zs::vm_ref vm, const zs::object& tbl, std::string_view content,
-    std::string_view l_quote = "≤≤", std::string_view r_quote = "≥≥");
+
+/// Template parsed once into its literal chunks and compiled expressions.
+///
+/// Each `l_quote expression r_quote` fragment is compiled as `return expression;`
+/// and called with the render table as `this`.
+class string_template : public engine_holder {
+public:
+  string_template(zs::engine* eng);
+
+  /// Parses and compiles `content`, the first compile error is returned.
+  ZS_CHECK zs::error_result compile(zs::vm_ref vm, std::string_view content,
+      std::string_view l_quote = "≤≤", std::string_view r_quote = "≥≥");
+
+  /// Fails on a fragment that didn't compile or when a fragment call fails.
+  /// A null fragment value renders as nothing.
+  ZS_CHECK zs::error_result render(zs::vm_ref vm, const zs::object& tbl, zs::string& output) const;
+
+private:
+  /// Either a string or the function prototype of a fragment (null when it didn't compile).
+  zs::vector<zs::object> _chunks;
+
+  /// The closures of the fragments for `_closures_root`, created again when
+  /// rendering with a vm that has another root table.
+  mutable zs::vector<zs::object> _closures;
+  mutable zs::object _closures_root;
+};
+
+/// Creates a string template object, it has a `render(tbl)` method in scripts.
+ZS_CHECK zs::error_result create_string_template(zs::vm_ref vm, std::string_view content,
+    std::string_view l_quote, std::string_view r_quote, zs::object& output);
+
+/// Returns true if 'obj' is a string template object.
+bool is_string_template(const object& obj) noexcept;
+
+string_template& as_string_template(const object& obj) noexcept;
+
+/// `zs.template(content, l_quote = "≤≤", r_quote = "≥≥")`.
+int_t vm_create_string_template(zs::vm_ref vm);
+
+/// Renders `content` with a template from the engine cache, it is only
+/// compiled the first time (see `set_string_template_cache_size()`).
+/// A template that doesn't compile isn't cached.
+ZS_CHECK zs::error_result render_template_string(zs::vm_ref vm, const zs::object& tbl,
+    std::string_view content, zs::string& output, std::string_view l_quote = "≤≤",
+    std::string_view r_quote = "≥≥");
+
+/// Number of templates kept compiled by `render_template_string()`, the least
+/// recently used one is dropped first. Zero disables the cache (default is 256).
+void set_string_template_cache_size(zs::engine* eng, size_t size);
+
+/// Drops all the templates kept by `render_template_string()`.
+/// Called by `engine::end_arena()`, they could be arena objects.
+void clear_string_template_cache(zs::engine* eng);
+
 } // namespace zs.
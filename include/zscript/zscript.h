@@ -191,6 +191,9 @@ ZS_CK_INLINE zs::object get_meta_method_name_object(meta_method mm) noexcept {
 
     ZS_META_METHOD_ENUM(_X)
 #undef _X
+
+  case meta_method::count:
+    break;
   }
 
   ZS_ERROR("invalid meta method");
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <zscript/zscript.h>
+
+namespace zs {
+
+/// Invalid `cache_idx` value for `op_get` and `op_set`, the instruction is not cached.
+inline constexpr const uint16_t k_invalid_inline_cache = (uint16_t)-1;
+
+/// Per-instruction cache for `op_get` and `op_set`.
+///
+/// Each entry remembers where a key was found in a given table or struct instance:
+/// - table: the address of the value inside the table map.
+/// - struct instance: the member slot index in the struct definition.
+///
+/// Entries are keyed by the object version tag (see `engine::new_version_tag()`),
+/// which is unique per engine and renewed on any structural change of a table.
+/// The cache holds up to `k_size` entries (polymorphic), replaced in round robin.
+class inline_cache {
+public:
+  static constexpr size_t k_size = 4;
+
+  struct entry {
+    zs::object key;
+    uint64_t version = 0;
+
+    union {
+      zs::object* value = nullptr;
+      int_t slot;
+    };
+  };
+
+  ZS_CK_INLINE const entry* find(uint64_t version, const object& key) const noexcept {
+    for (const entry& e : _entries) {
+      if (e.version == version and e.key._lvalue == key._lvalue and e.key._rvalue == key._rvalue) {
+        return &e;
+      }
+    }
+
+    return nullptr;
+  }
+
+  ZS_INLINE void add_value(uint64_t version, const object& key, zs::object* value) noexcept {
+    entry& e = next_entry(version, key);
+    e.value = value;
+  }
+
+  ZS_INLINE void add_slot(uint64_t version, const object& key, int_t slot) noexcept {
+    entry& e = next_entry(version, key);
+    e.slot = slot;
+  }
+
+  /// Drops all the entries and their keys.
+  ZS_INLINE void clear() noexcept {
+    _entries = {};
+    _next = 0;
+  }
+
+private:
+  std::array<entry, k_size> _entries = {};
+  uint8_t _next = 0;
+
+  ZS_CK_INLINE entry& next_entry(uint64_t version, const object& key) noexcept {
+    entry& e = _entries[_next];
+    _next = (_next + 1) % k_size;
+    e.key = key;
+    e.version = version;
+    return e;
+  }
+};
+} // namespace zs.
@@ -104,15 +104,32 @@ public:
     _data.insert(_data.end(), (const uint8_t*)&inst, ((const uint8_t*)&inst) + get_instruction_size<Op>());
   }
 
-  [[nodiscard]] inline iterator begin() const noexcept { return iterator(_data.data()); }
+  /// Uses `size` bytes of instructions owned by someone else instead of `_data`
+  /// (e.g. the instructions of a mapped module, see `mapped_module_header`).
+  /// The memory must stay valid and writable while in use, the vm quickens
+  /// some instructions in place.
+  inline void set_external_data(uint8_t* data, size_t size) noexcept {
+    _external_data = data;
+    _external_size = size;
+  }
 
-  [[nodiscard]] inline iterator end() const noexcept { return iterator(_data.data() + _data.size()); }
+  [[nodiscard]] inline bool has_external_data() const noexcept { return _external_data; }
+
+  [[nodiscard]] inline iterator begin() const noexcept { return iterator(data()); }
+
+  [[nodiscard]] inline iterator end() const noexcept { return iterator(data() + size()); }
+
+  [[nodiscard]] inline uint8_t* data() noexcept { return _external_data ? _external_data : _data.data(); }
+
+  [[nodiscard]] inline const uint8_t* data() const noexcept {
+    return _external_data ? _external_data : _data.data();
+  }
 
-  [[nodiscard]] inline uint8_t* data() noexcept { return _data.data(); }
-  [[nodiscard]] inline const uint8_t* data() const noexcept { return _data.data(); }
+  [[nodiscard]] inline uint8_t* data(size_t index) noexcept { return data() + index; }
+  [[nodiscard]] inline const uint8_t* data(size_t index) const noexcept { return data() + index; }
 
-  [[nodiscard]] inline uint8_t* data(size_t index) noexcept { return _data.data() + index; }
-  [[nodiscard]] inline const uint8_t* data(size_t index) const noexcept { return _data.data() + index; }
+  /// Size in bytes.
+  [[nodiscard]] inline size_t size() const noexcept { return _external_data ? _external_size : _data.size(); }
 
   //  ZB_CHECK ZB_INLINE pointer data(size_type index) noexcept { return data() + index; }
   //  ZB_CHECK ZB_INLINE const_pointer data(size_type index) const noexcept { return data() + index; }
@@ -121,11 +138,11 @@ public:
   //  }
 
   /// Byte offset.
-  inline iterator operator[](size_t n) const noexcept { return iterator(_data.data() + n); }
+  inline iterator operator[](size_t n) const noexcept { return iterator(data() + n); }
 
   template <opcode Op>
   [[nodiscard]] inline instruction_t<Op>* get(size_t index) noexcept {
-    instruction_t<Op>* inst = (instruction_t<Op>*)(_data.data() + index);
+    instruction_t<Op>* inst = (instruction_t<Op>*)(data() + index);
     zbase_assert(inst->op == Op, "zs::instruction_vector::get - invalid opcode '", opcode_to_string(Op),
         "' expected '", opcode_to_string(inst->op), "'");
     return inst;
@@ -133,21 +150,21 @@ public:
 
   template <opcode Op>
   [[nodiscard]] inline instruction_t<Op>& get_ref(size_t index) noexcept {
-    instruction_t<Op>* inst = (instruction_t<Op>*)(_data.data() + index);
+    instruction_t<Op>* inst = (instruction_t<Op>*)(data() + index);
     zbase_assert(inst->op == Op, "zs::instruction_vector::get_ref - invalid opcode '", opcode_to_string(Op),
         "' expected '", opcode_to_string(inst->op), "'");
     return *inst;
   }
 
   [[nodiscard]] inline zs::opcode get_opcode(size_t index) const noexcept {
-    return (zs::opcode) * (_data.data() + index);
+    return (zs::opcode) * (data() + index);
   }
 
   //  inline iterator at_index(size_t n) const noexcept { return
   //  iterator(_data.data() + n); }
 
   inline size_t get_iterator_index(const iterator& it) const noexcept {
-    return std::distance((const uint8_t*)_data.data(), (const uint8_t*)it.data());
+    return std::distance(data(), it.data());
   }
 
   inline size_t get_iterator_instruction_index(const iterator& it) const noexcept {
@@ -170,8 +187,51 @@ public:
   void debug_print(std::ostream& stream = std::cout) const;
 
   zs::vector<uint8_t> _data;
+
+private:
+  uint8_t* _external_data = nullptr;
+  size_t _external_size = 0;
 };
 
+/// Calls `fct(index, offset)` for every jump instruction of `insts` and replaces
+/// its offset by the returned one. `index` is the byte offset of the instruction,
+/// the jump offsets are relative to it.
+template <class Fct>
+inline void update_jump_offsets(instruction_vector& insts, Fct&& fct) {
+  const size_t size = insts.size();
+
+  for (size_t index = 0; index < size; index += get_instruction_size(insts.get_opcode(index))) {
+    switch (insts.get_opcode(index)) {
+#define ZS_UPDATE_JUMP_OFFSET(op)                                       \
+  case opcode::op: {                                                    \
+    instruction_t<opcode::op>& inst = insts.get_ref<opcode::op>(index); \
+    inst.offset = (int32_t)fct(index, (int32_t)inst.offset);            \
+    break;                                                              \
+  }
+
+      ZS_UPDATE_JUMP_OFFSET(op_jmp)
+      ZS_UPDATE_JUMP_OFFSET(op_jz)
+      ZS_UPDATE_JUMP_OFFSET(op_if_not)
+      ZS_UPDATE_JUMP_OFFSET(op_and)
+      ZS_UPDATE_JUMP_OFFSET(op_or)
+      ZS_UPDATE_JUMP_OFFSET(op_triple_or)
+      ZS_UPDATE_JUMP_OFFSET(op_foreach_next)
+      ZS_UPDATE_JUMP_OFFSET(op_cmp_jz)
+      ZS_UPDATE_JUMP_OFFSET(op_cmp_int_jz)
+      ZS_UPDATE_JUMP_OFFSET(op_eq_int_jz_ii)
+      ZS_UPDATE_JUMP_OFFSET(op_ne_int_jz_ii)
+      ZS_UPDATE_JUMP_OFFSET(op_lt_int_jz_ii)
+      ZS_UPDATE_JUMP_OFFSET(op_le_int_jz_ii)
+      ZS_UPDATE_JUMP_OFFSET(op_gt_int_jz_ii)
+      ZS_UPDATE_JUMP_OFFSET(op_ge_int_jz_ii)
+#undef ZS_UPDATE_JUMP_OFFSET
+
+    default:
+      break;
+    }
+  }
+}
+
 class instruction_stream {
 public:
   using value_type = uint8_t;
@@ -186,7 +246,7 @@ public:
       , _it(s.begin()) {}
 
   inline instruction_stream(const instruction_vector& s) noexcept
-      : instruction_stream(s._data) {}
+      : instruction_stream(span_type(s.data(), s.size())) {}
 
   [[nodiscard]] inline iterator begin() const noexcept { return iterator(&(*_it)); }
 
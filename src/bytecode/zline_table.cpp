@@ -0,0 +1,42 @@
+#include "zline_table.h"
+
+namespace zs {
+
+void line_table::add(size_t op_index, const zs::line_info& linfo) {
+  const entry e = { (uint32_t)op_index, (uint32_t)linfo.line, (uint32_t)linfo.column };
+
+  // The entries are kept sorted, a run can only be added before the last
+  // one when the compiler moves instructions around (e.g. the increment
+  // expression of a for loop).
+  auto it = std::upper_bound(_entries.begin(), _entries.end(), e.op_index,
+      [](uint32_t index, const entry& rhs) { return index < rhs.op_index; });
+
+  if (it != _entries.begin()) {
+    entry& prev = *(it - 1);
+
+    // Nothing was emitted since the previous run started.
+    if (prev.op_index == e.op_index) {
+      if (it - 1 != _entries.begin() and (it - 2)->line == e.line) {
+        _entries.erase(it - 1);
+      }
+      else {
+        prev = e;
+      }
+      return;
+    }
+
+    if (prev.line == e.line) {
+      return;
+    }
+  }
+
+  _entries.insert(it, e);
+}
+
+const line_table::entry* line_table::find(size_t op_index) const noexcept {
+  auto it = std::upper_bound(_entries.begin(), _entries.end(), (uint32_t)op_index,
+      [](uint32_t index, const entry& rhs) { return index < rhs.op_index; });
+
+  return it == _entries.begin() ? nullptr : &*(it - 1);
+}
+} // namespace zs.
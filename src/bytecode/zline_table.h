@@ -0,0 +1,36 @@
+#pragma once
+
+#include <zscript/zscript.h>
+
+namespace zs {
+
+/// Instruction byte offset to source line table of a function.
+///
+/// Run length encoded: an entry is only added when the line changes and
+/// covers all the instructions up to the next entry. It is only looked up
+/// when an error occurs, running the instructions doesn't touch it.
+class line_table {
+public:
+  struct entry {
+    /// Byte offset of the first instruction of the run.
+    uint32_t op_index;
+    uint32_t line;
+    uint32_t column;
+  };
+
+  inline line_table(zs::engine* eng)
+      : _entries(zs::allocator<entry>(eng)) {}
+
+  /// Starts a new run at `op_index`, unless the line didn't change.
+  void add(size_t op_index, const zs::line_info& linfo);
+
+  /// Returns the run containing the instruction at `op_index`, or nullptr.
+  ZS_CHECK const entry* find(size_t op_index) const noexcept;
+
+  ZS_CK_INLINE bool empty() const noexcept { return _entries.empty(); }
+  ZS_CK_INLINE size_t size() const noexcept { return _entries.size(); }
+
+  zs::vector<entry> _entries;
+};
+
+} // namespace zs.
@@ -0,0 +1,422 @@
+#include "bytecode/zmapped_module.h"
+#include "object/zfunction_prototype.h"
+#include "utility/json/zjson_parser.h"
+#include <zscript/base/sys/file_view.h>
+
+namespace zs {
+
+namespace {
+  inline constexpr size_t k_alignment = mapped_module_header::k_alignment;
+
+  ZS_CK_INLINE std::string_view to_string_view(const object& obj) noexcept {
+    return obj.is_string() ? std::string_view(obj.get_string_unchecked()) : std::string_view();
+  }
+
+  class mapped_module_writer {
+  public:
+    inline mapped_module_writer(zs::engine* eng, zb::byte_vector& buffer)
+        : _engine(eng)
+        , _buffer(buffer)
+        , _pool(zs::string_allocator(eng))
+        , _string_map(zs::unordered_map_allocator<zs::string, mapped_string>(eng)) {}
+
+    /// Appends `count` values at the next aligned offset.
+    template <class T>
+    mapped_section write(const T* data, size_t count) {
+      if (!count) {
+        return { 0, 0 };
+      }
+
+      const size_t offset = zb::align((uintptr_t)_buffer.size(), k_alignment);
+      _buffer.resize(offset + count * sizeof(T));
+      ::memcpy(_buffer.data() + offset, data, count * sizeof(T));
+      return { offset, count };
+    }
+
+    template <class Container>
+    inline mapped_section write(const Container& values) {
+      return write(values.data(), values.size());
+    }
+
+    /// Identical strings are only stored once in the pool.
+    mapped_string add_string(std::string_view str) {
+      if (auto it = _string_map.find(str); it != _string_map.end()) {
+        return it->second;
+      }
+
+      const mapped_string mstr = { (uint32_t)_pool.size(), (uint32_t)str.size() };
+
+      if (_pool.size() + str.size() > UINT32_MAX) {
+        _is_pool_full = true;
+        return { 0, 0 };
+      }
+
+      _pool.append(str);
+      _string_map.emplace(zs::string(str, zs::string_allocator(_engine)), mstr);
+      return mstr;
+    }
+
+    template <class Container>
+    inline zs::vector<mapped_string> add_strings(const Container& objs) {
+      zs::vector<mapped_string> strs((zs::allocator<mapped_string>(_engine)));
+      strs.reserve(objs.size());
+
+      for (const object& obj : objs) {
+        strs.push_back(add_string(to_string_view(obj)));
+      }
+
+      return strs;
+    }
+
+    ZS_CK_INLINE bool is_pool_full() const noexcept { return _is_pool_full; }
+    ZS_CK_INLINE std::string_view pool() const noexcept { return _pool; }
+
+  private:
+    zs::engine* _engine;
+    zb::byte_vector& _buffer;
+    zs::string _pool;
+
+    /// Looked up by `std::string_view`, only the inserted strings are copied.
+    zs::unordered_map<zs::string, mapped_string, zb::rapid_hasher<std::string_view>, std::equal_to<>>
+        _string_map;
+    bool _is_pool_full = false;
+  };
+
+  class mapped_module_reader {
+  public:
+    inline mapped_module_reader(zb::byte_view content, std::string_view pool)
+        : _content(content)
+        , _pool(pool) {}
+
+    /// Returns nullptr if the section is out of bounds or misaligned.
+    template <class T>
+    const T* get(const mapped_section& section) const noexcept {
+      if (!section.count) {
+        return nullptr;
+      }
+
+      if (section.offset % alignof(T) or section.offset > _content.size()
+          or section.count > (_content.size() - section.offset) / sizeof(T)) {
+        return nullptr;
+      }
+
+      return (const T*)(_content.data() + section.offset);
+    }
+
+    template <class T>
+    ZS_CK_INLINE bool is_valid(const mapped_section& section) const noexcept {
+      return !section.count or get<T>(section);
+    }
+
+    ZS_CK_INLINE bool is_valid(const mapped_string& str) const noexcept {
+      return str.offset <= _pool.size() and str.size <= _pool.size() - str.offset;
+    }
+
+    template <class Container>
+    bool read_strings(zs::engine* eng, const mapped_section& section, Container& output) const {
+      const mapped_string* strs = get<mapped_string>(section);
+
+      for (size_t i = 0; i < section.count; i++) {
+        if (!is_valid(strs[i])) {
+          return false;
+        }
+
+        output.push_back(string(eng, strs[i]));
+      }
+
+      return true;
+    }
+
+    ZS_CK_INLINE std::string_view view(const mapped_string& str) const noexcept {
+      return _pool.substr(str.offset, str.size);
+    }
+
+    ZS_CK_INLINE object string(zs::engine* eng, const mapped_string& str) const {
+      return zs::_s(eng, view(str));
+    }
+
+  private:
+    zb::byte_view _content;
+    std::string_view _pool;
+  };
+
+  zs::error_result write_function(mapped_module_writer& writer, function_prototype_object& fpo,
+      const zs::vector<uint32_t>& children, mapped_function& output) {
+    zs::engine* eng = fpo.get_engine();
+
+    // Same as `function_prototype_object::save()`.
+    zs::string module_info("{}", eng);
+    if (fpo._module_info.is_table()) {
+      if (auto err = fpo._module_info.to_json(module_info)) {
+        return err;
+      }
+    }
+
+    fpo.load_mapped_literals();
+
+    for (const object& lit : fpo._literals) {
+      if (!lit.is_string()) {
+        return zs::errc::invalid_type;
+      }
+    }
+
+    zs::vector<mapped_local> locals((zs::allocator<mapped_local>(eng)));
+    locals.reserve(fpo._vlocals.size());
+
+    for (const local_var_info_t& vinfo : fpo._vlocals) {
+      locals.push_back({ writer.add_string(to_string_view(vinfo.name)), vinfo.mask, (uint32_t)vinfo.flags,
+          vinfo.custom_mask, vinfo.start_op, vinfo.end_op, vinfo.pos });
+    }
+
+    zs::vector<mapped_capture> captures((zs::allocator<mapped_capture>(eng)));
+    captures.reserve(fpo._captures.size());
+
+    for (const captured_variable& cap : fpo._captures) {
+      captures.push_back(
+          { writer.add_string(to_string_view(cap.name)), cap.src, (uint32_t)cap.type, cap.is_weak });
+    }
+
+    output = {};
+    output.source_name = writer.add_string(to_string_view(fpo._source_name));
+    output.name = writer.add_string(to_string_view(fpo._name));
+    output.module_info = writer.add_string(module_info);
+    output.has_vargs_params = fpo._has_vargs_params;
+    output.stack_size = fpo._stack_size;
+    output.n_capture = fpo._n_capture;
+    output.instructions = writer.write(fpo._instructions.data(), fpo._instructions.size());
+    output.literals = writer.write(writer.add_strings(fpo._literals));
+    output.locals = writer.write(locals);
+    output.default_params = writer.write(fpo._default_params.data(), fpo._default_params.size());
+    output.parameter_names = writer.write(writer.add_strings(fpo._parameter_names));
+    output.restricted_types = writer.write(writer.add_strings(fpo._restricted_types));
+    output.captures = writer.write(captures);
+    output.line_info = writer.write(fpo._line_info._entries);
+    output.functions = writer.write(children);
+    return {};
+  }
+
+  zs::error_result read_function(zs::engine* eng, const mapped_module_reader& reader,
+      const mapped_function& mfct, uint8_t* base, function_prototype_object& fpo) {
+
+    if (!reader.is_valid(mfct.source_name) or !reader.is_valid(mfct.name)
+        or !reader.is_valid(mfct.module_info) or !reader.is_valid<uint8_t>(mfct.instructions)
+        or !reader.is_valid<mapped_string>(mfct.literals) or !reader.is_valid<mapped_local>(mfct.locals)
+        or !reader.is_valid<int64_t>(mfct.default_params)
+        or !reader.is_valid<mapped_string>(mfct.parameter_names)
+        or !reader.is_valid<mapped_string>(mfct.restricted_types)
+        or !reader.is_valid<mapped_capture>(mfct.captures)
+        or !reader.is_valid<line_table::entry>(mfct.line_info)) {
+      return zs::errc::out_of_bounds;
+    }
+
+    fpo._source_name = reader.string(eng, mfct.source_name);
+    fpo._name = reader.string(eng, mfct.name);
+
+    zs::json_parser jparser(eng);
+    if (auto err = jparser.parse(nullptr, reader.view(mfct.module_info), nullptr, fpo._module_info)) {
+      return err;
+    }
+
+    fpo._has_vargs_params = mfct.has_vargs_params;
+    fpo._stack_size = mfct.stack_size;
+    fpo._n_capture = mfct.n_capture;
+
+    // Used in place.
+    fpo._instructions.set_external_data(base + mfct.instructions.offset, mfct.instructions.count);
+
+    if (const mapped_string* lits = reader.get<mapped_string>(mfct.literals)) {
+      for (size_t i = 0; i < mfct.literals.count; i++) {
+        if (!reader.is_valid(lits[i])) {
+          return zs::errc::out_of_bounds;
+        }
+      }
+
+      fpo._literals.resize(mfct.literals.count);
+      fpo._mapped_literals = lits;
+    }
+
+    // The small tables are copied.
+    const mapped_local* locals = reader.get<mapped_local>(mfct.locals);
+    fpo._vlocals.reserve(mfct.locals.count);
+
+    for (size_t i = 0; i < mfct.locals.count; i++) {
+      const mapped_local& loc = locals[i];
+      if (!reader.is_valid(loc.name)) {
+        return zs::errc::out_of_bounds;
+      }
+
+      local_var_info_t& vinfo = fpo._vlocals.emplace_back(
+          reader.string(eng, loc.name), loc.start_op, loc.end_op, loc.pos, loc.mask, loc.custom_mask, false);
+      vinfo.flags = (variable_attribute_t)loc.flags;
+    }
+
+    if (const int64_t* params = reader.get<int64_t>(mfct.default_params)) {
+      fpo._default_params.assign(params, params + mfct.default_params.count);
+    }
+
+    if (!reader.read_strings(eng, mfct.parameter_names, fpo._parameter_names)
+        or !reader.read_strings(eng, mfct.restricted_types, fpo._restricted_types)) {
+      return zs::errc::out_of_bounds;
+    }
+
+    const mapped_capture* captures = reader.get<mapped_capture>(mfct.captures);
+    fpo._captures.reserve(mfct.captures.count);
+
+    for (size_t i = 0; i < mfct.captures.count; i++) {
+      const mapped_capture& cap = captures[i];
+      if (!reader.is_valid(cap.name)) {
+        return zs::errc::out_of_bounds;
+      }
+
+      fpo._captures.emplace_back(reader.string(eng, cap.name), cap.src,
+          (captured_variable::type_t)cap.type, (bool)cap.is_weak);
+    }
+
+    if (const line_table::entry* entries = reader.get<line_table::entry>(mfct.line_info)) {
+      fpo._line_info._entries.assign(entries, entries + mfct.line_info.count);
+    }
+
+    fpo.reset_inline_caches();
+    return {};
+  }
+} // namespace.
+
+zs::error_result save_mapped_module(const object& fpo, zb::byte_vector& buffer) {
+  if (!function_prototype_object::is_proto(fpo)) {
+    return zs::errc::invalid_argument;
+  }
+
+  zs::engine* eng = function_prototype_object::as_proto(fpo).get_engine();
+
+  // Flattened, a function always comes before its children.
+  zs::vector<function_prototype_object*> protos(
+      { &function_prototype_object::as_proto(fpo) }, zs::allocator<function_prototype_object*>(eng));
+  zs::vector<zs::vector<uint32_t>> children((zs::allocator<zs::vector<uint32_t>>(eng)));
+
+  for (size_t i = 0; i < protos.size(); i++) {
+    zs::vector<uint32_t>& indices = children.emplace_back(zs::allocator<uint32_t>(eng));
+
+    for (const object& child : protos[i]->_functions) {
+      indices.push_back((uint32_t)protos.size());
+      protos.push_back(&function_prototype_object::as_proto(child));
+    }
+  }
+
+  const size_t functions_offset = sizeof(mapped_module_header);
+
+  buffer.clear();
+  buffer.resize(functions_offset + protos.size() * sizeof(mapped_function));
+
+  mapped_module_writer writer(eng, buffer);
+  zs::vector<mapped_function> functions(protos.size(), zs::allocator<mapped_function>(eng));
+
+  for (size_t i = 0; i < protos.size(); i++) {
+    if (auto err = write_function(writer, *protos[i], children[i], functions[i])) {
+      return err;
+    }
+  }
+
+  if (writer.is_pool_full()) {
+    return zs::errc::out_of_bounds;
+  }
+
+  ::memcpy(buffer.data() + functions_offset, functions.data(), functions.size() * sizeof(mapped_function));
+
+  const std::string_view pool = writer.pool();
+  const mapped_section strings = writer.write(pool.data(), pool.size());
+
+  const mapped_module_header header = { mapped_module_header::k_magic, mapped_module_header::k_format_version,
+    zs::k_version, (uint32_t)opcode::count, mapped_module_header::k_byte_order, (uint32_t)protos.size(),
+    buffer.size(), functions_offset, strings.offset, strings.count, 0 };
+
+  ::memcpy(buffer.data(), &header, sizeof(header));
+  return {};
+}
+
+zs::error_result load_mapped_module(zs::engine* eng, const char* filename, object& output_fpo) {
+  zb::file_view file;
+  if (auto err = file.open(filename, zb::file_view::open_mode::copy_on_write)) {
+    return zs::errc::open_file_error;
+  }
+
+  const zb::byte_view content(file.data(), file.size());
+  if (content.size() < sizeof(mapped_module_header) or !is_mapped_module_data(content)) {
+    return zs::errc::invalid_type;
+  }
+
+  mapped_module_header header;
+  ::memcpy(&header, content.data(), sizeof(header));
+
+  if (header.format_version != mapped_module_header::k_format_version
+      or header.byte_order != mapped_module_header::k_byte_order
+      or header.opcode_count != (uint32_t)opcode::count or header.version.major != zs::k_version.major
+      or header.version.minor != zs::k_version.minor or header.version.patch != zs::k_version.patch
+      or header.version.build != zs::k_version.build) {
+    return zs::errc::invalid_type;
+  }
+
+  if (header.file_size != content.size() or header.strings_offset > content.size()
+      or header.strings_size > content.size() - header.strings_offset) {
+    return zs::errc::out_of_bounds;
+  }
+
+  const mapped_module_reader reader(content,
+      std::string_view((const char*)content.data() + header.strings_offset, header.strings_size));
+
+  const mapped_function* functions
+      = reader.get<mapped_function>({ header.functions_offset, header.function_count });
+
+  if (!functions) {
+    return zs::errc::out_of_bounds;
+  }
+
+  uint8_t* base = file.mutable_data();
+
+  // The prototypes keep the mapping alive.
+  user_data_object* uobj = user_data_object::create<zb::file_view>(eng, std::move(file));
+  if (!uobj) {
+    return zs::errc::out_of_memory;
+  }
+
+  const object module(uobj, false);
+
+  zs::vector<object> protos((zs::allocator<object>(eng)));
+  protos.reserve(header.function_count);
+
+  for (uint32_t i = 0; i < header.function_count; i++) {
+    object fpo = function_prototype_object::create(eng);
+    function_prototype_object& proto = function_prototype_object::as_proto(fpo);
+    proto._mapped_module = module;
+    proto._mapped_strings = (const char*)content.data() + header.strings_offset;
+
+    if (auto err = read_function(eng, reader, functions[i], base, proto)) {
+      return err;
+    }
+
+    protos.push_back(std::move(fpo));
+  }
+
+  for (uint32_t i = 0; i < header.function_count; i++) {
+    const mapped_section& section = functions[i].functions;
+    const uint32_t* indices = reader.get<uint32_t>(section);
+
+    if (section.count and !indices) {
+      return zs::errc::out_of_bounds;
+    }
+
+    function_prototype_object& proto = function_prototype_object::as_proto(protos[i]);
+
+    for (size_t k = 0; k < section.count; k++) {
+      // Children always come after their parent, there can't be any cycle.
+      if (indices[k] <= i or indices[k] >= header.function_count) {
+        return zs::errc::out_of_bounds;
+      }
+
+      proto._functions.push_back(protos[indices[k]]);
+    }
+  }
+
+  output_fpo = std::move(protos[0]);
+  return {};
+}
+} // namespace zs.
@@ -0,0 +1,155 @@
+// MIT License
+//
+// Copyright (c) 2024 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <zscript/zscript.h>
+#include <zscript/base/container/byte.h>
+
+namespace zs {
+
+class function_prototype_object;
+
+/// Compiled module meant to be used in place from a memory mapped file.
+///
+/// Unlike `function_prototype_object::save()`, nothing needs to be
+/// deserialized: the instructions run straight from the mapped pages and the
+/// literals are only turned into objects on first use. Pages are mapped copy on
+/// write since the vm quickens some instructions in place, they stay shared
+/// between the processes loading the same module until then.
+///
+/// Layout, all sections are aligned on `k_alignment`:
+///   - `mapped_module_header`
+///   - one `mapped_function` per prototype, the root one first.
+///   - the tables of each function (instructions, literals, locals, ...).
+///   - the string pool, referenced with `mapped_string`.
+///
+/// All values are stored in the native byte order, a module can only be loaded
+/// by a build with the same zscript version, byte order and opcode count.
+struct mapped_module_header {
+  static constexpr std::array<uint8_t, 4> k_magic = { 'Z', 'S', 'M', 'M' };
+
+  /// Bumped when the layout changes.
+  static constexpr uint32_t k_format_version = 1;
+
+  static constexpr uint32_t k_byte_order = 0x01020304;
+  static constexpr size_t k_alignment = 16;
+
+  std::array<uint8_t, 4> magic;
+  uint32_t format_version;
+  zs::version_t version;
+  uint32_t opcode_count;
+  uint32_t byte_order;
+  uint32_t function_count;
+  uint64_t file_size;
+  uint64_t functions_offset;
+  uint64_t strings_offset;
+  uint64_t strings_size;
+  uint64_t reserved;
+};
+
+/// Offset and count of a table.
+struct mapped_section {
+  uint64_t offset;
+  uint64_t count;
+};
+
+/// Offset in the string pool and size.
+struct mapped_string {
+  uint32_t offset;
+  uint32_t size;
+};
+
+struct mapped_local {
+  mapped_string name;
+  uint32_t mask;
+  uint32_t flags;
+  uint64_t custom_mask;
+  uint64_t start_op;
+  uint64_t end_op;
+  uint64_t pos;
+};
+
+struct mapped_capture {
+  mapped_string name;
+  int64_t src;
+  uint32_t type;
+  uint32_t is_weak;
+};
+
+struct mapped_function {
+  mapped_string source_name;
+  mapped_string name;
+
+  /// Json.
+  mapped_string module_info;
+  uint32_t has_vargs_params;
+  uint32_t reserved;
+
+  int64_t stack_size;
+  uint64_t n_capture;
+
+  /// Bytes.
+  mapped_section instructions;
+
+  /// `mapped_string`.
+  mapped_section literals;
+
+  /// `mapped_local`.
+  mapped_section locals;
+
+  /// `int64_t`.
+  mapped_section default_params;
+
+  /// `mapped_string`.
+  mapped_section parameter_names;
+
+  /// `mapped_string`.
+  mapped_section restricted_types;
+
+  /// `mapped_capture`.
+  mapped_section captures;
+
+  /// `line_table::entry`.
+  mapped_section line_info;
+
+  /// `uint32_t` index of the child functions, always greater than the index of this one.
+  mapped_section functions;
+};
+
+static_assert(sizeof(mapped_module_header) == 64);
+static_assert(sizeof(mapped_function) == 192);
+
+ZS_CHECK inline bool is_mapped_module_data(zb::byte_view content) noexcept {
+  return content.subspan(0, 4) == mapped_module_header::k_magic;
+}
+
+/// Writes the function prototype `fpo` and all its nested functions as a mapped module.
+ZS_CHECK zs::error_result save_mapped_module(const object& fpo, zb::byte_vector& buffer);
+
+/// Maps the module at `filename` and creates its root function prototype.
+/// Meant for a file already known to be a mapped module (see `is_mapped_module_data()`),
+/// returns `errc::invalid_type` when it is not one.
+ZS_CHECK zs::error_result load_mapped_module(zs::engine* eng, const char* filename, object& output_fpo);
+
+} // namespace zs.
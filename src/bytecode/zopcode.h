@@ -281,4 +281,15 @@ struct small_string_instruction_data {
 static_assert(
     std::is_trivial_v<small_string_instruction_data>, "small_string_instruction_data must remain trivial");
 
+/// Unused bytes at the end of an instruction.
+/// A superinstruction is padded to the size of the instructions it replaces.
+template <size_t N>
+struct instruction_padding {
+  uint8_t data[N];
+
+  inline friend std::ostream& operator<<(std::ostream& stream, const instruction_padding&) {
+    return stream << N;
+  }
+};
+
 } // namespace zs.
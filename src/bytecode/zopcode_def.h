@@ -1,5 +1,7 @@
 
 /// op_line.
+/// Statement boundary used while compiling, the compiler removes them from the final
+/// instructions and keeps the lines in the `function_prototype_object::_line_info` table.
 #define ZS_INSTRUCTION_LINE(X) X(i64, line)
 ZS_DECL_OPCODE(line, ZS_INSTRUCTION_LINE)
 
@@ -149,7 +151,8 @@ ZS_DECL_OPCODE(set_capture, ZS_INSTRUCTION_SET_CAPTURE)
   X(u8, table_idx)            \
   X(u8, key_idx)              \
   X(u8, value_idx)            \
-  X(bool, can_create)
+  X(bool, can_create)         \
+  X(u16, cache_idx)
 ZS_DECL_OPCODE(set, ZS_INSTRUCTION_SET)
 
 /// op_set_ss.
@@ -184,7 +187,8 @@ ZS_DECL_OPCODE(rawset_ss, ZS_INSTRUCTION_RAWSET_SS)
   X(u8, target_idx)           \
   X(u8, table_idx)            \
   X(u8, key_idx)              \
-  X(get_op_flags_t, flags)
+  X(get_op_flags_t, flags)    \
+  X(u16, cache_idx)
 ZS_DECL_OPCODE(get, ZS_INSTRUCTION_GET)
 
 /// op_cmp.
@@ -273,6 +277,25 @@ ZS_DECL_OPCODE(jz, ZS_INSTRUCTION_JZ)
   X(bool, null_only)
 ZS_DECL_OPCODE(if_not, ZS_INSTRUCTION_IF_NOT)
 
+/// op_foreach_prep.
+/// Starts iterating over the object at `container_idx`. The iteration state
+/// is kept in the two stack slots starting at `iterator_idx`.
+#define ZS_INSTRUCTION_FOREACH_PREP(X) \
+  X(u8, container_idx)                 \
+  X(u8, iterator_idx)
+ZS_DECL_OPCODE(foreach_prep, ZS_INSTRUCTION_FOREACH_PREP)
+
+/// op_foreach_next.
+/// Assigns the next key (unless `key_idx` is `k_invalid_target`) and value,
+/// or jumps by `offset` once the iteration is over.
+#define ZS_INSTRUCTION_FOREACH_NEXT(X) \
+  X(u8, container_idx)                 \
+  X(u8, iterator_idx)                  \
+  X(u8, key_idx)                       \
+  X(u8, value_idx)                     \
+  X(i32, offset)
+ZS_DECL_OPCODE(foreach_next, ZS_INSTRUCTION_FOREACH_NEXT)
+
 /// op_get_capture.
 #define ZS_INSTRUCTION_GET_CAPTURE(X) \
   X(u8, target_idx)                   \
@@ -524,3 +547,149 @@ ZS_DECL_OPCODE(check_type_mask, ZS_INSTRUCTION_CHECK_TYPE_MASK)
   X(u32, mask)                                   \
   X(u64, custom_mask)
 ZS_DECL_OPCODE(check_custom_type_mask, ZS_INSTRUCTION_CHECK_CUSTOM_TYPE_MASK)
+
+//
+// Superinstructions.
+//
+// These are never emitted by the compiler, the peephole optimizer replaces
+// frequent sequences of instructions by them (see `zs::peephole_optimize()`).
+// Each superinstruction has the exact size of the sequence it replaces, so no
+// jump offsets or line infos need to be moved.
+//
+
+/// op_arith_int.
+/// `op_load_int` followed by an `op_arith` using it as its `rhs_idx`.
+#define ZS_INSTRUCTION_ARITH_INT(X) \
+  X(u8, target_idx)                 \
+  X(arithmetic_op, aop)             \
+  X(u8, lhs_idx)                    \
+  X(u8, value_idx)                  \
+  X(int_t, value)                   \
+  X(instruction_padding<2>, padding)
+ZS_DECL_OPCODE(arith_int, ZS_INSTRUCTION_ARITH_INT)
+
+/// op_cmp_int.
+/// `op_load_int` followed by an `op_cmp` using it as its `rhs_idx`.
+#define ZS_INSTRUCTION_CMP_INT(X) \
+  X(u8, target_idx)               \
+  X(compare_op, cmp_op)           \
+  X(u8, lhs_idx)                  \
+  X(u8, value_idx)                \
+  X(int_t, value)                 \
+  X(instruction_padding<2>, padding)
+ZS_DECL_OPCODE(cmp_int, ZS_INSTRUCTION_CMP_INT)
+
+/// op_cmp_jz.
+/// `op_cmp` followed by an `op_jz` on its result.
+/// The `offset` is relative to the beginning of this instruction.
+#define ZS_INSTRUCTION_CMP_JZ(X) \
+  X(u8, target_idx)              \
+  X(compare_op, cmp_op)          \
+  X(u8, lhs_idx)                 \
+  X(u8, rhs_idx)                 \
+  X(i32, offset)                 \
+  X(instruction_padding<2>, padding)
+ZS_DECL_OPCODE(cmp_jz, ZS_INSTRUCTION_CMP_JZ)
+
+/// op_cmp_int_jz.
+/// `op_load_int`, `op_cmp` and `op_jz`, e.g. the condition of `for(...; i < 10; ...)`.
+/// The `offset` is relative to the beginning of this instruction.
+#define ZS_INSTRUCTION_CMP_INT_JZ(X) \
+  X(u8, target_idx)                  \
+  X(compare_op, cmp_op)              \
+  X(u8, lhs_idx)                     \
+  X(u8, value_idx)                   \
+  X(int_t, value)                    \
+  X(i32, offset)                     \
+  X(instruction_padding<4>, padding)
+ZS_DECL_OPCODE(cmp_int_jz, ZS_INSTRUCTION_CMP_INT_JZ)
+
+/// op_get_method.
+/// `op_get` followed by an `op_move`, the compiler emits them for every
+/// member call (`table.fct()`) to get the closure and push `this`.
+#define ZS_INSTRUCTION_GET_METHOD(X) \
+  X(u8, target_idx)                  \
+  X(u8, table_idx)                   \
+  X(u8, key_idx)                     \
+  X(get_op_flags_t, flags)           \
+  X(u16, cache_idx)                  \
+  X(u8, this_idx)                    \
+  X(instruction_padding<2>, padding)
+ZS_DECL_OPCODE(get_method, ZS_INSTRUCTION_GET_METHOD)
+
+//
+// Quickened instructions.
+//
+// These are never emitted by the compiler. The vm rewrites the opcode of an
+// `op_arith`, an `op_cmp`, an `op_arith_int` or an `op_cmp_int_jz` in place once
+// it saw the types of its operands (`_ii` for two integers, `_ff` for two floats)
+// and puts the generic one back when the types change. They have the layout of
+// the instruction they replace.
+//
+
+/// op_add_ii, op_sub_ii, op_mul_ii.
+ZS_DECL_OPCODE(add_ii, ZS_INSTRUCTION_ARITH)
+ZS_DECL_OPCODE(sub_ii, ZS_INSTRUCTION_ARITH)
+ZS_DECL_OPCODE(mul_ii, ZS_INSTRUCTION_ARITH)
+
+/// op_add_ff, op_sub_ff, op_mul_ff, op_div_ff.
+ZS_DECL_OPCODE(add_ff, ZS_INSTRUCTION_ARITH)
+ZS_DECL_OPCODE(sub_ff, ZS_INSTRUCTION_ARITH)
+ZS_DECL_OPCODE(mul_ff, ZS_INSTRUCTION_ARITH)
+ZS_DECL_OPCODE(div_ff, ZS_INSTRUCTION_ARITH)
+
+/// op_eq_ii, op_ne_ii, op_lt_ii, op_le_ii, op_gt_ii, op_ge_ii.
+ZS_DECL_OPCODE(eq_ii, ZS_INSTRUCTION_CMP)
+ZS_DECL_OPCODE(ne_ii, ZS_INSTRUCTION_CMP)
+ZS_DECL_OPCODE(lt_ii, ZS_INSTRUCTION_CMP)
+ZS_DECL_OPCODE(le_ii, ZS_INSTRUCTION_CMP)
+ZS_DECL_OPCODE(gt_ii, ZS_INSTRUCTION_CMP)
+ZS_DECL_OPCODE(ge_ii, ZS_INSTRUCTION_CMP)
+
+/// op_lt_ff, op_le_ff, op_gt_ff, op_ge_ff.
+ZS_DECL_OPCODE(lt_ff, ZS_INSTRUCTION_CMP)
+ZS_DECL_OPCODE(le_ff, ZS_INSTRUCTION_CMP)
+ZS_DECL_OPCODE(gt_ff, ZS_INSTRUCTION_CMP)
+ZS_DECL_OPCODE(ge_ff, ZS_INSTRUCTION_CMP)
+
+/// op_add_int_ii, op_sub_int_ii, op_mul_int_ii.
+ZS_DECL_OPCODE(add_int_ii, ZS_INSTRUCTION_ARITH_INT)
+ZS_DECL_OPCODE(sub_int_ii, ZS_INSTRUCTION_ARITH_INT)
+ZS_DECL_OPCODE(mul_int_ii, ZS_INSTRUCTION_ARITH_INT)
+
+/// op_eq_int_jz_ii, op_ne_int_jz_ii, op_lt_int_jz_ii, op_le_int_jz_ii,
+/// op_gt_int_jz_ii, op_ge_int_jz_ii.
+ZS_DECL_OPCODE(eq_int_jz_ii, ZS_INSTRUCTION_CMP_INT_JZ)
+ZS_DECL_OPCODE(ne_int_jz_ii, ZS_INSTRUCTION_CMP_INT_JZ)
+ZS_DECL_OPCODE(lt_int_jz_ii, ZS_INSTRUCTION_CMP_INT_JZ)
+ZS_DECL_OPCODE(le_int_jz_ii, ZS_INSTRUCTION_CMP_INT_JZ)
+ZS_DECL_OPCODE(gt_int_jz_ii, ZS_INSTRUCTION_CMP_INT_JZ)
+ZS_DECL_OPCODE(ge_int_jz_ii, ZS_INSTRUCTION_CMP_INT_JZ)
+
+//
+// Struct member slots.
+//
+// Emitted by the compiler instead of an `op_get` or an `op_set` when the
+// object is a local typed with a struct declared in the same file
+// (e.g. `var<Point> p` or `Point p`). The member is read or written directly at
+// `slot_idx` as long as the instance has a public member `key_idx` at this slot,
+// otherwise they do the same thing as an `op_get` or an `op_set`.
+//
+
+/// op_get_struct_slot.
+#define ZS_INSTRUCTION_GET_STRUCT_SLOT(X) \
+  X(u8, target_idx)                       \
+  X(u8, table_idx)                        \
+  X(u8, key_idx)                          \
+  X(u16, slot_idx)
+ZS_DECL_OPCODE(get_struct_slot, ZS_INSTRUCTION_GET_STRUCT_SLOT)
+
+/// op_set_struct_slot.
+#define ZS_INSTRUCTION_SET_STRUCT_SLOT(X) \
+  X(u8, target_idx)                       \
+  X(u8, table_idx)                        \
+  X(u8, key_idx)                          \
+  X(u8, value_idx)                        \
+  X(bool, can_create)                     \
+  X(u16, slot_idx)
+ZS_DECL_OPCODE(set_struct_slot, ZS_INSTRUCTION_SET_STRUCT_SLOT)
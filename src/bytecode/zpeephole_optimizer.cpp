@@ -0,0 +1,165 @@
+#include "zpeephole_optimizer.h"
+
+namespace zs {
+
+static_assert(get_instruction_size<opcode::op_arith_int>()
+    == get_instruction_size<opcode::op_load_int>() + get_instruction_size<opcode::op_arith>());
+
+static_assert(get_instruction_size<opcode::op_cmp_int>()
+    == get_instruction_size<opcode::op_load_int>() + get_instruction_size<opcode::op_cmp>());
+
+static_assert(get_instruction_size<opcode::op_cmp_jz>()
+    == get_instruction_size<opcode::op_cmp>() + get_instruction_size<opcode::op_jz>());
+
+static_assert(get_instruction_size<opcode::op_cmp_int_jz>()
+    == get_instruction_size<opcode::op_load_int>() + get_instruction_size<opcode::op_cmp>()
+        + get_instruction_size<opcode::op_jz>());
+
+static_assert(get_instruction_size<opcode::op_get_method>()
+    == get_instruction_size<opcode::op_get>() + get_instruction_size<opcode::op_move>());
+
+namespace {
+  using enum opcode;
+
+  class peephole_optimizer {
+  public:
+    inline peephole_optimizer(instruction_vector& insts)
+        : _insts(insts)
+        , _jump_targets(insts._data.size() + 1, false, zs::allocator<bool>(insts._data.get_allocator())) {}
+
+    void optimize() {
+      find_jump_targets();
+
+      const size_t size = _insts._data.size();
+      size_t index = 0;
+
+      while (index < size) {
+        index += optimize_at(index);
+      }
+    }
+
+  private:
+    instruction_vector& _insts;
+    zs::vector<bool> _jump_targets;
+
+    void find_jump_targets() {
+      update_jump_offsets(_insts, [&](size_t index, int32_t offset) {
+        const int64_t target = (int64_t)index + offset;
+
+        if (target >= 0 and target < (int64_t)_jump_targets.size()) {
+          _jump_targets[(size_t)target] = true;
+        }
+
+        return offset;
+      });
+    }
+
+    /// Returns true if the instruction at `index` is an `Op` that can be
+    /// fused with the instructions before it.
+    template <opcode Op>
+    ZS_CK_INLINE bool is_fusable(size_t index) const noexcept {
+      return index < _insts._data.size() and _insts.get_opcode(index) == Op and !_jump_targets[index];
+    }
+
+    /// Returns the size of what was consumed at `index`.
+    size_t optimize_at(size_t index) {
+      switch (_insts.get_opcode(index)) {
+      case op_load_int:
+        return optimize_load_int(index);
+      case op_cmp:
+        return optimize_cmp(index);
+      case op_get:
+        return optimize_get(index);
+      default:
+        return get_instruction_size(_insts.get_opcode(index));
+      }
+    }
+
+    size_t optimize_load_int(size_t index) {
+      const instruction_t<op_load_int> load = _insts.get_ref<op_load_int>(index);
+      const size_t next_index = index + get_instruction_size<op_load_int>();
+
+      if (is_fusable<op_cmp>(next_index)) {
+        const instruction_t<op_cmp> cmp = _insts.get_ref<op_cmp>(next_index);
+        if (cmp.rhs_idx != load.target_idx) {
+          return get_instruction_size<op_load_int>();
+        }
+
+        const size_t jz_index = next_index + get_instruction_size<op_cmp>();
+
+        if (is_fusable<op_jz>(jz_index)) {
+          const instruction_t<op_jz> jz = _insts.get_ref<op_jz>(jz_index);
+
+          if (jz.value_idx == cmp.target_idx) {
+            const int32_t offset = jz.offset + (int32_t)(jz_index - index);
+            return write(index,
+                instruction_t<op_cmp_int_jz>(op_cmp_int_jz, cmp.target_idx, cmp.cmp_op, cmp.lhs_idx,
+                    load.target_idx, load.value, offset, {}));
+          }
+        }
+
+        return write(index,
+            instruction_t<op_cmp_int>(
+                op_cmp_int, cmp.target_idx, cmp.cmp_op, cmp.lhs_idx, load.target_idx, load.value, {}));
+      }
+
+      if (is_fusable<op_arith>(next_index)) {
+        const instruction_t<op_arith> arith = _insts.get_ref<op_arith>(next_index);
+
+        if (arith.rhs_idx == load.target_idx) {
+          return write(index,
+              instruction_t<op_arith_int>(
+                  op_arith_int, arith.target_idx, arith.aop, arith.lhs_idx, load.target_idx, load.value, {}));
+        }
+      }
+
+      return get_instruction_size<op_load_int>();
+    }
+
+    size_t optimize_cmp(size_t index) {
+      const instruction_t<op_cmp> cmp = _insts.get_ref<op_cmp>(index);
+      const size_t jz_index = index + get_instruction_size<op_cmp>();
+
+      if (is_fusable<op_jz>(jz_index)) {
+        const instruction_t<op_jz> jz = _insts.get_ref<op_jz>(jz_index);
+
+        if (jz.value_idx == cmp.target_idx) {
+          const int32_t offset = jz.offset + (int32_t)(jz_index - index);
+          return write(index,
+              instruction_t<op_cmp_jz>(
+                  op_cmp_jz, cmp.target_idx, cmp.cmp_op, cmp.lhs_idx, cmp.rhs_idx, offset, {}));
+        }
+      }
+
+      return get_instruction_size<op_cmp>();
+    }
+
+    size_t optimize_get(size_t index) {
+      const instruction_t<op_get> get = _insts.get_ref<op_get>(index);
+      const size_t move_index = index + get_instruction_size<op_get>();
+
+      if (is_fusable<op_move>(move_index)) {
+        const instruction_t<op_move> move = _insts.get_ref<op_move>(move_index);
+
+        if (move.value_idx == get.table_idx) {
+          return write(index,
+              instruction_t<op_get_method>(op_get_method, get.target_idx, get.table_idx, get.key_idx,
+                  get.flags, get.cache_idx, move.target_idx, {}));
+        }
+      }
+
+      return get_instruction_size<op_get>();
+    }
+
+    template <opcode Op>
+    inline size_t write(size_t index, const instruction_t<Op>& inst) noexcept {
+      zb::memcpy(_insts.data(index), &inst, get_instruction_size<Op>());
+      return get_instruction_size<Op>();
+    }
+  };
+} // namespace.
+
+void peephole_optimize(instruction_vector& insts) {
+  peephole_optimizer(insts).optimize();
+}
+} // namespace zs.
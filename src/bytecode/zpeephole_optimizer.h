@@ -0,0 +1,29 @@
+#pragma once
+
+#include "zinstruction_vector.h"
+
+namespace zs {
+
+/// Optimization passes run on the instructions of a compiled function.
+enum class optimization_level : uint8_t {
+  /// The instructions are kept as emitted by the compiler.
+  ol_none,
+
+  /// Fuse frequent instruction sequences into superinstructions (see `peephole_optimize()`).
+  ol_peephole
+};
+
+/// Replace frequent instruction sequences by a single superinstruction:
+///
+///   * `op_load_int` + `op_cmp` + `op_jz` -> `op_cmp_int_jz`
+///   * `op_cmp` + `op_jz`                 -> `op_cmp_jz`
+///   * `op_load_int` + `op_cmp`           -> `op_cmp_int`
+///   * `op_load_int` + `op_arith`         -> `op_arith_int`
+///   * `op_get` + `op_move`               -> `op_get_method`
+///
+/// A superinstruction has the size of the sequence it replaces and is
+/// written in place, the jump offsets and the line infos remain valid.
+/// A sequence is left untouched when a jump lands in the middle of it.
+void peephole_optimize(instruction_vector& insts);
+
+} // namespace zs.
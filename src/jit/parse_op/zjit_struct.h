@@ -7,7 +7,8 @@ struct struct_parser {
   inline struct_parser(zs::engine* eng)
       : names((zs::allocator<zs::object>(eng)))
       , methods((zs::allocator<zs::object>(eng)))
-      , constructors((zs::allocator<zs::object>(eng))) {}
+      , constructors((zs::allocator<zs::object>(eng)))
+      , slots((zs::allocator<zs::object>(eng))) {}
 
   inline zs::error_result add_member(const zs::object& name) {
     if (names.contains(name) or methods.contains(name)) {
@@ -93,6 +94,10 @@ struct struct_parser {
   zs::small_vector<zs::object, 8> names;
   zs::small_vector<zs::object, 8> methods;
   zs::small_vector<const zs::function_prototype_object*, 8> constructors;
+
+  /// Member names by slot index, null for the private ones (they can't be resolved
+  /// at compile time).
+  zs::small_vector<zs::object, 8> slots;
   bool has_default_constructor = false;
 };
 
@@ -201,6 +206,10 @@ auto jit_compiler::create_local_lambda<parse_struct_member>() {
       ZS_COMPILER_RETURN_IF_ERROR(
           sparser.add_member(identifier), "struct member variable", identifier, "already exists.\n");
 
+      if (!vinfo.is_static()) {
+        sparser.slots.push_back(vinfo.is_private() ? zs::object() : identifier);
+      }
+
       if (!is_small_string_identifier(identifier)) {
         add_string_instruction(identifier);
       }
@@ -336,6 +345,10 @@ zs::error_result jit_compiler::parse_struct(const object* struct_name) {
 
   lex();
 
+  if (struct_name) {
+    _ccs->add_struct_layout(*struct_name, zs::object::create_array(_engine, sparser.slots));
+  }
+
   return {};
 }
 
@@ -341,6 +341,37 @@ zs::error_result closure_compile_state::get_restricted_type_mask(
   return zs::error_code::not_found;
 }
 
+void closure_compile_state::add_struct_layout(const object& name, const object& slots) {
+  _sdata._struct_layouts[name] = slots;
+}
+
+int_t closure_compile_state::find_struct_slot(
+    const variable_type_info& vinfo, const object& key) const noexcept {
+  if (!std::has_single_bit(vinfo.custom_mask)) {
+    return -1;
+  }
+
+  const size_t type_index = (size_t)std::countr_zero(vinfo.custom_mask);
+  if (type_index >= _sdata._restricted_types.size()) {
+    return -1;
+  }
+
+  auto it = _sdata._struct_layouts.find(_sdata._restricted_types[type_index]);
+  if (it == _sdata._struct_layouts.end()) {
+    return -1;
+  }
+
+  const zs::array_object& slots = it->second.as_array();
+  const int_t sz = slots.size();
+  for (int_t i = 0; i < sz; i++) {
+    if (slots[i] == key) {
+      return i;
+    }
+  }
+
+  return -1;
+}
+
 // zs::error_result closure_compile_state::create_export_table() {
 //   if (has_export()) {
 //     return {};
@@ -352,39 +383,15 @@ zs::error_result closure_compile_state::get_restricted_type_mask(
 // }
 
 void closure_compile_state::add_line_infos(const zs::line_info& linfo) {
-
-  //  if(_last_line != linfo.line) {
   line_info_op_t li;
   li.line = linfo.line;
   li.column = linfo.column;
-
-  if (!_instructions._data.empty()) {
-    li.op = zs::instruction_iterator(&_instructions._data[_last_instruction_index]).get_opcode();
-  }
-  else {
-    li.op = opcode::op_line;
-  }
-
-  li.op_index = _last_instruction_index;
+  li.op = opcode::op_line;
+  li.op_index = _instructions._data.size();
 
   _line_info.push_back(li);
   add_instruction<opcode::op_line>(li.line);
   _last_line = li.line;
-  //  }
-
-  //  if (_lastline != line || force) {
-  //    SQLineInfo li;
-  //    li._line = line;
-  //    li._op = (GetCurrentPos() + 1);
-  //    if (lineop)
-  //      AddInstruction(_OP_LINE, 0, line);
-  //
-  //    if (_lastline != line) {
-  //      _lineinfos.push_back(li);
-  //    }
-  //
-  //    _lastline = line;
-  //  }
 }
 
 #if ZS_DEBUG
@@ -424,7 +431,77 @@ void closure_compile_state::add_debug_line_info(const zs::line_info& linfo) {
 }
 #endif
 
+void closure_compile_state::remove_line_instructions() {
+  const size_t size = _instructions._data.size();
+
+  // New byte offset of every byte of the instructions.
+  zs::vector<uint32_t> new_indexes((zs::allocator<uint32_t>(get_engine())));
+  new_indexes.resize(size + 1);
+
+  size_t new_size = 0;
+  for (size_t index = 0; index < size;) {
+    const opcode op = _instructions.get_opcode(index);
+    const size_t inst_size = get_instruction_size(op);
+    const bool is_removed = op == opcode::op_line;
+
+    for (size_t i = 0; i < inst_size; i++) {
+      new_indexes[index + i] = (uint32_t)(new_size + (is_removed ? 0 : i));
+    }
+
+    new_size += is_removed ? 0 : inst_size;
+    index += inst_size;
+  }
+
+  new_indexes[size] = (uint32_t)new_size;
+
+  if (new_size == size) {
+    return;
+  }
+
+  const auto relocate = [&](auto index) -> decltype(index) {
+    return (size_t)index < new_indexes.size() ? new_indexes[(size_t)index] : index;
+  };
+
+  update_jump_offsets(_instructions, [&](size_t index, int32_t offset) {
+    return (int32_t)new_indexes[index + offset] - (int32_t)new_indexes[index];
+  });
+
+  zs::vector<uint8_t>& data = _instructions._data;
+  size_t dst = 0;
+  for (size_t index = 0; index < size;) {
+    const size_t inst_size = get_instruction_size(_instructions.get_opcode(index));
+
+    if (_instructions.get_opcode(index) != opcode::op_line) {
+      ::memmove(data.data() + dst, data.data() + index, inst_size);
+      dst += inst_size;
+    }
+
+    index += inst_size;
+  }
+
+  data.resize(new_size);
+
+  for (line_info_op_t& li : _line_info) {
+    li.op_index = relocate(li.op_index);
+  }
+
+#if ZS_DEBUG
+  for (line_info_op_t& li : _debug_line_info) {
+    li.op_index = relocate(li.op_index);
+  }
+#endif
+
+  for (local_var_info_t& lvi : _local_var_infos) {
+    lvi.start_op = relocate(lvi.start_op);
+
+    if (lvi.end_op != k_captured_end_op) {
+      lvi.end_op = relocate(lvi.end_op);
+    }
+  }
+}
+
 object closure_compile_state::build_function_prototype() {
+  remove_line_instructions();
 
   object obj = zs::function_prototype_object::create(get_engine());
   zs::function_prototype_object* fpo = &function_prototype_object::as_proto(obj);
@@ -443,10 +520,20 @@ object closure_compile_state::build_function_prototype() {
 
   fpo->_parameter_names = std::move(_parameter_names);
   fpo->_restricted_types = _sdata._restricted_types;
+
+  if (_sdata._optimization_level != optimization_level::ol_none) {
+    peephole_optimize(_instructions);
+  }
+
   fpo->_instructions = std::move(_instructions);
+  fpo->_inline_caches.resize(_n_inline_caches);
   fpo->_functions = std::move(_functions);
   fpo->_captures = std::move(_captures);
-  fpo->_line_info = std::move(_line_info);
+
+  for (const line_info_op_t& li : _line_info) {
+    fpo->_line_info.add(li.op_index, zs::line_info(li.line, li.column));
+  }
+
   fpo->_default_params = _default_params;
   fpo->_n_capture = _n_capture;
   fpo->_module_info = _sdata._module_info;
@@ -24,6 +24,8 @@
 
 #include <zscript/zscript.h>
 #include "bytecode/zinstruction_vector.h"
+#include "bytecode/zpeephole_optimizer.h"
+#include "bytecode/zinline_cache.h"
 
 namespace zs {
 
@@ -128,6 +130,7 @@ namespace jit {
     inline shared_state_data(zs::engine* eng)
         : engine_holder(eng)
         , _restricted_types(zs::allocator<object>(eng))
+        , _struct_layouts(zs::unordered_map_allocator<object, object>(eng))
         //        , _exported_names(zs::allocator<object>(eng))
         , _imported_files_set(zs::allocator<object>(eng)) {}
 
@@ -174,6 +177,10 @@ namespace jit {
     /// Type list.
     zs::small_vector<zs::object, 8> _restricted_types;
 
+    /// Member names of the named structs declared in the file, by slot index
+    /// (null for a private member), see `closure_compile_state::find_struct_slot()`.
+    zs::object_unordered_map<zs::object> _struct_layouts;
+
     /// Used to prevent from importing the same file twice (calling `#import`).
     zs::object_unordered_set _imported_files_set;
 
@@ -187,6 +194,9 @@ namespace jit {
     //    zs::object_unordered_set _exported_names;
 
     bool _is_module = false;
+
+    /// Passes run on the instructions of every function (see `jit_compiler::compile()`).
+    optimization_level _optimization_level = optimization_level::ol_peephole;
   };
 
   class shared_state_data_ref {
@@ -390,9 +400,20 @@ public:
 
   ZB_CHECK zs::error_result get_restricted_type_mask(const object& name, int_t& mask) const noexcept;
 
+  /// Keeps the member names of the struct `name` (an array indexed by slot).
+  void add_struct_layout(const object& name, const object& slots);
+
+  /// Returns the slot index of the public member `key` when `vinfo` is restricted
+  /// to a single struct type declared in the file, or -1 otherwise.
+  /// This is only a guess, the vm still checks the member at runtime.
+  ZB_CHECK int_t find_struct_slot(const variable_type_info& vinfo, const object& key) const noexcept;
+
   //  ZB_CHECK zs::error_result create_export_table();
 
-  ///
+  /// Marks the beginning of a statement.
+  /// An `op_line` is added as a statement boundary for the compiler, all of them
+  /// are removed by `build_function_prototype()` and the line infos end up in
+  /// the prototype `line_table`.
   void add_line_infos(const zs::line_info& linfo);
 
 #if ZS_DEBUG
@@ -401,6 +422,10 @@ public:
 
   ZB_CHECK zs::object build_function_prototype();
 
+  /// Removes the `op_line` instructions and moves the jump offsets, the line infos
+  /// and the local variable ranges accordingly.
+  void remove_line_instructions();
+
   ZB_CHECK ZB_INLINE zs::closure_compile_state* get_parent() const noexcept { return _parent; }
 
   ZB_CHECK ZB_INLINE bool is_top_level() const noexcept { return _parent == nullptr; }
@@ -414,6 +439,12 @@ public:
 
   ZS_CK_INLINE size_t get_current_capture_count() const noexcept { return _n_capture; }
 
+  /// Returns a new inline cache index for `op_get` and `op_set`,
+  /// or `k_invalid_inline_cache` once all indices are used.
+  ZS_CK_INLINE uint16_t new_inline_cache() noexcept {
+    return _n_inline_caches < k_invalid_inline_cache ? _n_inline_caches++ : k_invalid_inline_cache;
+  }
+
 private:
   friend class jit_compiler;
   friend class parser;
@@ -448,7 +479,7 @@ private:
   /// Only these will be exported to the function prototype.
   zs::vector<zs::local_var_info_t> _local_var_infos;
 
-  /// Line infos.
+  /// Line infos, the `op_index` is the one of the `op_line` of each statement.
   zs::vector<zs::line_info_op_t> _line_info;
 
   /// Functions.
@@ -478,6 +509,9 @@ private:
   /// This is the maximum stack size that the function will need.
   uint32_t _total_stack_size = 0;
 
+  /// Number of inline caches used by `op_get` and `op_set`.
+  uint16_t _n_inline_caches = 0;
+
   bool _has_vargs_params = false;
 
   void mark_local_as_capture(int_t pos);
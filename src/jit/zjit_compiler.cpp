@@ -67,7 +67,8 @@ zs::error_result jit_compiler::handle_error(
 }
 
 zs::error_result jit_compiler::compile(std::string_view content, object filename, object& output,
-    zs::virtual_machine* vm, zs::token_type* prepended_token, bool with_vargs, bool add_line_info) {
+    zs::virtual_machine* vm, zs::token_type* prepended_token, bool with_vargs, bool add_line_info,
+    optimization_level opt_level) {
   _add_line_info = add_line_info;
   _vm = vm;
 
@@ -78,6 +79,7 @@ zs::error_result jit_compiler::compile(std::string_view content, object filename
   _lexer->init(content);
 
   jit::shared_state_data sdata(_engine);
+  sdata._optimization_level = opt_level;
   zs::closure_compile_state c_compile_state(_engine, sdata);
   _ccs = &c_compile_state;
 
@@ -164,7 +166,8 @@ void jit_compiler::move_if_current_target_is_local() {
 void jit_compiler::add_string_instruction(std::string_view s, int_t target_idx) noexcept {
   target_idx = target_idx == k_invalid_target ? new_target() : target_idx;
   if (s.size() > zs::constants::k_small_string_max_size) {
-    add_instruction<op_load_string>(target_idx, (uint32_t)_ccs->get_literal(zs::_s(_engine, s)));
+    add_instruction<op_load_string>(
+        target_idx, (uint32_t)_ccs->get_literal(zs::object::create_interned_string(_engine, s)));
   }
   else {
     add_instruction<op_load_small_string>(target_idx, zs::ss_inst_data::create(s));
@@ -251,7 +254,8 @@ auto jit_compiler::create_local_lambda<parse_prefixed_lbracket>() {
         ZS_ASSERT(table_idx == _estate.pos);
 
         // Get the item at the given `key_idx`, from the table at `table_idx`.
-        add_new_target_instruction<op_get>(table_idx, key_idx, make_get_op_flags(_estate.pos == 0, true));
+        add_new_target_instruction<op_get>(
+            table_idx, key_idx, make_get_op_flags(_estate.pos == 0, true), _ccs->new_inline_cache());
 
         // -1: closure.
         // -2: tbl.
@@ -847,8 +851,13 @@ auto jit_compiler::create_local_lambda<parse_assign>() {
       if (table_idx == 0 and _ccs->is_top_level()) {
         add_new_target_instruction<op_rawset>(table_idx, key_idx, value_idx, !_estate.no_new_set);
       }
+      else if (estate.struct_slot != -1) {
+        add_new_target_instruction<op_set_struct_slot>(
+            table_idx, key_idx, value_idx, !_estate.no_new_set, (u16)estate.struct_slot);
+      }
       else {
-        add_new_target_instruction<op_set>(table_idx, key_idx, value_idx, !_estate.no_new_set);
+        add_new_target_instruction<op_set>(
+            table_idx, key_idx, value_idx, !_estate.no_new_set, _ccs->new_inline_cache());
       }
 
       return {};
@@ -870,6 +879,7 @@ zs::error_result jit_compiler::parse_expression() {
   _estate.type = expr_type::e_expr;
   _estate.pos = -1;
   _estate.no_get = false;
+  _estate.struct_slot = -1;
 
   ZS_RETURN_IF_ERROR(parse<p_triple_or>());
 
@@ -1099,332 +1109,144 @@ zs::error_result jit_compiler::parse_if() {
   return {};
 }
 
-zs::error_result jit_compiler::parse_for_auto(std::span<zs::token_type> sp) {
-
-  object val_name;
-  object key_name;
-  const char* colon_ptr = nullptr;
-  const char* type_list_begin = nullptr;
-  const char* type_list_end = nullptr;
-  const char* input_code_begin = _lexer->stream().ptr();
-
-  //  if(sp[0] == tok_int) {
-  //    zb::print("DSKDJSKJDLKSDJKLSDDHHAJKSKJA");
-  //  }
-
-  size_t type_restriction_begin_token_index = 0;
-  size_t type_restriction_end_token_index = 0;
-
-  if (zb::is_one_of(
-          sp[1], tok_int, tok_char, tok_bool, tok_float, tok_number, tok_string, tok_table, tok_atom)) {
-    type_restriction_begin_token_index = 0;
-    type_restriction_end_token_index = 1;
-  }
-  else if (sp[1] == tok_auto) {
-  }
-  else if (sp[1] == tok_var and sp[2] == tok_lt) {
+zs::error_result jit_compiler::parse_for_auto() {
+  // for(var k, v : container)
+  //    ^
+  ZS_COMPILER_EXPECT(tok_lbracket);
 
-    type_restriction_begin_token_index = 2;
+  zb::scoped auto_scope = start_new_auto_scope_with_close_capture();
 
-    for (size_t i = 2; i < sp.size() - 1; i++) {
-      if (sp[i] == tok_gt) {
-        type_restriction_end_token_index = i - 1;
-        break;
-      }
-    }
+  // for(var k, v : container)
+  //     ^
+  variable_type_info vinfo;
+  if (is(tok_auto)) {
+    lex();
   }
-
-  else if (sp[1] == tok_identifier) {
-
+  else if (is(tok_identifier) and _lexer->peek() != tok_identifier) {
     return ZS_COMPILER_ERROR(invalid_token, "expected var or type");
   }
-
-  bool has_key = false;
-  if (type_restriction_end_token_index) {
-    for (size_t i = 0; i < sp.size() - 1; i++) {
-      if (i == type_restriction_begin_token_index) {
-        type_list_begin = _lexer->stream().ptr();
-      }
-
-      if (i == type_restriction_end_token_index) {
-        type_list_end = _lexer->stream().ptr();
-      }
-
-      if (is(tok_identifier) and i > type_restriction_end_token_index and val_name.is_null()) {
-        val_name = _lexer->get_identifier();
-
-        if (!zb::is_one_of(sp[i + 1], tok_colon)) {
-          has_key = true;
-        }
-      }
-      else if (is(tok_identifier) and i > type_restriction_end_token_index and key_name.is_null()
-          and has_key) {
-        key_name = _lexer->get_identifier();
-
-        if (!zb::is_one_of(sp[i + 1], tok_colon)) {
-          return ZS_COMPILER_ERROR(invalid_token, "expected ':' in for loop");
-        }
-      }
-
-      else if (is(tok_colon)) {
-        if (colon_ptr) {
-          return ZS_COMPILER_ERROR(invalid_token, "multiple ':' in for loop");
-        }
-        colon_ptr = _lexer->stream().ptr();
-      }
-
-      lex();
-    }
-  }
   else {
-    for (size_t i = 0; i < sp.size() - 1; i++) {
-
-      if (is(tok_identifier) and val_name.is_null()) {
-        val_name = _lexer->get_identifier();
-
-        if (!zb::is_one_of(sp[i + 1], tok_colon)) {
-          has_key = true;
-        }
-      }
-      else if (is(tok_identifier) and key_name.is_null() and has_key) {
-        key_name = _lexer->get_identifier();
-
-        if (!zb::is_one_of(sp[i + 1], tok_colon)) {
-          //            has_key = true;
-          return ZS_COMPILER_ERROR(invalid_token, "expected ':' in for loop");
-        }
-      }
-
-      else if (is(tok_colon)) {
-
-        if (colon_ptr) {
-          return ZS_COMPILER_ERROR(invalid_token, "multiple ':' in for loop");
-        }
-        colon_ptr = _lexer->stream().ptr();
-      }
-
-      lex();
-    }
+    ZS_RETURN_IF_ERROR(parse_variable(vinfo));
   }
 
-  std::string_view vname = zb::strip_leading_and_trailing_spaces(val_name.get_string_unchecked());
-  std::string_view kname;
-
-  if (has_key) {
-    kname = zb::strip_leading_and_trailing_spaces(key_name.get_string_unchecked());
+  // for(var k, v : container)
+  //         ^
+  if (is_not(tok_identifier)) {
+    return ZS_COMPILER_ERROR(identifier_expected, "expected identifier in for loop");
   }
 
-  std::string_view array_code = zb::strip_leading_and_trailing_spaces(
-      std::string_view(colon_ptr, std::distance(colon_ptr, _lexer->stream().ptr() - 1)));
-
-  std::string_view type_list_code;
-  if (type_restriction_end_token_index) {
-    type_list_code = zb::strip_leading_and_trailing_spaces(
-        std::string_view(type_list_begin, std::distance(type_list_begin, type_list_end)));
-  }
-
-  //  zb::print(ZBASE_VNAME(type_list_code));
-
-  std::string_view input_code(input_code_begin, std::distance(input_code_begin, _lexer->stream().ptr()));
-
-  zb::scoped auto_scope = start_new_auto_scope();
-
-  //
-  //
-  zs::lexer* last_lexer = _lexer;
+  object key_name;
+  object value_name(_engine, _lexer->get_identifier_value());
+  lex();
 
-  zs::string var_type("", zs::string_allocator(_engine));
+  // With two names, the first one is the key.
+  if (lex_if(tok_comma)) {
+    if (is_not(tok_identifier)) {
+      return ZS_COMPILER_ERROR(identifier_expected, "expected identifier in for loop");
+    }
 
-  if (type_restriction_end_token_index) {
-    var_type.push_back('<');
-    var_type.append(type_list_code);
-    var_type.append(", null>");
+    key_name
+        = std::exchange(value_name, zs::object::create_interned_string(_engine, _lexer->get_identifier_value()));
+    lex();
   }
 
-  zs::string output_code((zs::string_allocator(_engine)));
-
-  if (has_key) {
-
-    output_code = zs::strprint(_engine, //
-        "var __private_array = ", array_code, //
-        ", __private_array_end = __private_array.end()", //
-        ", __private_iterator = __private_array.begin();", //
-        "var", var_type, " ", kname, " = __private_iterator.get_if_not(__private_array_end), ", vname,
-        " = __private_iterator.get_key_if_not(__private_array_end);", //
-        " !__private_iterator.is_same(__private_array_end);", //
-        " ++__private_iterator, ", //
-        kname, " = __private_iterator.get_if_not(__private_array_end), ", vname,
-        " = __private_iterator.get_key_if_not(__private_array_end)");
+  // for(var k, v : container)
+  //              ^
+  if (!lex_if(tok_colon)) {
+    return ZS_COMPILER_ERROR(invalid_token, "expected ':' in for loop");
   }
-  else {
 
-    output_code = zs::strprint(_engine, //
-        "var __private_array = ", array_code, //
-        ", __private_array_end = __private_array.end()", //
-        ", __private_iterator = __private_array.begin();", //
-        "var", var_type, " ", vname, " = __private_iterator.get_if_not(__private_array_end);", //
-        " !__private_iterator.is_same(__private_array_end);", //
-        " ++__private_iterator, ", //
-        vname, " = __private_iterator.get_if_not(__private_array_end)");
-  }
+  // for(var k, v : container)
+  //                ^
+  ZS_RETURN_IF_ERROR(parse_expression());
 
-  //  zs::string output_code = type_restriction_end_token_index
-  //      ?
-  //
-  //      // With var<...>.
-  //      zs::strprint(_engine, "var __private_array = ", array_code,
-  //          ", __private_array_end = __private_array.end(), __private_iterator = __private_array.begin();
-  //          var<", type_list_code, ", null> ", vname, " =
-  //          __private_iterator.get_if_not(__private_array_end)",
-  //          "; __private_iterator != __private_array_end;\n  ++__private_iterator, ", vname,
-  //          " = __private_iterator.get_if_not(__private_array_end)")
-  //
-  //  // Normal var.
-  //      : zs::strprint(_engine, "var __private_array = ", array_code,
-  //            ", __private_array_end = __private_array.end(), __private_iterator = __private_array.begin();
-  //            " "var ", vname, " = __private_iterator.get_if_not(__private_array_end)",
-  //            "; __private_iterator != __private_array_end; ++__private_iterator, ", vname,
-  //            " = __private_iterator.get_if_not(__private_array_end)");
-
-  //  zb::print(output_code);
-  zs::lexer lexer(_engine, output_code);
-  _lexer = &lexer;
+  // for(var k, v : container)
+  //                         ^
+  ZS_COMPILER_EXPECT(tok_rbracket);
 
-  lex();
-  //  zb::print(_token);
+  // The container and the iteration state are kept in hidden locals.
+  int_t container_idx = 0;
+  int_t iterator_idx = 0;
 
-  if (is_var_decl_tok()) {
-    ZS_RETURN_IF_ERROR(parse_variable_declaration());
-  }
+  {
+    target_t src = pop_target();
+    target_t dest = new_target();
 
-  lex();
+    if (dest != src) {
+      add_instruction<op_move>(dest, src);
+    }
 
-  // for(var i = 0
-  //     ^
-  if (is_var_decl_tok()) {
-    ZS_RETURN_IF_ERROR(parse_variable_declaration());
-  }
-  else if (is_not(tok_semi_colon)) {
-    ZS_RETURN_IF_ERROR(parse_comma());
-    _ccs->pop_target();
+    pop_target();
+    ZS_RETURN_IF_ERROR(add_stack_variable(zs::_s(_engine, "__foreach_container"), &container_idx));
+    ZS_RETURN_IF_ERROR(add_stack_variable(zs::_s(_engine, "__foreach_iterator"), &iterator_idx));
+    ZS_RETURN_IF_ERROR(add_stack_variable(zs::_s(_engine, "__foreach_state")));
   }
 
-  // for(var i = 0;
-  //              ^
-  ZS_COMPILER_EXPECT(tok_semi_colon);
-
-  // The next instruction is the beginning of the condition.
-  const int_t cond_inst_start_idx = _ccs->get_next_instruction_index();
-
-  // for(var i = 0; i < 10; i++)
-  //                ^
-  int_t cond_inst_jz_idx = -1;
-  if (is_not(tok_semi_colon)) {
-    ZS_RETURN_IF_ERROR(parse_comma());
-    add_instruction<op_jz>(0, _ccs->pop_target());
-    cond_inst_jz_idx = _ccs->get_instruction_index();
-    //    jz_next_index =_ccs->get_next_instruction_index();
+  // Like the previous `var<types, null>` desugaring, null is always accepted.
+  if (vinfo.has_mask() or vinfo.has_custom_mask()) {
+    vinfo.mask |= zs::get_object_type_mask(k_null);
   }
 
-  const int_t cond_inst_last_idx = _ccs->get_instruction_index();
-  //  const int_t cond_inst_end_idx = _ccs->get_next_instruction_index();
-  const bool has_cond = cond_inst_jz_idx > 0;
-
-  // for(var i = 0; i < 10;
-  //                      ^
-  ZS_COMPILER_EXPECT(tok_semi_colon);
-
-  const int_t incr_expr_inst_start_idx = _ccs->get_next_instruction_index();
+  int_t key_idx = k_invalid_target;
+  int_t value_idx = 0;
 
-  if (is_not(tok_rbracket)) {
-    // for(var i = 0; i < 10; i++)
-    //                        ^
-    ZS_RETURN_IF_ERROR(parse_comma());
-    _ccs->pop_target();
+  if (!key_name.is_null()) {
+    ZS_COMPILER_RETURN_IF_ERROR(
+        add_stack_variable(key_name, &key_idx, vinfo.mask, vinfo.custom_mask, vinfo.is_const()),
+        "Duplicated local variable name ", key_name, ".\n");
   }
 
-  if (_token == tok_lex_error) {
-    last_lexer->_current_token = _lexer->_current_token;
-    last_lexer->_last_token = _lexer->_last_token;
-    _lexer = last_lexer;
-    return invalid;
-  }
+  ZS_COMPILER_RETURN_IF_ERROR(
+      add_stack_variable(value_name, &value_idx, vinfo.mask, vinfo.custom_mask, vinfo.is_const()),
+      "Duplicated local variable name ", value_name, ".\n");
 
-  last_lexer->_current_token = _lexer->_current_token;
-  last_lexer->_last_token = _lexer->_last_token;
-  _lexer = last_lexer;
-  _token = tok_rbracket;
+  add_instruction<op_foreach_prep>((u8)container_idx, (u8)iterator_idx);
 
-  //    lex();
-  // for(var i = 0; i < 10; i++)
-  //                           ^
-  ZS_COMPILER_EXPECT(tok_rbracket);
+  const size_t breaks_begin = _ccs->_unresolved_breaks.size();
+  const size_t continues_begin = _ccs->_unresolved_continues.size();
 
-  // This is the index of the instruction following the last instruction of the incr expr.
-  const int_t incr_expr_inst_end_idx = _ccs->get_next_instruction_index();
-  const int_t incr_expr_size = (incr_expr_inst_end_idx - incr_expr_inst_start_idx);
+  add_instruction<op_foreach_next>((u8)container_idx, (u8)iterator_idx, (u8)key_idx, (u8)value_idx, 0);
+  const int_t next_inst_idx = get_instruction_index();
 
-  // Here we want to copy the incr expr instructions in a buffer.
-  // And remove them from the instruction vector.
-  zs::vector<uint8_t> inst_buffer((zs::allocator<uint8_t>(_engine)));
-  if (incr_expr_size > 0) {
-    inst_buffer.resize(incr_expr_size);
-    ::memcpy(inst_buffer.data(), _ccs->_instructions._data.data(incr_expr_inst_start_idx), incr_expr_size);
-    _ccs->_instructions._data.resize(incr_expr_inst_start_idx);
-    _ccs->_last_instruction_index = cond_inst_last_idx;
+  for (int_t idx : { key_idx, value_idx }) {
+    if (idx == k_invalid_target) {
+      continue;
+    }
+
+    if (vinfo.has_custom_mask()) {
+      add_instruction<op_check_custom_type_mask>((u8)idx, vinfo.mask, vinfo.custom_mask);
+    }
+    else if (vinfo.has_mask()) {
+      add_instruction<op_check_type_mask>((u8)idx, vinfo.mask);
+    }
   }
 
   ZS_RETURN_IF_ERROR(parse_statement(true));
 
-  //        SQInteger expend = _fs->GetCurrentPos();
-  //        SQInteger expsize = (expend - expstart) + 1;
-  //        SQInstructionVec exp;
-  //        if (expsize > 0) {
-  //          for (SQInteger i = 0; i < expsize; i++)
-  //            exp.push_back(_fs->GetInstruction(expstart + i));
-  //          _fs->PopInstructions(expsize);
-  //        }
-  //        BEGIN_BREAKBLE_BLOCK()
-  //        Statement();
-  //  int_t continue_target = _ccs->get_instruction_index();
-
-  //  int_t end_block_index = -1;
-  if (incr_expr_size > 0) {
-    size_t sz = _ccs->_instructions._data.size();
-    _ccs->_instructions._data.resize(sz + incr_expr_size);
-    ::memcpy(_ccs->_instructions._data.data(sz), inst_buffer.data(), incr_expr_size);
-
-    // TODO: Fix this.
-    _ccs->_last_instruction_index = _ccs->_instructions._data.size();
-  }
+  // Jump back up to the `op_foreach_next` instruction.
+  add_instruction<op_jmp>((i32)(next_inst_idx - get_next_instruction_index()));
 
-  const int_t end_block_index = _ccs->get_next_instruction_index();
+  const int_t end_idx = get_next_instruction_index();
+  get_instruction_ref<op_foreach_next>(next_inst_idx).offset = (i32)(end_idx - next_inst_idx);
 
-  add_instruction<op_jmp>((int32_t)(cond_inst_start_idx - end_block_index));
+  if (_ccs->_unresolved_breaks.size() > breaks_begin) {
+    for (size_t i = breaks_begin; i < _ccs->_unresolved_breaks.size(); i++) {
+      const size_t idx = _ccs->_unresolved_breaks[i];
+      get_instruction_ref<op_jmp>(idx).offset = (i32)(end_idx - idx);
+    }
 
-  if (has_cond > 0) {
-    instruction_t<op_jz>* inst = (instruction_t<op_jz>*)(_ccs->_instructions._data.data(cond_inst_jz_idx));
-    inst->offset = (int32_t)(_ccs->get_next_instruction_index() - cond_inst_jz_idx);
+    _ccs->_unresolved_breaks.resize(breaks_begin);
   }
 
-  {
-    int_t previous_n_capture = _ccs->_n_capture;
-
-    if (_ccs->get_stack_size() != _scope.stack_size) {
-      _ccs->set_stack_size(_scope.stack_size);
-      if (previous_n_capture != (int_t)_ccs->_n_capture) {
-        add_instruction<op_close>((uint32_t)_scope.stack_size);
-      }
+  if (_ccs->_unresolved_continues.size() > continues_begin) {
+    for (size_t i = continues_begin; i < _ccs->_unresolved_continues.size(); i++) {
+      const size_t idx = _ccs->_unresolved_continues[i];
+      get_instruction_ref<op_jmp>(idx).offset = (i32)(next_inst_idx - idx);
     }
+
+    _ccs->_unresolved_continues.resize(continues_begin);
   }
 
-  //        _fs->AddInstruction(_OP_JMP, 0, jmppos - _fs->GetCurrentPos() - 1, 0);
-  //        if (jzpos > 0)
-  //          _fs->SetInstructionParam(jzpos, 1, _fs->GetCurrentPos() - jzpos);
-  //
-  //        END_BREAKBLE_BLOCK(continuetrg);
-  //
-  //        END_SCOPE();
   return {};
 }
 
@@ -1451,7 +1273,7 @@ zs::error_result jit_compiler::parse_for() {
 
     if (zs::status_result status = l.lex_for_auto(sp)) {
       ZS_ASSERT(sp.back() == tok_rbracket);
-      return parse_for_auto(sp);
+      return parse_for_auto();
     }
   }
 
@@ -1697,6 +1519,7 @@ zs::error_result jit_compiler::parse_prefixed() {
   zb_loop() {
     object name = pname;
     pname = nullptr;
+    _estate.struct_slot = -1;
 
     switch (_token) {
     case tok_double_colon: {
@@ -1721,7 +1544,8 @@ zs::error_result jit_compiler::parse_prefixed() {
       else if (needs_get()) {
         target_t key_idx = pop_target();
         target_t table_idx = pop_target();
-        add_new_target_instruction<op_get>(table_idx, key_idx, get_op_flags_t::gf_none);
+        add_new_target_instruction<op_get>(
+            table_idx, key_idx, get_op_flags_t::gf_none, _ccs->new_inline_cache());
         _estate.type = expr_type::e_object;
         _estate.pos = table_idx;
         _estate.no_assign = false;
@@ -1740,6 +1564,13 @@ zs::error_result jit_compiler::parse_prefixed() {
       lex();
       object var_name;
       ZS_COMPILER_EXPECT_GET(tok_identifier, var_name);
+
+      // A member of a local typed with a struct declared in this file
+      // (e.g. `var<Point> p; p.x = 2;`) is accessed by slot index.
+      const int_t slot = _estate.type == expr_type::e_local
+          ? _ccs->find_struct_slot(_ccs->top_target_type_info(), var_name)
+          : -1;
+
       add_string_instruction(var_name);
 
       if (is(tok_eq)) {
@@ -1752,11 +1583,20 @@ zs::error_result jit_compiler::parse_prefixed() {
         _estate.type = expr_type::e_object;
         _estate.pos = table_idx;
         _estate.no_assign = false;
+        _estate.struct_slot = slot;
       }
       else if (needs_get()) {
         target_t key_idx = pop_target();
         target_t table_idx = pop_target();
-        add_new_target_instruction<op_get>(table_idx, key_idx, get_op_flags_t::gf_none);
+
+        if (slot != -1) {
+          add_new_target_instruction<op_get_struct_slot>(table_idx, key_idx, (u16)slot);
+        }
+        else {
+          add_new_target_instruction<op_get>(
+              table_idx, key_idx, get_op_flags_t::gf_none, _ccs->new_inline_cache());
+        }
+
         _estate.type = expr_type::e_object;
         _estate.pos = table_idx;
         _estate.no_assign = false;
@@ -1801,7 +1641,8 @@ zs::error_result jit_compiler::parse_prefixed() {
           if (is_not(tok_eq) and needs_get()) {
             target_t key_idx = pop_target();
             target_t table_idx = pop_target();
-            add_new_target_instruction<op_get>(table_idx, key_idx, get_op_flags_t::gf_none);
+            add_new_target_instruction<op_get>(
+                table_idx, key_idx, get_op_flags_t::gf_none, _ccs->new_inline_cache());
             _estate.type = expr_type::e_object;
             _estate.pos = table_idx;
           }
@@ -1820,7 +1661,8 @@ zs::error_result jit_compiler::parse_prefixed() {
           if (is_not(tok_eq) and needs_get()) {
             target_t key_idx = pop_target();
             target_t table_idx = pop_target();
-            add_new_target_instruction<op_get>(table_idx, key_idx, get_op_flags_t::gf_none);
+            add_new_target_instruction<op_get>(
+                table_idx, key_idx, get_op_flags_t::gf_none, _ccs->new_inline_cache());
             _estate.type = expr_type::e_object;
             _estate.pos = table_idx;
           }
@@ -1841,7 +1683,8 @@ zs::error_result jit_compiler::parse_prefixed() {
           if (is_not(tok_eq) and needs_get()) {
             target_t key_idx = pop_target();
             target_t table_idx = pop_target();
-            add_new_target_instruction<op_get>(table_idx, key_idx, get_op_flags_t::gf_none);
+            add_new_target_instruction<op_get>(
+                table_idx, key_idx, get_op_flags_t::gf_none, _ccs->new_inline_cache());
             _estate.type = expr_type::e_object;
             _estate.pos = table_idx;
           }
@@ -1984,7 +1827,8 @@ auto jit_compiler::create_local_lambda<factor_identifier>() {
     if (needs_get()) {
       target_t key_idx = pop_target();
       target_t table_idx = pop_target();
-      add_new_target_instruction<op_get>(table_idx, key_idx, get_op_flags_t::gf_look_in_root);
+      add_new_target_instruction<op_get>(
+          table_idx, key_idx, get_op_flags_t::gf_look_in_root, _ccs->new_inline_cache());
       _estate.type = expr_type::e_object;
       _estate.pos = table_idx;
       _estate.no_new_set = false;
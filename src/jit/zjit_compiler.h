@@ -78,15 +78,15 @@ public:
 
   zs::error_result compile(std::string_view content, object filename, object& output,
       zs::virtual_machine* vm = nullptr, zs::token_type* prepended_token = nullptr, bool with_vargs = false,
-      bool add_line_info = true);
+      bool add_line_info = true, optimization_level opt_level = optimization_level::ol_peephole);
 
   template <class String>
     requires zb::is_string_view_convertible_v<String>
   ZS_CK_INLINE zs::error_result compile(std::string_view content, String&& filename, object& output,
       zs::virtual_machine* vm = nullptr, zs::token_type* prepended_token = nullptr, bool with_vargs = false,
-      bool add_line_info = true) {
-    return compile(
-        content, zs::_s(_engine, filename), output, vm, prepended_token, with_vargs, add_line_info);
+      bool add_line_info = true, optimization_level opt_level = optimization_level::ol_peephole) {
+    return compile(content, zs::_s(_engine, filename), output, vm, prepended_token, with_vargs, add_line_info,
+        opt_level);
   }
 
   ZS_CHECK zs::string get_error() const noexcept;
@@ -119,6 +119,9 @@ private:
 
     bool no_assign = false;
     bool no_new_set = false;
+
+    /// Member slot of an e_object assignment on a struct typed local (-1 if unknown).
+    int_t struct_slot = -1;
   };
 
   //
@@ -227,7 +230,7 @@ private:
   zs::error_result parse_function_call_args(bool table_call);
   zs::error_result parse_table();
   zs::error_result parse_for();
-  zs::error_result parse_for_auto(std::span<zs::token_type> sp);
+  zs::error_result parse_for_auto();
   zs::error_result parse_factor(object* name);
   zs::error_result parse_prefixed();
   zs::error_result parse_variable_declaration();
@@ -717,15 +717,16 @@ zs::object lexer::get_value() const noexcept {
   case tok_float_value:
     return _float_value;
   case tok_string_value:
-    return zs::_s(_engine, _string);
+    return zs::object::create_interned_string(_engine, _string);
   case tok_escaped_string_value:
-    return zs::_s(_engine, _escaped_string);
+    return zs::object::create_interned_string(_engine, _escaped_string);
   case tok_false:
     return zs::object(false);
   case tok_true:
     return zs::object(true);
   case tok_identifier:
-    return _is_string_view_identifier ? zs::_sv(_identifier) : zs::object(_engine, _identifier);
+    return _is_string_view_identifier ? zs::_sv(_identifier)
+                                      : zs::object::create_interned_string(_engine, _identifier);
   }
 
   return {};
@@ -97,7 +97,8 @@ public:
   ZS_CK_INLINE const zs::string& get_escaped_string_value() const noexcept { return _escaped_string; }
 
   ZS_CK_INLINE zs::object get_identifier() const noexcept {
-    return _is_string_view_identifier ? zs::_sv(_identifier) : zs::object(_engine, _identifier);
+    return _is_string_view_identifier ? zs::_sv(_identifier)
+                                      : zs::object::create_interned_string(_engine, _identifier);
   }
 
   ZS_CK_INLINE token_type current_token() const noexcept { return _current_token; }
@@ -126,7 +126,7 @@ static int_t function_delegate_instructions_size_impl(zs::vm_ref vm) {
     return -1;
   }
 
-  return vm.push(fct.as_closure().get_proto()._instructions._data.size());
+  return vm.push(fct.as_closure().get_proto()._instructions.size());
 }
 template <class T>
 static object create_inst_object(zs::engine* eng, const T& t) {
@@ -5,26 +5,26 @@
 namespace zs {
 namespace {
 
-  static_assert(std::is_trivially_destructible_v<zs::object_map::iterator>, "");
-  static_assert(std::is_trivially_copyable_v<zs::object_map::iterator>, "");
+  static_assert(std::is_trivially_destructible_v<zs::table_object::iterator>, "");
+  static_assert(std::is_trivially_copyable_v<zs::table_object::iterator>, "");
 
   struct table_iterator_ref {
 
     inline table_iterator_ref(object& obj)
         : pointer(obj._atom.table_it.get()) {}
 
-    zs::object_map::iterator& pointer;
+    zs::table_object::iterator& pointer;
 
     inline const object& key() const noexcept { return pointer->first; }
 
-    inline zs::object_map::iterator& ptr() const noexcept { return pointer; }
-    inline zs::object_map::iterator itptr() const noexcept { return pointer; }
+    inline zs::table_object::iterator& ptr() const noexcept { return pointer; }
+    inline zs::table_object::iterator itptr() const noexcept { return pointer; }
 
     inline bool operator==(const table_iterator_ref& it) const noexcept { return ptr() == it.ptr(); }
     inline bool operator!=(const table_iterator_ref& it) const noexcept { return ptr() != it.ptr(); }
   };
 
-  object create_table_iterator(zs::vm_ref vm, zs::object_map::iterator ptr);
+  object create_table_iterator(zs::vm_ref vm, zs::table_object::iterator ptr);
 
   inline object create_table_iterator(zs::vm_ref vm, table_iterator_ref it_ref) {
     return create_table_iterator(vm, it_ref.ptr());
@@ -90,7 +90,7 @@ namespace {
 
     tbl.emplace("next", [](vm_ref vm) -> int_t {
       table_iterator_ref it_ref(vm[0]);
-      return vm.push(create_table_iterator(vm, ++it_ref.itptr()));
+      return vm.push(create_table_iterator(vm, it_ref.itptr() + 1));
     });
 
     tbl.emplace("is_same",
@@ -123,7 +123,7 @@ namespace {
     return obj;
   }
 
-  object create_table_iterator(zs::vm_ref vm, zs::object_map::iterator ptr) {
+  object create_table_iterator(zs::vm_ref vm, zs::table_object::iterator ptr) {
     if (object& obj = vm->get_delegated_atom_delegates_table()
                           .as_table()[(int_t)constants::k_atom_table_iterator_delegate_id];
         !obj.is_table()) {
@@ -13,7 +13,9 @@ array_object* array_object::create(zs::engine* eng, int_t sz) noexcept {
   zb_placement_new(arr) array_object(eng);
 
   arr->_vec = (vector_type*)(arr->_data);
-  zb_placement_new(arr->_vec) vector_type(zs::allocator<object>(eng, memory_tag::nt_array));
+  // The elements are only allocated in the arena with the array.
+  const memory_tag storage_tag = (memory_tag)eng->get_storage_alloc_info(arr, memory_tag::nt_array);
+  zb_placement_new(arr->_vec) vector_type(zs::allocator<object>(eng, storage_tag));
 
   if (sz) {
     arr->_vec->resize(sz);
@@ -22,6 +22,10 @@ bool capture::is_capture(const object_base& obj) noexcept {
   return obj.is_user_data(&k_capture_udata_content);
 }
 
+bool capture::is_capture(const user_data_object& uobj) noexcept {
+  return uobj.get_content() == &k_capture_udata_content;
+}
+
 object capture::create(zs::engine* eng, object* ptr) noexcept {
   if (user_data_object* uobj = user_data_object::create(eng, sizeof(capture), &k_capture_udata_content)) {
     zb_placement_new((void*)uobj->data()) capture(ptr);
@@ -197,6 +197,11 @@ private:
 
 namespace zs {
 
+// Upper bounds checked when loading, a module that goes over them can't be saved.
+inline constexpr size_t k_max_serialized_string_size = 16 * 1024 * 1024;
+inline constexpr size_t k_max_serialized_count = 1024 * 1024;
+inline constexpr size_t k_max_serialized_instructions_size = 256 * 1024 * 1024;
+
 template <class Stream>
   requires Stream::is_serializer
 void serialize_string_object(Stream& stream, const object& obj, size_t max_size) {
@@ -259,16 +264,15 @@ void serialize_function_prototype_object(Stream& stream, object& obj) {
 }
 
 template <typename Stream>
-void serialize(Stream& stream, zs::line_info_op_t& o) {
-  stream.value8b(o.line);
-  stream.value8b(o.column);
-  stream.value8b(o.op_index);
-  stream.value1b(o.op);
+void serialize(Stream& stream, zs::line_table::entry& o) {
+  stream.value4b(o.op_index);
+  stream.value4b(o.line);
+  stream.value4b(o.column);
 }
 
 template <typename Stream>
 void serialize(Stream& stream, zs::local_var_info_t& o) {
-  serialize_string_object(stream, o.name, 100);
+  serialize_string_object(stream, o.name, k_max_serialized_string_size);
   stream.value8b(o.start_op);
   stream.value8b(o.end_op);
   stream.value8b(o.pos);
@@ -279,7 +283,7 @@ void serialize(Stream& stream, zs::local_var_info_t& o) {
 
 template <typename Stream>
 void serialize(Stream& stream, zs::captured_variable& o) {
-  serialize_string_object(stream, o.name, 100);
+  serialize_string_object(stream, o.name, k_max_serialized_string_size);
   stream.value8b(o.src);
   stream.value1b(o.type);
   stream.boolValue(o.is_weak);
@@ -288,35 +292,58 @@ void serialize(Stream& stream, zs::captured_variable& o) {
 template <typename Stream>
 void serialize(Stream& stream, zs::function_prototype_object& fpo) {
 
-  serialize_string_object(stream, fpo._source_name, 100);
-  serialize_string_object(stream, fpo._name, 100);
+  serialize_string_object(stream, fpo._source_name, k_max_serialized_string_size);
+  serialize_string_object(stream, fpo._name, k_max_serialized_string_size);
 
-  serialize_table_object(stream, fpo._module_info, 1024);
+  serialize_table_object(stream, fpo._module_info, k_max_serialized_string_size);
 
   stream.value8b(fpo._stack_size);
-  stream.container(fpo._vlocals, 100);
+  stream.container(fpo._vlocals, k_max_serialized_count);
+
+  if constexpr (Stream::is_serializer) {
+    fpo.load_mapped_literals();
+  }
+
+  stream.container(fpo._literals, k_max_serialized_count, [](Stream& stream, zs::object& obj) {
+    serialize_string_object(stream, obj, k_max_serialized_string_size);
+  });
 
-  stream.container(
-      fpo._literals, 100, [](Stream& stream, zs::object& obj) { serialize_string_object(stream, obj, 100); });
+  stream.container(fpo._default_params, k_max_serialized_count,
+      [](Stream& stream, zs::int_t& val) { stream.value8b(val); });
 
-  stream.container(fpo._default_params, 100, [](Stream& stream, zs::int_t& val) { stream.value8b(val); });
+  stream.container(fpo._parameter_names, k_max_serialized_count, [](Stream& stream, zs::object& obj) {
+    serialize_string_object(stream, obj, k_max_serialized_string_size);
+  });
 
-  stream.container(fpo._parameter_names, 100,
-      [](Stream& stream, zs::object& obj) { serialize_string_object(stream, obj, 100); });
+  stream.container(fpo._restricted_types, k_max_serialized_count, [](Stream& stream, zs::object& obj) {
+    serialize_string_object(stream, obj, k_max_serialized_string_size);
+  });
 
-  stream.container(fpo._restricted_types, 100,
-      [](Stream& stream, zs::object& obj) { serialize_string_object(stream, obj, 100); });
+  stream.boolValue(fpo._has_vargs_params);
 
-  stream.container(fpo._captures, 100);
+  stream.container(fpo._captures, k_max_serialized_count);
 
   stream.value8b(fpo._n_capture);
   //  stream.value8b(fpo._export_table_target);
-  stream.container(fpo._line_info, 100);
+  stream.container(fpo._line_info._entries, k_max_serialized_count);
 
-  stream.container(fpo._functions, 20,
+  stream.container(fpo._functions, k_max_serialized_count,
       [](Stream& stream, zs::object& obj) { serialize_function_prototype_object(stream, obj); });
 
-  stream.container1b(fpo._instructions._data, 1000);
+  if constexpr (Stream::is_serializer) {
+    if (fpo._instructions.has_external_data()) {
+      zs::vector<uint8_t> data(fpo._instructions.begin().data(), fpo._instructions.end().data(),
+          zs::allocator<uint8_t>(fpo.get_engine()));
+      stream.container1b(data, k_max_serialized_instructions_size);
+      return;
+    }
+  }
+
+  stream.container1b(fpo._instructions._data, k_max_serialized_instructions_size);
+
+  if constexpr (!Stream::is_serializer) {
+    fpo.reset_inline_caches();
+  }
 }
 
 } // namespace zs.
@@ -354,14 +381,14 @@ function_prototype_object::function_prototype_object(zs::engine* eng)
     , _restricted_types(zs::allocator<zs::object>(eng))
     , _functions(zs::allocator<zs::object>(eng))
     , _captures(zs::allocator<zs::captured_variable>(eng))
-    , _line_info(zs::allocator<zs::line_info_op_t>(eng))
+    , _line_info(eng)
 
 #if ZS_DEBUG
     , _debug_line_info(zs::allocator<zs::line_info_op_t>(eng))
 #endif
 
-    , _instructions(eng) {
-}
+    , _instructions(eng)
+    , _inline_caches(zs::allocator<zs::inline_cache>(eng)) {}
 
 object function_prototype_object::create(zs::engine* eng) {
   if (user_data_object* uobj
@@ -376,8 +403,60 @@ object function_prototype_object::create(zs::engine* eng) {
   return nullptr;
 }
 
+object function_prototype_object::create_mapped_literal(size_t idx) const {
+  const mapped_string& str = _mapped_literals[idx];
+  return zs::_s(_engine, std::string_view(_mapped_strings + str.offset, str.size));
+}
+
+void function_prototype_object::load_mapped_literals() {
+  if (!_mapped_literals) {
+    return;
+  }
+
+  for (size_t i = 0; i < _literals.size(); i++) {
+    (void)get_literal(i);
+  }
+}
+
 int_t function_prototype_object::get_parameters_count() const noexcept { return _parameter_names.size(); }
 
+void function_prototype_object::reset_inline_caches() {
+  using enum opcode;
+
+  size_t n_caches = 0;
+
+  const auto update_count = [&](uint16_t cache_idx) {
+    if (cache_idx != k_invalid_inline_cache) {
+      n_caches = zb::maximum(n_caches, (size_t)cache_idx + 1);
+    }
+  };
+
+  for (auto it = _instructions.begin(); it != _instructions.end(); ++it) {
+    switch (it.get_opcode()) {
+    case op_get:
+      update_count(it.get_ref<op_get>().cache_idx);
+      break;
+    case op_set:
+      update_count(it.get_ref<op_set>().cache_idx);
+      break;
+    case op_get_method:
+      update_count(it.get_ref<op_get_method>().cache_idx);
+      break;
+    default:
+      break;
+    }
+  }
+
+  _inline_caches.clear();
+  _inline_caches.resize(n_caches);
+}
+
+void function_prototype_object::clear_inline_caches() noexcept {
+  for (inline_cache& cache : _inline_caches) {
+    cache.clear();
+  }
+}
+
 int_t function_prototype_object::get_default_parameters_count() const noexcept {
   return _default_params.size();
 }
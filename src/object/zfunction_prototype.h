@@ -24,6 +24,8 @@
 
 #include <zscript/zscript.h>
 #include "jit/zclosure_compile_state.h"
+#include "bytecode/zline_table.h"
+#include "bytecode/zmapped_module.h"
 #include <zscript/base/container/byte.h>
 
 namespace zs {
@@ -66,9 +68,33 @@ public:
   bool is_valid_parameters(zs::vm_ref vm, zb::span<const object> params, int_t& n_type_match) const noexcept;
   ZS_CK_INLINE bool has_variadic_parameters() const noexcept { return _has_vargs_params; }
 
+  /// Returns the literal at `idx`.
+  /// The literals of a mapped module are only created on first use.
+  ZS_CK_INLINE const object& get_literal(size_t idx) {
+    object& lit = _literals[idx];
+
+    if (ZBASE_UNLIKELY(_mapped_literals != nullptr) and lit.is_null()) {
+      lit = create_mapped_literal(idx);
+    }
+
+    return lit;
+  }
+
+  /// Creates all the literals that were not used yet (see `get_literal()`).
+  void load_mapped_literals();
+
+  /// Resize the inline caches to match the `cache_idx` of all `op_get`, `op_get_method`
+  /// and `op_set` instructions and clear their content.
+  void reset_inline_caches();
+
+  /// Clear the content of the inline caches, the entries keep their keys alive.
+  void clear_inline_caches() noexcept;
+
 private:
   function_prototype_object(zs::engine* eng);
 
+  object create_mapped_literal(size_t idx) const;
+
 public:
   zs::object _source_name;
   zs::object _name;
@@ -86,13 +112,22 @@ public:
   size_t _n_capture = 0;
 
   // Line infos.
-  zs::vector<zs::line_info_op_t> _line_info;
+  zs::line_table _line_info;
 
 #if ZS_DEBUG
   zs::vector<zs::line_info_op_t> _debug_line_info;
 #endif
 
   zs::instruction_vector _instructions;
+
+  /// Inline caches used by `op_get`, `op_get_method` and `op_set` (indexed by `cache_idx`).
+  zs::vector<zs::inline_cache> _inline_caches;
+
+  /// Set when loaded with `load_mapped_module()`.
+  /// Keeps the file mapped while `_instructions` and `_mapped_literals` point into it.
+  zs::object _mapped_module;
+  const mapped_string* _mapped_literals = nullptr;
+  const char* _mapped_strings = nullptr;
 };
 
 } // namespace zs.
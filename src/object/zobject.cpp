@@ -67,6 +67,17 @@ object& object::operator=(object&& obj) {
   return *this;
 }
 
+object object::create_interned_string(zs::engine* eng, std::string_view s) {
+  if (s.size() <= constants::k_small_string_max_size or s.size() > constants::k_max_interned_string_size) {
+    return object(eng, s);
+  }
+
+  object obj;
+  obj._type = k_long_string;
+  obj._lstring = string_object::create_interned(eng, s);
+  return obj;
+}
+
 object object::create_concat_string(zs::engine* eng, std::string_view s1, std::string_view s2) {
   size_t sz = s1.size() + s2.size();
 
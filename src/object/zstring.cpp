@@ -14,6 +14,21 @@ string_object* string_object::create(zs::engine* eng, std::string_view s) {
   return sobj;
 }
 
+string_object* string_object::create_interned(zs::engine* eng, std::string_view s) {
+  auto& interned_strings = eng->_interned_strings;
+
+  if (auto it = interned_strings.find(s); it != interned_strings.end()) {
+    string_object* sobj = *it;
+    sobj->retain();
+    return sobj;
+  }
+
+  string_object* sobj = string_object::create(eng, s);
+  sobj->_interned = true;
+  interned_strings.insert(sobj);
+  return sobj;
+}
+
 string_object* string_object::create(zs::engine* eng, size_t n) {
   string_object* sobj
       = (string_object*)eng->allocate(sizeof(string_object) + n, (alloc_info_t)memory_tag::nt_string);
@@ -26,6 +41,10 @@ string_object* string_object::create(zs::engine* eng, size_t n) {
 void string_object::destroy_callback(zs::engine* eng, reference_counted_object* obj) noexcept {
   string_object* sobj = (string_object*)obj;
 
+  if (sobj->_interned) {
+    eng->_interned_strings.erase(sobj);
+  }
+
   zs_delete(eng, sobj);
 }
 
@@ -5,6 +5,7 @@ namespace zs {
 struct_object::struct_object(zs::engine* eng) noexcept
     : zs::reference_counted_object(eng, object_type::k_struct)
     , vector_type(zs::allocator<struct_item>(eng))
+    , _version(eng->new_version_tag())
     , _statics(zs::allocator<struct_item>(eng))
     , _methods(zs::allocator<struct_method>(eng)) {}
 
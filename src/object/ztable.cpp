@@ -3,9 +3,194 @@
 
 namespace zs {
 
+//
+// MARK: table_map.
+//
+
+table_map::table_map(zs::engine* eng) noexcept
+    : _engine(eng)
+    , _data((value_type*)_inline_data) {}
+
+table_map::~table_map() noexcept {
+  for (size_type i = 0; i < _size; i++) {
+    _data[i].~value_type();
+  }
+
+  if (!is_inline()) {
+    _engine->deallocate(_data, (alloc_info_t)memory_tag::nt_table);
+  }
+
+  release_index();
+}
+
+table_map& table_map::operator=(const table_map& m) noexcept {
+  if (this == &m) {
+    return *this;
+  }
+
+  clear();
+  reserve(m.size());
+
+  for (const value_type& p : m) {
+    push_back(p.first, p.second);
+  }
+
+  return *this;
+}
+
+void table_map::reserve(size_type n) noexcept {
+  if (n > _capacity) {
+    relocate(allocate_data(n), n);
+  }
+
+  if (n > k_small_size and (!_index or n * 2 > _index_mask + 1)) {
+    rebuild_index(n * 2);
+  }
+}
+
+void table_map::clear() noexcept {
+  for (size_type i = 0; i < _size; i++) {
+    _data[i].~value_type();
+  }
+
+  _size = 0;
+  release_index();
+}
+
+bool table_map::operator==(const table_map& m) const noexcept {
+  if (_size != m._size) {
+    return false;
+  }
+
+  for (const value_type& p : *this) {
+    const size_type idx = m.find_index(p.first);
+    if (idx == npos or !(m._data[idx].second == p.second)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+table_map::value_type* table_map::allocate_data(size_type n) noexcept {
+  return (value_type*)_engine->allocate(
+      n * sizeof(value_type), _engine->get_storage_alloc_info(this, memory_tag::nt_table));
+}
+
+void table_map::relocate(value_type* data, size_type n) noexcept {
+  for (size_type i = 0; i < _size; i++) {
+    zb_placement_new(data + i)
+        value_type(std::move(const_cast<object&>(_data[i].first)), std::move(_data[i].second));
+    _data[i].~value_type();
+  }
+
+  if (!is_inline()) {
+    _engine->deallocate(_data, (alloc_info_t)memory_tag::nt_table);
+  }
+
+  _data = data;
+  _capacity = (uint32_t)n;
+}
+
+void table_map::rebuild_index(size_type n) noexcept {
+  release_index();
+
+  size_type index_capacity = 16;
+  while (index_capacity < n) {
+    index_capacity *= 2;
+  }
+
+  _index = (index_slot*)_engine->allocate(
+      index_capacity * sizeof(index_slot), _engine->get_storage_alloc_info(this, memory_tag::nt_table));
+  zb::memset(_index, 0, index_capacity * sizeof(index_slot));
+  _index_mask = index_capacity - 1;
+
+  for (size_type i = 0; i < _size; i++) {
+    insert_index_slot(i);
+  }
+}
+
+void table_map::insert_index_slot(size_type idx) noexcept {
+  const uint32_t tag = hash_tag(hasher{}(_data[idx].first));
+
+  size_t pos = tag & _index_mask;
+  while (_index[pos].index) {
+    pos = (pos + 1) & _index_mask;
+  }
+
+  _index[pos] = { (uint32_t)idx + 1, tag };
+}
+
+void table_map::erase_index(size_type idx) noexcept {
+  const size_type last = _size - 1;
+
+  if (_index) {
+    // Find the slot of `idx` and remove it by shifting back the following slots
+    // of the cluster.
+    size_t hole = hash_tag(hasher{}(_data[idx].first)) & _index_mask;
+    while (_index[hole].index != idx + 1) {
+      hole = (hole + 1) & _index_mask;
+    }
+
+    for (size_t pos = (hole + 1) & _index_mask; _index[pos].index; pos = (pos + 1) & _index_mask) {
+      const size_t ideal = _index[pos].tag & _index_mask;
+
+      // The slot can stay where it is if its ideal position is in (hole, pos].
+      const bool stays = hole <= pos ? (hole < ideal and ideal <= pos) : (hole < ideal or ideal <= pos);
+
+      if (!stays) {
+        _index[hole] = _index[pos];
+        hole = pos;
+      }
+    }
+
+    _index[hole] = {};
+
+    // The last pair is moved to `idx`.
+    if (idx != last) {
+      size_t pos = hash_tag(hasher{}(_data[last].first)) & _index_mask;
+      while (_index[pos].index != last + 1) {
+        pos = (pos + 1) & _index_mask;
+      }
+
+      _index[pos].index = (uint32_t)idx + 1;
+    }
+  }
+
+  _data[idx].~value_type();
+
+  if (idx != last) {
+    zb_placement_new(_data + idx)
+        value_type(std::move(const_cast<object&>(_data[last].first)), std::move(_data[last].second));
+    _data[last].~value_type();
+  }
+
+  _size--;
+}
+
+void table_map::release_index() noexcept {
+  if (_index) {
+    _engine->deallocate(_index, (alloc_info_t)memory_tag::nt_table);
+    _index = nullptr;
+    _index_mask = 0;
+  }
+}
+
+//
+// MARK: table_object.
+//
+
 table_object::table_object(zs::engine* eng)
     : delegable_object(eng, object_type::k_table)
-    , _map(nullptr) {}
+    , _map(nullptr)
+    , _version(eng->new_version_tag())
+    , _meta_method_known_mask(0)
+    , _meta_method_mask(0) {}
+
+void table_object::update_version() noexcept {
+  _version = get_engine()->new_version_tag();
+  _meta_method_known_mask = 0;
+}
 
 table_object* table_object::create(zs::engine* eng) noexcept {
 
@@ -14,8 +199,7 @@ table_object* table_object::create(zs::engine* eng) noexcept {
   zb_placement_new(tbl) table_object(eng);
 
   tbl->_map = (map_type*)(tbl->_data);
-  zb_placement_new(tbl->_map)
-      map_type((zs::unordered_map_allocator<object, object>(eng, zs::memory_tag::nt_table)));
+  zb_placement_new(tbl->_map) map_type(eng);
 
   return tbl;
 }
@@ -54,6 +238,20 @@ zs::error_result table_object::get(const object& key, object& dst) const noexcep
   return errc::not_found;
 }
 
+const zs::object* table_object::get_meta_method(meta_method mt) const noexcept {
+  static_assert((size_t)meta_method::count <= 64, "the meta methods don't fit in the masks");
+  const uint64_t bit = uint64_t(1) << (uint32_t)mt;
+
+  if (_meta_method_known_mask & bit) {
+    return (_meta_method_mask & bit) ? get(zs::get_meta_method_name_object(mt)) : nullptr;
+  }
+
+  const zs::object* value = get(zs::get_meta_method_name_object(mt));
+  _meta_method_known_mask |= bit;
+  _meta_method_mask = value ? (_meta_method_mask | bit) : (_meta_method_mask & ~bit);
+  return value;
+}
+
 bool table_object::contains_all(const table_object& tbl) const noexcept {
   for (const auto& item : tbl) {
     if (!this->contains(item.first)) {
@@ -65,7 +263,10 @@ bool table_object::contains_all(const table_object& tbl) const noexcept {
 }
 
 zs::error_result table_object::erase(const object& key) noexcept {
-  _map->erase(key);
+  if (_map->erase(key)) {
+    update_version();
+  }
+
   return {};
 }
 
@@ -0,0 +1,391 @@
+#include <zscript/zscript.h>
+#include <zscript/std/zbytes.h>
+#include "zvirtual_machine.h"
+#include "utility/zparameter_stream.h"
+#include <zscript/base/sys/file_view.h>
+#include <bit>
+#include <filesystem>
+
+namespace zs {
+namespace {
+  zs::object& get_bytes_delegate(zs::engine* eng);
+
+  namespace bytes_lib {
+    inline constexpr object uid = _sv("__bytes_object__");
+    inline constexpr object reg_id = _sv("__bytes_delegate__");
+
+    /// Negative indices start from the end, the range is clipped to [0, size].
+    inline void clip_range(int_t& begin, int_t& end, size_t size) noexcept {
+      begin = begin < 0 ? zb::maximum(begin + (int_t)size, (int_t)0) : zb::minimum(begin, (int_t)size);
+      end = end < 0 ? zb::maximum(end + (int_t)size, (int_t)0) : zb::minimum(end, (int_t)size);
+      end = zb::maximum(begin, end);
+    }
+
+    template <class T>
+    using unsigned_type = std::conditional_t<sizeof(T) == 1, uint8_t,
+        std::conditional_t<sizeof(T) == 2, uint16_t, std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>>>;
+
+    template <class T>
+    inline T load(const uint8_t* ptr, bool big_endian) noexcept {
+      unsigned_type<T> value;
+      ::memcpy(&value, ptr, sizeof(value));
+
+      if constexpr (sizeof(T) > 1) {
+        if (big_endian != (std::endian::native == std::endian::big)) {
+          value = std::byteswap(value);
+        }
+      }
+
+      return std::bit_cast<T>(value);
+    }
+
+    object create(zs::vm_ref vm, const object& storage, const uint8_t* data, size_t size) noexcept {
+      zs::engine* eng = vm.get_engine();
+
+      user_data_object* uobj = user_data_object::create<bytes>(eng, bytes{ storage, data, size });
+      if (!uobj) {
+        return nullptr;
+      }
+
+      uobj->set_uid(uid);
+      uobj->set_type_id(uid);
+      uobj->set_delegate(get_bytes_delegate(eng));
+
+      uobj->set_to_string_callback([](const object_base& obj, std::ostream& stream) -> zs::error_result {
+        stream << "bytes(" << obj.as_udata().data_ref<bytes>().size << ")";
+        return {};
+      });
+
+      return zs::object(uobj, false);
+    }
+  } // namespace bytes_lib
+
+  int_t bytes_size_impl(zs::vm_ref vm) noexcept {
+    zs::parameter_stream ps(vm);
+    bytes* b = nullptr;
+    ZS_RETURN_IF_ERROR(ps.require<bytes_parameter>(b), -1);
+    return vm.push((int_t)b->size);
+  }
+
+  int_t bytes_is_mapped_impl(zs::vm_ref vm) noexcept {
+    zs::parameter_stream ps(vm);
+    bytes* b = nullptr;
+    ZS_RETURN_IF_ERROR(ps.require<bytes_parameter>(b), -1);
+    return vm.push_bool(b->storage.as_udata().get_uid() == zs::_sv("mapped"));
+  }
+
+  // vm[0] should be the bytes.
+  // vm[1] should be the key.
+  int_t bytes_meta_get_impl(zs::vm_ref vm) noexcept {
+    zs::parameter_stream ps(vm);
+
+    bytes* b = nullptr;
+    ZS_RETURN_IF_ERROR(ps.require<bytes_parameter>(b), -1);
+
+    int_t index = 0;
+    ZS_RETURN_IF_ERROR(ps.optional<integer_parameter>(index), vm.push(zs::none()));
+
+    if (index < 0) {
+      index += b->size;
+    }
+
+    if (index < 0 or index >= (int_t)b->size) {
+      vm.set_error("Out of bounds.");
+      return -1;
+    }
+
+    return vm.push((int_t)b->data[index]);
+  }
+
+  /// slice(begin, end = size), shares the memory of the bytes.
+  int_t bytes_slice_impl(zs::vm_ref vm) noexcept {
+    zs::parameter_stream ps(vm);
+
+    bytes* b = nullptr;
+    ZS_RETURN_IF_ERROR(ps.require<bytes_parameter>(b), -1);
+
+    int_t begin = 0;
+    ZS_RETURN_IF_ERROR(ps.require<integer_parameter>(begin), -1);
+
+    int_t end = b->size;
+    ZS_RETURN_IF_ERROR(ps.require_if_valid<integer_parameter>(end), -1);
+
+    bytes_lib::clip_range(begin, end, b->size);
+
+    object result = bytes_lib::create(vm, b->storage, b->data + begin, end - begin);
+    if (result.is_null()) {
+      vm.set_error("Out of memory.");
+      return -1;
+    }
+
+    return vm.push(std::move(result));
+  }
+
+  /// to_string(begin = 0, end = size), copies the bytes in a string.
+  /// A string owns its characters, `slice()` is the way to share the memory.
+  int_t bytes_to_string_impl(zs::vm_ref vm) noexcept {
+    zs::parameter_stream ps(vm);
+
+    bytes* b = nullptr;
+    ZS_RETURN_IF_ERROR(ps.require<bytes_parameter>(b), -1);
+
+    int_t begin = 0;
+    ZS_RETURN_IF_ERROR(ps.require_if_valid<integer_parameter>(begin), -1);
+
+    int_t end = b->size;
+    ZS_RETURN_IF_ERROR(ps.require_if_valid<integer_parameter>(end), -1);
+
+    bytes_lib::clip_range(begin, end, b->size);
+    return vm.push_string(std::string_view((const char*)b->data + begin, end - begin));
+  }
+
+  /// find(needle, start = 0), the needle is a string, bytes or a byte value.
+  /// Returns the index of the first match or -1.
+  int_t bytes_find_impl(zs::vm_ref vm) noexcept {
+    zs::parameter_stream ps(vm);
+
+    bytes* b = nullptr;
+    ZS_RETURN_IF_ERROR(ps.require<bytes_parameter>(b), -1);
+
+    std::string_view needle;
+    uint8_t byte_value = 0;
+
+    if (!ps.is_valid()) {
+      vm.set_error("Missing needle in bytes.find(needle, start).");
+      return -1;
+    }
+
+    if (ps->is_string()) {
+      needle = ps++->get_string_unchecked();
+    }
+    else if (ps->is_integer() and ps->_int >= 0 and ps->_int <= 255) {
+      byte_value = (uint8_t)ps++->_int;
+      needle = std::string_view((const char*)&byte_value, 1);
+    }
+    else if (bytes* other = nullptr; !ps.check<bytes_parameter>(false, other)) {
+      needle = std::string_view((const char*)other->data, other->size);
+    }
+    else {
+      vm.set_error("Invalid needle in bytes.find(needle, start).");
+      return -1;
+    }
+
+    int_t start = 0;
+    ZS_RETURN_IF_ERROR(ps.require_if_valid<integer_parameter>(start), -1);
+
+    int_t end = b->size;
+    bytes_lib::clip_range(start, end, b->size);
+
+    const std::string_view content((const char*)b->data, b->size);
+    const size_t index = content.find(needle, start);
+    return vm.push(index == std::string_view::npos ? (int_t)-1 : (int_t)index);
+  }
+
+  /// u8(offset), u16(offset, big_endian = false), ...
+  /// A u64 above the int_t range is returned as a float.
+  template <class T>
+  int_t bytes_read_impl(zs::vm_ref vm) noexcept {
+    zs::parameter_stream ps(vm);
+
+    bytes* b = nullptr;
+    ZS_RETURN_IF_ERROR(ps.require<bytes_parameter>(b), -1);
+
+    int_t offset = 0;
+    ZS_RETURN_IF_ERROR(ps.require<integer_parameter>(offset), -1);
+
+    const bool big_endian = ps.is_valid() and ps->is_if_true();
+
+    if (offset < 0 or (size_t)offset > b->size or sizeof(T) > b->size - (size_t)offset) {
+      vm.set_error("Out of bounds.");
+      return -1;
+    }
+
+    const T value = bytes_lib::load<T>(b->data + offset, big_endian);
+
+    if constexpr (std::is_floating_point_v<T>) {
+      return vm.push((float_t)value);
+    }
+    else if constexpr (std::is_same_v<T, uint64_t>) {
+      // Above INT64_MAX, the bit pattern is reinterpreted as a two's complement int_t (same as i64).
+      return vm.push(std::bit_cast<int_t>(value));
+    }
+    else {
+      return vm.push((int_t)value);
+    }
+  }
+
+  zs::object create_bytes_delegate(zs::engine* eng) {
+    using namespace literals;
+
+    table_object* tbl = table_object::create(eng);
+    tbl->reserve(20);
+
+    tbl->emplace(constants::get<meta_method::mt_typeof>(), "bytes"_ss);
+    tbl->emplace(constants::get<meta_method::mt_get>(), bytes_meta_get_impl);
+
+    tbl->emplace("size"_ss, bytes_size_impl);
+    tbl->emplace("is_mapped"_ss, bytes_is_mapped_impl);
+    tbl->emplace("slice"_ss, bytes_slice_impl);
+    tbl->emplace("to_string"_ss, bytes_to_string_impl);
+    tbl->emplace("find"_ss, bytes_find_impl);
+
+    tbl->emplace("u8"_ss, bytes_read_impl<uint8_t>);
+    tbl->emplace("i8"_ss, bytes_read_impl<int8_t>);
+    tbl->emplace("u16"_ss, bytes_read_impl<uint16_t>);
+    tbl->emplace("i16"_ss, bytes_read_impl<int16_t>);
+    tbl->emplace("u32"_ss, bytes_read_impl<uint32_t>);
+    tbl->emplace("i32"_ss, bytes_read_impl<int32_t>);
+    tbl->emplace("u64"_ss, bytes_read_impl<uint64_t>);
+    tbl->emplace("i64"_ss, bytes_read_impl<int64_t>);
+    tbl->emplace("f32"_ss, bytes_read_impl<float>);
+    tbl->emplace("f64"_ss, bytes_read_impl<double>);
+
+    tbl->set_no_default_none();
+    return object(tbl, false);
+  }
+
+  zs::object& get_bytes_delegate(zs::engine* eng) {
+    object& obj = eng->get_registry_table_object()[bytes_lib::reg_id];
+    return obj.is_table() ? obj : (obj = create_bytes_delegate(eng));
+  }
+} // namespace
+
+bytes& bytes::as_bytes(const object& obj) noexcept { return obj.as_udata().data_ref<bytes>(); }
+
+bool is_bytes(const object& obj) noexcept {
+  return obj.is_user_data() and obj.as_udata().get_uid() == bytes_lib::uid;
+}
+
+zs::error_result bytes_parameter::parse(zs::parameter_stream& s, bool output_error, bytes*& value) {
+
+  if (s.is_user_data_with_uid(bytes_lib::uid)) {
+    value = s++->as_udata().data<bytes>();
+    return {};
+  }
+
+  s.set_opt_error(output_error, "Invalid bytes type.");
+  return zs::errc::invalid_parameter_type;
+}
+
+object create_bytes(zs::vm_ref vm, size_t size) noexcept {
+  zs::engine* eng = vm.get_engine();
+
+  user_data_object* uobj
+      = user_data_object::create<zs::vector<uint8_t>>(eng, size, (uint8_t)0, zs::allocator<uint8_t>(eng));
+  if (!uobj) {
+    return nullptr;
+  }
+
+  uobj->set_uid(zs::_sv("owned"));
+
+  const zs::vector<uint8_t>& data = uobj->data_ref<zs::vector<uint8_t>>();
+  return bytes_lib::create(vm, zs::object(uobj, false), data.data(), data.size());
+}
+
+object create_bytes(zs::vm_ref vm, zb::byte_view content) noexcept {
+  object obj = create_bytes(vm, content.size());
+
+  if (!obj.is_null() and !content.empty()) {
+    ::memcpy((uint8_t*)bytes::as_bytes(obj).data, content.data(), content.size());
+  }
+
+  return obj;
+}
+
+object create_mapped_bytes(zs::vm_ref vm, const char* path) noexcept {
+  zs::engine* eng = vm.get_engine();
+
+  zb::file_view fview;
+  if (auto err = fview.open(path)) {
+    // Empty files can't be mapped.
+    std::error_code ec;
+    if (std::filesystem::is_regular_file(path, ec) and std::filesystem::file_size(path, ec) == 0 and !ec) {
+      return create_bytes(vm, (size_t)0);
+    }
+
+    return nullptr;
+  }
+
+  const uint8_t* data = fview.data();
+  const size_t size = fview.size();
+
+  user_data_object* uobj = user_data_object::create<zb::file_view>(eng, std::move(fview));
+  if (!uobj) {
+    return nullptr;
+  }
+
+  uobj->set_uid(zs::_sv("mapped"));
+
+  return bytes_lib::create(vm, zs::object(uobj, false), data, size);
+}
+
+int_t vm_create_bytes(zs::vm_ref vm) {
+  zs::parameter_stream ps(vm);
+  ++ps;
+
+  if (ps.size() != 1) {
+    vm.set_error("Invalid parameters, expected bytes(size), bytes(string) or bytes(array).");
+    return -1;
+  }
+
+  const object& obj = *ps;
+
+  if (obj.is_integer()) {
+    if (obj._int < 0) {
+      vm.set_error("Invalid negative size in bytes(size).");
+      return -1;
+    }
+
+    if ((uint64_t)obj._int > constants::k_max_bytes_size) {
+      vm.set_error("Invalid size in bytes(size), too large.");
+      return -1;
+    }
+
+    object result = create_bytes(vm, (size_t)obj._int);
+    if (result.is_null()) {
+      vm.set_error("Out of memory.");
+      return -1;
+    }
+
+    return vm.push(std::move(result));
+  }
+
+  if (obj.is_string()) {
+    const std::string_view str = obj.get_string_unchecked();
+
+    object result = create_bytes(vm, zb::byte_view((const uint8_t*)str.data(), str.size()));
+    if (result.is_null()) {
+      vm.set_error("Out of memory.");
+      return -1;
+    }
+
+    return vm.push(std::move(result));
+  }
+
+  if (obj.is_array()) {
+    const array_object& arr = obj.as_array();
+    object result = create_bytes(vm, (size_t)arr.size());
+    if (result.is_null()) {
+      vm.set_error("Out of memory.");
+      return -1;
+    }
+
+    uint8_t* data = (uint8_t*)bytes::as_bytes(result).data;
+
+    for (size_t i = 0; i < arr.size(); i++) {
+      if (!arr[i].is_integer() or arr[i]._int < 0 or arr[i]._int > 255) {
+        vm.set_error("Invalid byte value in bytes(array).");
+        return -1;
+      }
+
+      data[i] = (uint8_t)arr[i]._int;
+    }
+
+    return vm.push(result);
+  }
+
+  vm.set_error("Invalid parameters, expected bytes(size), bytes(string) or bytes(array).");
+  return -1;
+}
+
+} // namespace zs.
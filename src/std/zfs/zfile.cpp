@@ -1,10 +1,13 @@
 #include "zfile.h"
 #include "zvirtual_machine.h"
+#include <zscript/base/sys/file_view.h>
+#include <filesystem>
 
 namespace zs::file_library {
 
 zfile::zfile(zs::engine* eng, std::string_view filepath, int_t openmode)
-    : path(filepath, zs::allocator<char>(eng)) {
+    : path(filepath, zs::allocator<char>(eng))
+    , read_buffer(zs::allocator<char>(eng)) {
 
   std::ios::openmode omode = {};
   omode |= (openmode & open_mode_append) ? std::ios::app : 0;
@@ -16,6 +19,113 @@ zfile::zfile(zs::engine* eng, std::string_view filepath, int_t openmode)
   stream.open(path.c_str(), omode);
 }
 
+// Same as the `std::fstream >> std::string` delimiters.
+static inline bool is_word_space(char c) noexcept { return std::isspace((unsigned char)c); }
+
+bool zfile::fill(size_t n) {
+  const size_t count = available();
+  if (count >= n) {
+    return true;
+  }
+
+  if (!stream.good()) {
+    return false;
+  }
+
+  // Moves the unread bytes to the front.
+  if (read_begin) {
+    ::memmove(read_buffer.data(), unread_data(), count);
+    read_begin = 0;
+    read_end = count;
+  }
+
+  if (n > read_buffer.size()) {
+    read_buffer.resize(zb::maximum(n, k_read_buffer_size, read_buffer.size() * 2));
+  }
+
+  stream.read(read_buffer.data() + read_end, read_buffer.size() - read_end);
+  read_end += (size_t)stream.gcount();
+  return available() > count;
+}
+
+std::string_view zfile::read(size_t n) {
+  fill(n);
+
+  const std::string_view data(unread_data(), zb::minimum(n, available()));
+  read_begin += data.size();
+  return data;
+}
+
+bool zfile::read_line(std::string_view& line) {
+  size_t searched = 0;
+
+  while (true) {
+    if (const char* nl = (const char*)::memchr(unread_data() + searched, '\n', available() - searched)) {
+      size_t size = nl - unread_data();
+      line = std::string_view(unread_data(), size > 0 and nl[-1] == '\r' ? size - 1 : size);
+      read_begin += size + 1;
+      return true;
+    }
+
+    searched = available();
+
+    if (!fill(searched + 1)) {
+      break;
+    }
+  }
+
+  // Last line without a line ending.
+  if (!available()) {
+    return false;
+  }
+
+  line = std::string_view(unread_data(), available());
+  read_begin = read_end;
+  return true;
+}
+
+bool zfile::read_word(std::string_view& word) {
+  // Skips the leading whitespaces.
+  while (true) {
+    while (read_begin < read_end and is_word_space(read_buffer[read_begin])) {
+      read_begin++;
+    }
+
+    if (read_begin < read_end or !fill(1)) {
+      break;
+    }
+  }
+
+  size_t size = 0;
+  while (true) {
+    while (size < available() and !is_word_space(unread_data()[size])) {
+      size++;
+    }
+
+    if (size < available() or !fill(size + 1)) {
+      break;
+    }
+  }
+
+  if (!size) {
+    return false;
+  }
+
+  word = std::string_view(unread_data(), size);
+  read_begin += size;
+  return true;
+}
+
+void zfile::discard_read_buffer() {
+  if (const size_t count = available()) {
+    stream.clear();
+    stream.seekg(-(std::streamoff)count, std::ios::cur);
+  }
+
+  read_begin = 0;
+  read_end = 0;
+}
+
 zfile* get_file(zs::vm_ref vm) {
   const zs::object& file_obj = vm[0];
   if (!file_obj.is_user_data()) {
@@ -46,6 +156,7 @@ static int_t file_is_open_impl(zs::vm_ref vm) {
 
 static int_t file_close_impl(zs::vm_ref vm) {
   zfile* file = ZS_GET_FILE();
+  file->discard_read_buffer();
   file->stream.close();
   return 0;
 }
@@ -64,6 +175,8 @@ static int_t file_write_impl(zs::vm_ref vm) {
     return -1;
   }
 
+  file->discard_read_buffer();
+
   for (int_t i = 1; i < nargs; i++) {
     const object& obj = vm[i];
 
@@ -88,6 +201,8 @@ static int_t file_write_json_impl(zs::vm_ref vm) {
     return -1;
   }
 
+  file->discard_read_buffer();
+
   for (int_t i = 1; i < nargs; i++) {
     const object& obj = vm[i];
     obj.stream_to_json(file->stream);
@@ -95,47 +210,187 @@ static int_t file_write_json_impl(zs::vm_ref vm) {
   return vm.push(vm[0]);
 }
 
+/// read() reads the next word, read(n) reads up to n bytes (null at the end of the file).
 static int_t file_read_impl(zs::vm_ref vm) {
   const int_t nargs = vm.stack_size();
-  if (nargs != 1) {
-    vm.set_error("No args in fs.file.read()");
+  if (nargs > 2) {
+    vm.set_error("Invalid number of arguments in fs.file.read(n)");
     return -1;
   }
 
   zfile* file = ZS_GET_FILE();
 
   if (!file->stream.is_open()) {
-    vm.set_error("File is not open in fs.file.file()");
+    vm.set_error("File is not open in fs.file.read()");
     return -1;
   }
 
-  std::string value;
-  file->stream >> value;
+  if (nargs == 1) {
+    std::string_view word;
+    return vm.push_string(file->read_word(word) ? word : std::string_view());
+  }
 
-  vm.push_string(value);
-  return 1;
+  if (!vm[1].is_integer() or vm[1]._int <= 0) {
+    vm.set_error("Invalid size in fs.file.read(n)");
+    return -1;
+  }
+
+  const std::string_view data = file->read((size_t)vm[1]._int);
+  return data.empty() ? vm.push_null() : vm.push_string(data);
+}
+
+/// Returns the next line without its line ending (null at the end of the file).
+static int_t file_read_line_impl(zs::vm_ref vm) {
+  zfile* file = ZS_GET_FILE();
+
+  if (!file->stream.is_open()) {
+    vm.set_error("File is not open in fs.file.read_line()");
+    return -1;
+  }
+
+  std::string_view line;
+  return file->read_line(line) ? vm.push_string(line) : vm.push_null();
+}
+
+/// Returns the whole content of the file, mapped in memory rather than read
+/// through the stream.
+static int_t file_read_all_impl(zs::vm_ref vm) {
+  zfile* file = ZS_GET_FILE();
+
+  zb::file_view fview;
+  if (auto err = fview.open(file->path)) {
+    // Empty files can't be mapped.
+    std::error_code ec;
+    if (std::filesystem::is_regular_file(file->path, ec) and std::filesystem::file_size(file->path, ec) == 0
+        and !ec) {
+      return vm.push_string("");
+    }
+
+    vm.set_error("Can't open the file in fs.file.read_all()");
+    return -1;
+  }
+
+  return vm.push_string(fview.str());
 }
 
-// static int_t file_read_all_impl(zs::vm_ref vm) {
-//   const int_t nargs = vm.stack_size();
-//   if (nargs != 1) {
-//     vm.set_error("No args in fs.file.read()");
-//     return -1;
-//   }
-//
-//   zfile* file = ZS_GET_FILE();
-//
-//   if (!file->stream.is_open()) {
-//     vm.set_error("File is not open in fs.file.file()");
-//     return -1;
-//   }
 //
-//   std::string value;
-//   file->stream >> value;
+// MARK: Lines.
 //
-//   vm.push_string(value);
-//   return 1;
-// }
+
+/// Iterator returned by `fs.file.lines()`, it reads the next line at each step.
+struct zfile_lines {
+  zs::object file_obj;
+  zs::object line;
+  int_t index = -1;
+  bool is_done = false;
+
+  void next() {
+    std::string_view view;
+    if (!file_obj._udata->data_ref<zfile>().read_line(view)) {
+      line = nullptr;
+      is_done = true;
+      return;
+    }
+
+    // Copied, a view of the read buffer would change with the next line.
+    line = zs::_s(file_obj._udata->get_engine(), view);
+    index++;
+  }
+};
+
+static zfile_lines* get_file_lines(zs::vm_ref vm) {
+  const zs::object& obj = vm[0];
+  if (!obj.is_user_data() or obj._udata->get_uid() != zs::_sv(k_file_lines_uid)) {
+    return nullptr;
+  }
+
+  return obj._udata->data<zfile_lines>();
+}
+
+#define ZS_GET_FILE_LINES()                       \
+  get_file_lines(vm);                             \
+  if (!lines) {                                   \
+    vm.set_error("Invalid fs.file.lines object"); \
+    return -1;                                    \
+  }
+
+static int_t file_lines_begin_impl(zs::vm_ref vm) {
+  zfile_lines* lines = ZS_GET_FILE_LINES();
+
+  if (lines->index == -1 and !lines->is_done) {
+    lines->next();
+  }
+
+  return vm.push(vm[0]);
+}
+
+static int_t file_lines_end_impl(zs::vm_ref vm) { return vm.push_null(); }
+
+static int_t file_lines_is_same_impl(zs::vm_ref vm) {
+  zfile_lines* lines = ZS_GET_FILE_LINES();
+  return vm.push_bool(lines->is_done);
+}
+
+static int_t file_lines_get_impl(zs::vm_ref vm) {
+  zfile_lines* lines = ZS_GET_FILE_LINES();
+  return vm.push(lines->line);
+}
+
+static int_t file_lines_get_key_impl(zs::vm_ref vm) {
+  zfile_lines* lines = ZS_GET_FILE_LINES();
+  return vm.push(lines->index);
+}
+
+static int_t file_lines_next_impl(zs::vm_ref vm) {
+  zfile_lines* lines = ZS_GET_FILE_LINES();
+  lines->next();
+  return vm.push(vm[0]);
+}
+
+static zs::object create_file_lines_delegate(zs::vm_ref vm) {
+  zs::engine* eng = vm->get_engine();
+
+  zs::object delegate_key = zs::_sv(k_file_lines_delegate_name);
+
+  zs::table_map& registry_map = eng->get_registry_table()._table->get_map();
+  if (auto it = registry_map.find(delegate_key); it != registry_map.end()) {
+    return it->second;
+  }
+
+  zs::object lines_delegate = zs::object::create_table(eng);
+  zs::table_object* tbl = lines_delegate._table;
+
+  tbl->set(zs::_ss("begin"), file_lines_begin_impl);
+  tbl->set(zs::_ss("end"), file_lines_end_impl);
+  tbl->set(zs::_ss("is_same"), file_lines_is_same_impl);
+  tbl->set(zs::_ss("get"), file_lines_get_impl);
+  tbl->set(zs::_ss("get_key"), file_lines_get_key_impl);
+  tbl->set(zs::_ss("next"), file_lines_next_impl);
+
+  return (registry_map[delegate_key] = std::move(lines_delegate));
+}
+
+/// for(var line : file.lines()) {}
+static int_t file_lines_impl(zs::vm_ref vm) {
+  zfile* file = ZS_GET_FILE();
+
+  if (!file->stream.is_open()) {
+    vm.set_error("File is not open in fs.file.lines()");
+    return -1;
+  }
+
+  zs::engine* eng = vm.get_engine();
+
+  zs::object lines_obj = zs::object::create_user_data(eng, sizeof(zfile_lines));
+  zb_placement_new(lines_obj._udata->data()) zfile_lines{ vm[0] };
+
+  lines_obj._udata->set_release_hook(
+      [](zs::engine* eng, zs::raw_pointer_t ptr) { ((zfile_lines*)ptr)->~zfile_lines(); });
+
+  lines_obj.set_delegate(create_file_lines_delegate(vm));
+  lines_obj._udata->set_uid(zs::_sv(k_file_lines_uid));
+  return vm.push(lines_obj);
+}
 
 static int_t file_get_impl(zs::vm_ref vm) {
   // vm[0] should be the user_data.
@@ -171,7 +426,7 @@ static zs::object create_file_delegate(zs::vm_ref vm) {
 
   zs::object delegate_key = zs::_sv(k_file_delegate_name);
 
-  zs::object_map& registry_map = eng->get_registry_table()._table->get_map();
+  zs::table_map& registry_map = eng->get_registry_table()._table->get_map();
   if (auto it = registry_map.find(delegate_key); it != registry_map.end()) {
     return it->second;
   }
@@ -187,7 +442,9 @@ static zs::object create_file_delegate(zs::vm_ref vm) {
           { zs::_ss("write"), file_write_impl }, //
           { zs::_ss("write_json"), file_write_json_impl }, //
           { zs::_ss("read"), file_read_impl }, //
-          //{ zs::_ss("read_all"), file_read_all_impl }, //
+          { zs::_ss("read_line"), file_read_line_impl }, //
+          { zs::_ss("read_all"), file_read_all_impl }, //
+          { zs::_ss("lines"), file_lines_impl }, //
           { zs::constants::get<meta_method::mt_get>(), file_get_impl }, //
 
       });
@@ -7,6 +7,8 @@ namespace zs::file_library {
 
 inline constexpr std::string_view k_file_uid = "fs.file";
 inline constexpr std::string_view k_file_delegate_name = "__fs_file_delegate";
+inline constexpr std::string_view k_file_lines_uid = "fs.file.lines";
+inline constexpr std::string_view k_file_lines_delegate_name = "__fs_file_lines_delegate";
 
 //"r"  read  Open a file for reading  read from start  return NULL and set error
 //"w"  write  Create a file for writing  destroy contents  create new
@@ -40,10 +42,42 @@ inline constexpr int_t open_mode_trunc = 32;
 inline constexpr int_t open_mode_create_if_not_found = 64;
 
 struct zfile {
+  /// Initial size of the read buffer, it grows for longer lines or reads.
+  static constexpr size_t k_read_buffer_size = 64 * 1024;
+
   zfile(zs::engine* eng, std::string_view path, int_t openmode = open_mode_read | open_mode_write);
 
+  /// The reads below go through `read_buffer`, the returned views are only
+  /// valid until the next read.
+
+  /// Reads up to `n` bytes, returns an empty view at the end of the file.
+  std::string_view read(size_t n);
+
+  /// Reads the next line without its line ending, returns false at the end of the file.
+  bool read_line(std::string_view& line);
+
+  /// Reads the next whitespace delimited word, returns false at the end of the file.
+  bool read_word(std::string_view& word);
+
+  /// Puts the stream back at the position of the first unread byte, must be
+  /// called before writing.
+  void discard_read_buffer();
+
   zs::string path;
   std::fstream stream;
+
+  /// Read from `stream` but not consumed yet: [read_begin, read_end).
+  zs::vector<char> read_buffer;
+  size_t read_begin = 0;
+  size_t read_end = 0;
+
+private:
+  /// Reads until there are at least `n` unread bytes or the end of the file.
+  /// Returns false if nothing could be read.
+  bool fill(size_t n);
+
+  ZS_CK_INLINE size_t available() const noexcept { return read_end - read_begin; }
+  ZS_CK_INLINE const char* unread_data() const noexcept { return read_buffer.data() + read_begin; }
 };
 
 zfile* get_file(zs::vm_ref vm);
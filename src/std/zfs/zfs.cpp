@@ -4,6 +4,7 @@
 #include "zvirtual_machine.h"
 #include "utility/zparameter_stream.h"
 #include "utility/zvm_load.h"
+#include <zscript/std/zbytes.h>
 
 #if !defined(ZS_UNIX) \
     && (defined(unix) || defined(__unix__) || defined(__unix) || defined(__APPLE__) || defined(BSD))
@@ -289,6 +290,23 @@ namespace {
     return -1;
   }
 
+  /// fs.map_file(path), read only bytes of the mapped file.
+  int_t zfs_map_file(zs::vm_ref vm) {
+    zs::parameter_stream ps(vm);
+    ++ps;
+
+    std::string_view path;
+    ZS_RETURN_IF_ERROR(ps.require<string_parameter>(path), -1);
+
+    object output = zs::create_mapped_bytes(vm, std::string(path).c_str());
+    if (output.is_null()) {
+      vm.set_error("Could not map file ", zb::quoted(path), ".");
+      return -1;
+    }
+
+    return vm.push(output);
+  }
+
   int_t zfs_load_value_file(zs::vm_ref vm) {
     const int_t nargs = vm.stack_size();
     if (nargs != 2) {
@@ -431,7 +449,7 @@ zs::object create_fs_lib(zs::vm_ref vm) {
   zs::engine* eng = vm->get_engine();
 
   zs::object fs_module = zs::object::create_table(eng);
-  zs::object_map& fs_map = fs_module._table->get_map();
+  zs::table_map& fs_map = fs_module._table->get_map();
   fs_map.reserve(20);
 
   // fs::openmode.
@@ -462,6 +480,7 @@ zs::object create_fs_lib(zs::vm_ref vm) {
   fs_map["json_file"_ss] = zs::_nf(zfs_load_json_file);
   fs_map["string_file"_ss] = zs::_nf(zfs_load_string_file);
   fs_map["value_file"_ss] = zs::_nf(zfs_load_value_file);
+  fs_map["map_file"_ss] = zs::_nf(zfs_map_file);
   return fs_module;
 }
 } // namespace zs.
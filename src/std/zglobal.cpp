@@ -4,6 +4,7 @@
 #include "utility/zvm_module.h"
 #include <zscript/std/zmutable_string.h>
 #include <zscript/std/zfloat_array.h>
+#include <zscript/std/zbytes.h>
 
 #include "object/delegate/znumber_delegate.h"
 #include "object/delegate/zfunction_delegate.h"
@@ -375,6 +376,7 @@ zs::object create_global_table(zs::engine* eng) {
   g.emplace(_ss("mutable_string"), zs::vm_create_mutable_string);
   g.emplace(_ss("np"), zs::create_float_array_lib(eng));
   g.emplace(_ss("float_array"), zs::vm_create_float_array);
+  g.emplace(_ss("bytes"), zs::vm_create_bytes);
 
   // Not '__tostring'.
   g.emplace(_ss("__to_string"), global_table_to_string_impl);
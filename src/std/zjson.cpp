@@ -0,0 +1,237 @@
+#include <zscript/zscript.h>
+#include <zscript/std/zjson.h>
+#include <zscript/std/zbytes.h>
+#include "zvirtual_machine.h"
+#include "utility/zparameter_stream.h"
+#include "utility/json/zjson_document.h"
+
+namespace zs {
+namespace {
+  zs::object& get_json_value_delegate(zs::engine* eng);
+
+  namespace json_lib {
+    inline constexpr object document_uid = _sv("__json_document_object__");
+    inline constexpr object value_uid = _sv("__json_value_object__");
+    inline constexpr object reg_id = _sv("__json_value_delegate__");
+
+    /// Keeps the content alive for as long as the document is used.
+    struct document_holder {
+      inline document_holder(zs::engine* eng, const object& src)
+          : source(src)
+          , doc(eng) {}
+
+      object source;
+      json_document doc;
+    };
+
+    struct value {
+      object document;
+      uint32_t index;
+
+      ZS_CK_INLINE const json_document& get_document() const noexcept {
+        return document.as_udata().data_ref<document_holder>().doc;
+      }
+    };
+
+    object create_value(zs::engine* eng, const object& document, uint32_t index) noexcept {
+      user_data_object* uobj = user_data_object::create<value>(eng, value{ document, index });
+      uobj->set_uid(value_uid);
+      uobj->set_type_id(value_uid);
+      uobj->set_delegate(get_json_value_delegate(eng));
+
+      uobj->set_to_string_callback([](const object_base& obj, std::ostream& stream) -> zs::error_result {
+        const value& v = obj.as_udata().data_ref<value>();
+        const json_document::entry& e = v.get_document().get_entry(v.index);
+        stream << (e.type == json_document::value_type::object ? "json_object(" : "json_array(") << e.size
+               << ")";
+        return {};
+      });
+
+      return zs::object(uobj, false);
+    }
+
+    /// Containers stay in the document, scalars are converted.
+    zs::error_result get(zs::engine* eng, const value& v, uint32_t index, object& output) {
+      const json_document& doc = v.get_document();
+
+      if (doc.is_container(index)) {
+        output = create_value(eng, v.document, index);
+        return {};
+      }
+
+      return doc.to_object(index, output);
+    }
+
+    /// Returns the index of the member or element, or -1.
+    int_t find(const value& v, const object& key) {
+      const json_document& doc = v.get_document();
+
+      if (key.is_string()) {
+        return doc.find(v.index, key.get_string_unchecked());
+      }
+
+      if (key.is_integer()) {
+        const json_document::entry& e = doc.get_entry(v.index);
+        const int_t i = key._int < 0 ? key._int + (int_t)e.size : key._int;
+        return i < 0 ? -1 : doc.at(v.index, (size_t)i);
+      }
+
+      return -1;
+    }
+  } // namespace json_lib
+
+  struct json_value_parameter {
+    static zs::error_result parse(zs::parameter_stream& s, bool output_error, json_lib::value*& value) {
+      if (s.is_user_data_with_uid(json_lib::value_uid)) {
+        value = s++->as_udata().data<json_lib::value>();
+        return {};
+      }
+
+      s.set_opt_error(output_error, "Invalid json value type.");
+      return zs::errc::invalid_parameter_type;
+    }
+  };
+
+  // vm[0] should be the json value.
+  // vm[1] should be the key.
+  int_t json_value_meta_get_impl(zs::vm_ref vm) noexcept {
+    zs::parameter_stream ps(vm);
+
+    json_lib::value* v = nullptr;
+    ZS_RETURN_IF_ERROR(ps.require<json_value_parameter>(v), -1);
+
+    const int_t index = json_lib::find(*v, *ps);
+    if (index == -1) {
+      return vm.push_none();
+    }
+
+    if (v->get_document().get_entry((uint32_t)index).type == json_document::value_type::null) {
+      return vm.set_error("Null json value, use get(key).");
+    }
+
+    object output;
+    if (auto err = json_lib::get(vm.get_engine(), *v, (uint32_t)index, output)) {
+      return vm.set_error("Invalid json value.");
+    }
+
+    return vm.push(output);
+  }
+
+  /// get(key), returns none if the key or index is not found.
+  int_t json_value_get_impl(zs::vm_ref vm) noexcept {
+    zs::parameter_stream ps(vm);
+
+    json_lib::value* v = nullptr;
+    ZS_RETURN_IF_ERROR(ps.require<json_value_parameter>(v), -1);
+
+    if (!ps.is_valid()) {
+      return vm.set_error("Missing key in json_value.get(key).");
+    }
+
+    const int_t index = json_lib::find(*v, *ps);
+    if (index == -1) {
+      return vm.push_none();
+    }
+
+    object output;
+    if (auto err = json_lib::get(vm.get_engine(), *v, (uint32_t)index, output)) {
+      return vm.set_error("Invalid json value.");
+    }
+
+    return vm.push(output);
+  }
+
+  /// size(), number of members or elements.
+  int_t json_value_size_impl(zs::vm_ref vm) noexcept {
+    zs::parameter_stream ps(vm);
+
+    json_lib::value* v = nullptr;
+    ZS_RETURN_IF_ERROR(ps.require<json_value_parameter>(v), -1);
+    return vm.push((int_t)v->get_document().get_entry(v->index).size);
+  }
+
+  /// to_object(), converts the value and all its children to tables and arrays.
+  int_t json_value_to_object_impl(zs::vm_ref vm) noexcept {
+    zs::parameter_stream ps(vm);
+
+    json_lib::value* v = nullptr;
+    ZS_RETURN_IF_ERROR(ps.require<json_value_parameter>(v), -1);
+
+    object output;
+    if (auto err = v->get_document().to_object(v->index, output)) {
+      return vm.set_error("Invalid json value.");
+    }
+
+    return vm.push(output);
+  }
+
+  zs::object create_json_value_delegate(zs::engine* eng) {
+    using namespace literals;
+
+    table_object* tbl = table_object::create(eng);
+    tbl->reserve(5);
+
+    tbl->emplace(constants::get<meta_method::mt_typeof>(), "json_value"_ss);
+    tbl->emplace(constants::get<meta_method::mt_get>(), json_value_meta_get_impl);
+
+    tbl->emplace("get"_ss, json_value_get_impl);
+    tbl->emplace("size"_ss, json_value_size_impl);
+    tbl->emplace("to_object"_ss, json_value_to_object_impl);
+
+    tbl->set_no_default_none();
+    return object(tbl, false);
+  }
+
+  zs::object& get_json_value_delegate(zs::engine* eng) {
+    object& obj = eng->get_registry_table_object()[json_lib::reg_id];
+    return obj.is_table() ? obj : (obj = create_json_value_delegate(eng));
+  }
+} // namespace
+
+bool is_json_value(const object& obj) noexcept {
+  return obj.is_user_data() and obj.as_udata().get_uid() == json_lib::value_uid;
+}
+
+int_t vm_create_json_document(zs::vm_ref vm) {
+  zs::parameter_stream ps(vm);
+  ++ps;
+
+  if (ps.size() != 1 or !(ps->is_string() or is_bytes(*ps))) {
+    return vm.set_error("Invalid parameters, expected json_document(string) or json_document(bytes).");
+  }
+
+  zs::engine* eng = vm.get_engine();
+
+  user_data_object* uobj = user_data_object::create<json_lib::document_holder>(eng, eng, *ps);
+  uobj->set_uid(json_lib::document_uid);
+  object document(uobj, false);
+
+  json_lib::document_holder& holder = uobj->data_ref<json_lib::document_holder>();
+
+  // Small strings live in the object, the view is taken from the held copy.
+  std::string_view content;
+  if (holder.source.is_string()) {
+    content = holder.source.get_string_unchecked();
+  }
+  else {
+    const bytes& b = bytes::as_bytes(holder.source);
+    content = std::string_view((const char*)b.data, b.size);
+  }
+
+  if (auto err = holder.doc.parse(content)) {
+    return vm.set_error("Invalid json document.");
+  }
+
+  // Scalar documents are converted right away.
+  if (!holder.doc.is_container(0)) {
+    object output;
+    if (auto err = holder.doc.to_object(0, output)) {
+      return vm.set_error("Invalid json document.");
+    }
+
+    return vm.push(output);
+  }
+
+  return vm.push(json_lib::create_value(eng, document, 0));
+}
+} // namespace zs.
@@ -1,7 +1,9 @@
 #include <zscript/zscript.h>
 #include <zscript/std/zslib.h>
+#include <zscript/std/zjson.h>
 #include "zvirtual_machine.h"
 #include "utility/zvm_module.h"
+#include <zscript/utility/string_template.h>
 #include <zscript/base/strings/charconv.h>
 #include <zscript/base/strings/unicode.h>
 #include "utility/zparameter_stream.h"
@@ -489,6 +491,51 @@ namespace {
     return vm.push((int_t)obj._pointer);
   }
 
+  zs::object create_allocation_stats_table(zs::engine* eng, const allocation_stats& stats) {
+    zs::object tbl = zs::_t(eng);
+    zs::table_object& t = tbl.as_table();
+    t.emplace("live_bytes", (int_t)stats.live_bytes);
+    t.emplace("peak_bytes", (int_t)stats.peak_bytes);
+    t.emplace("live_count", (int_t)stats.live_count);
+    t.emplace("allocation_count", (int_t)stats.allocation_count);
+    return tbl;
+  }
+
+  /// Returns null when the allocation tracking is off (see `engine::start_allocation_tracking()`).
+  /// {
+  ///   tags: { vm: { live_bytes, peak_bytes, live_count, allocation_count }, table: {...}, ... },
+  ///   sites: [ { name, source, line, live_bytes, peak_bytes, live_count, allocation_count }, ... ]
+  /// }
+  int_t zslib_mem_stats_impl(zs::vm_ref vm) {
+    zs::engine* eng = vm->get_engine();
+
+    if (!eng->is_tracking_allocations()) {
+      return vm.push_null();
+    }
+
+    zs::object tags = zs::_t(eng);
+    for (size_t i = 0; i < allocation_tracker::k_tag_count; i++) {
+      tags.as_table().emplace(allocation_tracker::get_tag_name((memory_tag)i),
+          create_allocation_stats_table(eng, eng->get_allocation_stats((memory_tag)i)));
+    }
+
+    zs::vector<allocation_site_stats> site_stats = eng->get_allocation_site_stats();
+
+    zs::object sites = zs::_a(eng, 0);
+    for (const allocation_site_stats& s : site_stats) {
+      zs::object site = create_allocation_stats_table(eng, s.stats);
+      site.as_table().emplace("name", zs::_s(eng, s.name));
+      site.as_table().emplace("source", zs::_s(eng, s.source_name));
+      site.as_table().emplace("line", (int_t)s.line);
+      sites.as_array().push_back(std::move(site));
+    }
+
+    zs::object result = zs::_t(eng);
+    result.as_table().emplace("tags", std::move(tags));
+    result.as_table().emplace("sites", std::move(sites));
+    return vm.push(result);
+  }
+
   int_t zslib_get_table_default_delegate_impl(zs::vm_ref vm) {
 
     return vm.push(vm->get_default_table_delegate());
@@ -607,6 +654,24 @@ namespace {
     return 0;
   }
 
+  int_t zslib_add_import_archive_impl(zs::vm_ref vm) {
+
+    int_t nargs = vm.stack_size();
+    if (nargs <= 1) {
+      vm->handle_error(zs::errc::invalid_parameter_count, { -1, -1 },
+          "Missing archive parameter in sys::add_import_archive().", zb::source_location::current());
+      return -1;
+    }
+
+    if (auto err = vm->get_engine()->add_import_archive(vm[1].get_string_unchecked())) {
+      vm->handle_error(
+          err, { -1, -1 }, "Invalid sys::add_import_archive().", zb::source_location::current());
+      return -1;
+    }
+
+    return 0;
+  }
+
   int_t zslib_is_one_of_impl(zs::vm_ref vm) {
     int_t nargs = vm.stack_size();
 
@@ -836,6 +901,7 @@ zs::object create_zs_lib(zs::vm_ref vm) {
   zs_tbl.emplace("get_table_default_delegate", zslib_get_table_default_delegate_impl);
 
   zs_tbl.emplace("get_addr"_ss, zslib_get_addr_impl);
+  zs_tbl.emplace("mem_stats"_ss, zslib_mem_stats_impl);
 
   zs_tbl.emplace("raw_get"_ss, zslib_raw_get_impl);
   zs_tbl.emplace("get_table_keys"_ss, zslib_get_table_keys_impl);
@@ -845,6 +911,8 @@ zs::object create_zs_lib(zs::vm_ref vm) {
   zs_tbl.emplace("bind"_ss, zslib_bind_impl);
   zs_tbl.emplace("apply"_ss, zslib_apply_impl);
   zs_tbl.emplace("strlen"_ss, zslib_strlen_impl);
+  zs_tbl.emplace("template"_ss, zs::vm_create_string_template);
+  zs_tbl.emplace("json_document"_ss, zs::vm_create_json_document);
   zs_tbl.emplace("placeholder"_ss, zs::object((void*)&s_placeholder));
 
   zs_tbl.emplace("contains"_ss, zslib_contains_impl);
@@ -857,6 +925,7 @@ zs::object create_zs_lib(zs::vm_ref vm) {
   zs_tbl.emplace(zs::_sv(s_write_to_string_name), zslib_write_to_string_impl);
 
   zs_tbl.emplace(zs::_s(eng, "add_import_directory"), zslib_add_import_directory_impl);
+  zs_tbl.emplace(zs::_s(eng, "add_import_archive"), zslib_add_import_archive_impl);
 
   zs_tbl.emplace("is_one_of"_ss, zslib_is_one_of_impl);
   zs_tbl.emplace("all_equals"_ss, zslib_all_equals_impl);
@@ -0,0 +1,653 @@
+#include "zjson_document.h"
+#include <zscript/base/strings/charconv.h>
+#include <zscript/base/strings/unicode.h>
+
+#if __ZBASE_SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace zs {
+
+namespace {
+  inline constexpr uint64_t k_even_bits = 0x5555555555555555ULL;
+  inline constexpr size_t k_max_depth = 1024;
+
+  /// One bit per byte of a 64 bytes block.
+  struct block_masks {
+    uint64_t quote;
+    uint64_t backslash;
+    uint64_t op;
+    uint64_t whitespace;
+  };
+
+#if __ZBASE_SSE2__
+  ZS_CK_INLINE uint64_t match(__m128i v, char c) noexcept {
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+  }
+
+  ZS_CK_INLINE block_masks classify(const uint8_t* ptr) noexcept {
+    block_masks m = {};
+
+    for (uint64_t i = 0; i < 4; i++) {
+      const __m128i v = _mm_loadu_si128((const __m128i*)(ptr + i * 16));
+
+      // '[' and ']' are '{' and '}' without the 0x20 bit.
+      const __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+
+      m.quote |= match(v, '"') << (i * 16);
+      m.backslash |= match(v, '\\') << (i * 16);
+      m.op |= (match(lower, '{') | match(lower, '}') | match(v, ':') | match(v, ',')) << (i * 16);
+      m.whitespace |= (match(v, ' ') | match(v, '\t') | match(v, '\n') | match(v, '\r')) << (i * 16);
+    }
+
+    return m;
+  }
+#else
+  enum char_class : uint8_t { cc_quote = 1, cc_backslash = 2, cc_op = 4, cc_whitespace = 8 };
+
+  inline constexpr std::array<uint8_t, 256> k_char_classes = []() {
+    std::array<uint8_t, 256> classes = {};
+    classes['"'] = cc_quote;
+    classes['\\'] = cc_backslash;
+
+    for (uint8_t c : { '{', '}', '[', ']', ':', ',' }) {
+      classes[c] = cc_op;
+    }
+
+    for (uint8_t c : { ' ', '\t', '\n', '\r' }) {
+      classes[c] = cc_whitespace;
+    }
+
+    return classes;
+  }();
+
+  ZS_CK_INLINE block_masks classify(const uint8_t* ptr) noexcept {
+    block_masks m = {};
+
+    for (uint64_t i = 0; i < 64; i++) {
+      const uint64_t c = k_char_classes[ptr[i]];
+      m.quote |= (c & 1) << i;
+      m.backslash |= ((c >> 1) & 1) << i;
+      m.op |= ((c >> 2) & 1) << i;
+      m.whitespace |= ((c >> 3) & 1) << i;
+    }
+
+    return m;
+  }
+#endif
+
+  /// Each bit is the xor of all the previous bits, a quote toggles the string state.
+  ZS_CK_INLINE uint64_t prefix_xor(uint64_t x) noexcept {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+  }
+
+  ZS_CK_INLINE bool is_terminator(char c) noexcept {
+    return zb::is_one_of(c, ' ', '\t', '\n', '\r', ',', ':', '[', ']', '{', '}');
+  }
+
+  ZS_CK_INLINE bool is_digit(char c) noexcept { return c >= '0' and c <= '9'; }
+
+  ZS_CK_INLINE int hex_value(char c) noexcept {
+    if (c >= '0' and c <= '9') {
+      return c - '0';
+    }
+
+    c |= 0x20;
+    return (c >= 'a' and c <= 'f') ? c - 'a' + 10 : -1;
+  }
+
+  inline bool parse_hex4(const char* it, const char* end, uint32_t& cp) noexcept {
+    if (end - it < 4) {
+      return false;
+    }
+
+    cp = 0;
+    for (int i = 0; i < 4; i++) {
+      const int v = hex_value(it[i]);
+      if (v < 0) {
+        return false;
+      }
+
+      cp = (cp << 4) | (uint32_t)v;
+    }
+
+    return true;
+  }
+} // namespace.
+
+struct json_document::helper {
+  json_document& doc;
+  size_t k = 0;
+  size_t string_index = 0;
+
+  ZS_CK_INLINE bool is_end() const noexcept { return k >= doc._structurals.size(); }
+
+  ZS_CK_INLINE char current() const noexcept { return doc._content[doc._structurals[k]]; }
+
+  ZS_INLINE bool consume(char c) noexcept {
+    if (is_end() or current() != c) {
+      return false;
+    }
+
+    k++;
+    return true;
+  }
+
+  zs::error_result add_literal(std::string_view literal, value_type type) {
+    const uint32_t offset = doc._structurals[k++];
+    const std::string_view content = doc._content;
+
+    if (content.substr(offset, literal.size()) != literal
+        or (offset + literal.size() < content.size() and !is_terminator(content[offset + literal.size()]))) {
+      return zs::errc::invalid_token;
+    }
+
+    const uint32_t index = (uint32_t)doc._tape.size();
+    doc._tape.push_back({ type, false, offset, index + 1, (uint32_t)literal.size() });
+    return {};
+  }
+
+  zs::error_result add_number() {
+    const uint32_t offset = doc._structurals[k++];
+    const std::string_view content = doc._content;
+
+    // -?digits(.digits)?([eE][+-]?digits)?
+    size_t end = offset;
+    const auto skip_digits = [&]() {
+      const size_t start = end;
+      while (end < content.size() and is_digit(content[end])) {
+        end++;
+      }
+
+      return end > start;
+    };
+
+    const auto consume_one_of = [&](char a, char b) {
+      if (end < content.size() and (content[end] == a or content[end] == b)) {
+        end++;
+        return true;
+      }
+
+      return false;
+    };
+
+    consume_one_of('-', '-');
+
+    if (!skip_digits()) {
+      return zs::errc::invalid_number;
+    }
+
+    bool is_float = false;
+
+    if (consume_one_of('.', '.')) {
+      is_float = true;
+
+      if (!skip_digits()) {
+        return zs::errc::invalid_number;
+      }
+    }
+
+    if (consume_one_of('e', 'E')) {
+      is_float = true;
+      consume_one_of('+', '-');
+
+      if (!skip_digits()) {
+        return zs::errc::invalid_number;
+      }
+    }
+
+    if (end < content.size() and !is_terminator(content[end])) {
+      return zs::errc::invalid_number;
+    }
+
+    const uint32_t index = (uint32_t)doc._tape.size();
+    doc._tape.push_back({ is_float ? value_type::floating : value_type::integer, false, offset, index + 1,
+        (uint32_t)(end - offset) });
+    return {};
+  }
+
+  zs::error_result add_string() {
+    const uint32_t offset = doc._structurals[k++];
+
+    // The strings are visited in order, the next end is the one of this string.
+    if (string_index >= doc._string_ends.size()) {
+      return zs::errc::invalid_token;
+    }
+
+    const uint32_t end = doc._string_ends[string_index++];
+    const uint32_t size = end - offset - 1;
+    const bool escaped = ::memchr(doc._content.data() + offset + 1, '\\', size) != nullptr;
+
+    const uint32_t index = (uint32_t)doc._tape.size();
+    doc._tape.push_back({ value_type::string, escaped, offset, index + 1, size });
+    return {};
+  }
+
+  zs::error_result add_value(size_t depth) {
+    if (is_end()) {
+      return zs::errc::invalid_token;
+    }
+
+    switch (current()) {
+    case '{':
+      if (depth >= k_max_depth) {
+        return zs::errc::out_of_bounds;
+      }
+
+      return add_object(depth + 1);
+    case '[':
+      if (depth >= k_max_depth) {
+        return zs::errc::out_of_bounds;
+      }
+
+      return add_array(depth + 1);
+    case '"':
+      return add_string();
+    case 't':
+      return add_literal("true", value_type::true_value);
+    case 'f':
+      return add_literal("false", value_type::false_value);
+    case 'n':
+      return add_literal("null", value_type::null);
+    case '-':
+    case '0':
+    case '1':
+    case '2':
+    case '3':
+    case '4':
+    case '5':
+    case '6':
+    case '7':
+    case '8':
+    case '9':
+      return add_number();
+    default:
+      return zs::errc::invalid_token;
+    }
+  }
+
+  zs::error_result add_object(size_t depth) {
+    const uint32_t index = (uint32_t)doc._tape.size();
+    doc._tape.push_back({ value_type::object, false, doc._structurals[k++], 0, 0 });
+
+    uint32_t count = 0;
+
+    if (!consume('}')) {
+      do {
+        if (is_end() or current() != '"') {
+          return zs::errc::invalid_token;
+        }
+
+        ZS_RETURN_IF_ERROR(add_string());
+
+        if (!consume(':')) {
+          return zs::errc::invalid_token;
+        }
+
+        ZS_RETURN_IF_ERROR(add_value(depth));
+        count++;
+      } while (consume(','));
+
+      if (!consume('}')) {
+        return zs::errc::invalid_token;
+      }
+    }
+
+    doc._tape[index].next = (uint32_t)doc._tape.size();
+    doc._tape[index].size = count;
+    return {};
+  }
+
+  zs::error_result add_array(size_t depth) {
+    const uint32_t index = (uint32_t)doc._tape.size();
+    doc._tape.push_back({ value_type::array, false, doc._structurals[k++], 0, 0 });
+
+    uint32_t count = 0;
+
+    if (!consume(']')) {
+      do {
+        ZS_RETURN_IF_ERROR(add_value(depth));
+        count++;
+      } while (consume(','));
+
+      if (!consume(']')) {
+        return zs::errc::invalid_token;
+      }
+    }
+
+    doc._tape[index].next = (uint32_t)doc._tape.size();
+    doc._tape[index].size = count;
+    return {};
+  }
+};
+
+json_document::json_document(zs::engine* eng)
+    : engine_holder(eng)
+    , _structurals(zs::allocator<uint32_t>(eng))
+    , _string_ends(zs::allocator<uint32_t>(eng))
+    , _tape(zs::allocator<entry>(eng)) {}
+
+zs::error_result json_document::parse(std::string_view content) {
+  if (content.size() >= std::numeric_limits<uint32_t>::max()) {
+    return zs::errc::out_of_bounds;
+  }
+
+  _content = content;
+  _structurals.clear();
+  _string_ends.clear();
+  _tape.clear();
+
+  ZS_RETURN_IF_ERROR(build_structural_index());
+  return build_tape();
+}
+
+zs::error_result json_document::build_structural_index() {
+  const uint8_t* data = (const uint8_t*)_content.data();
+  const size_t size = _content.size();
+
+  _structurals.reserve(size / 4 + 16);
+
+  // Carried from one block to the next.
+  uint64_t prev_escaped = 0;
+  uint64_t prev_in_string = 0;
+  uint64_t prev_scalar = 0;
+
+  // The last partial block is padded with spaces.
+  alignas(16) uint8_t tail[64];
+
+  for (size_t base = 0; base < size; base += 64) {
+    const uint8_t* ptr = data + base;
+
+    if (size - base < 64) {
+      ::memset(tail, ' ', sizeof(tail));
+      ::memcpy(tail, ptr, size - base);
+      ptr = tail;
+    }
+
+    const block_masks m = classify(ptr);
+
+    // Escaped characters: the odd characters following a backslash sequence.
+    const uint64_t backslash = m.backslash & ~prev_escaped;
+    const uint64_t follows_escape = (backslash << 1) | prev_escaped;
+    const uint64_t odd_sequence_starts = backslash & ~k_even_bits & ~follows_escape;
+    const uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+    prev_escaped = sequences_starting_on_even_bits < odd_sequence_starts;
+    const uint64_t escaped = (k_even_bits ^ (sequences_starting_on_even_bits << 1)) & follows_escape;
+
+    // The opening quotes are in the strings, the closing ones are not.
+    const uint64_t quote = m.quote & ~escaped;
+    const uint64_t in_string = prefix_xor(quote) ^ prev_in_string;
+    prev_in_string = (uint64_t)((int64_t)in_string >> 63);
+
+    // First character of the scalars (and of the strings).
+    const uint64_t scalar = ~(m.op | m.whitespace);
+    const uint64_t nonquote_scalar = scalar & ~quote;
+    const uint64_t follows_nonquote_scalar = (nonquote_scalar << 1) | prev_scalar;
+    prev_scalar = nonquote_scalar >> 63;
+
+    const uint64_t string_tail = in_string ^ quote;
+    uint64_t structurals = (m.op | (scalar & ~follows_nonquote_scalar)) & ~string_tail;
+    uint64_t string_ends = quote & ~in_string;
+
+    while (structurals) {
+      _structurals.push_back((uint32_t)(base + std::countr_zero(structurals)));
+      structurals &= structurals - 1;
+    }
+
+    while (string_ends) {
+      _string_ends.push_back((uint32_t)(base + std::countr_zero(string_ends)));
+      string_ends &= string_ends - 1;
+    }
+  }
+
+  // Unterminated string.
+  if (prev_in_string) {
+    return zs::errc::invalid_token;
+  }
+
+  return {};
+}
+
+zs::error_result json_document::build_tape() {
+  _tape.reserve(_structurals.size() / 2 + 1);
+
+  helper h{ *this };
+  ZS_RETURN_IF_ERROR(h.add_value(0));
+
+  if (!h.is_end()) {
+    return zs::errc::invalid_token;
+  }
+
+  return {};
+}
+
+int_t json_document::find(uint32_t index, std::string_view key) const {
+  const entry& e = _tape[index];
+  if (e.type != value_type::object) {
+    return -1;
+  }
+
+  zs::string buffer((zs::string_allocator(_engine)));
+
+  for (uint32_t i = index + 1; i < e.next; i = _tape[i + 1].next) {
+    if (!_tape[i].escaped) {
+      if (get_raw_string(i) == key) {
+        return i + 1;
+      }
+
+      continue;
+    }
+
+    buffer.clear();
+    if (!get_string(i, buffer) and buffer == key) {
+      return i + 1;
+    }
+  }
+
+  return -1;
+}
+
+int_t json_document::at(uint32_t index, size_t i) const noexcept {
+  const entry& e = _tape[index];
+  if (e.type != value_type::array or i >= e.size) {
+    return -1;
+  }
+
+  uint32_t it = index + 1;
+  while (i--) {
+    it = _tape[it].next;
+  }
+
+  return it;
+}
+
+zs::error_result json_document::get_string(uint32_t index, zs::string& output) const {
+  const std::string_view raw = get_raw_string(index);
+
+  if (!_tape[index].escaped) {
+    output.append(raw);
+    return {};
+  }
+
+  const char* it = raw.data();
+  const char* end = raw.data() + raw.size();
+
+  while (it < end) {
+    const char* bs = (const char*)::memchr(it, '\\', end - it);
+    if (!bs) {
+      output.append(it, end);
+      break;
+    }
+
+    output.append(it, bs);
+    it = bs + 1;
+
+    if (it == end) {
+      return zs::errc::invalid_token;
+    }
+
+    switch (*it++) {
+    case '"':
+      output.push_back('"');
+      break;
+    case '\\':
+      output.push_back('\\');
+      break;
+    case '/':
+      output.push_back('/');
+      break;
+    case 'b':
+      output.push_back('\b');
+      break;
+    case 'f':
+      output.push_back('\f');
+      break;
+    case 'n':
+      output.push_back('\n');
+      break;
+    case 'r':
+      output.push_back('\r');
+      break;
+    case 't':
+      output.push_back('\t');
+      break;
+    case 'u': {
+      uint32_t cp;
+      if (!parse_hex4(it, end, cp)) {
+        return zs::errc::invalid_token;
+      }
+
+      it += 4;
+
+      // Surrogate pair.
+      if (cp >= 0xD800 and cp < 0xDC00) {
+        uint32_t low;
+        if (end - it < 6 or it[0] != '\\' or it[1] != 'u' or !parse_hex4(it + 2, end, low) or low < 0xDC00
+            or low > 0xDFFF) {
+          return zs::errc::invalid_token;
+        }
+
+        it += 6;
+        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+      }
+
+      char buffer[4];
+      output.append(buffer, zb::unicode::append_u32_to_u8(cp, buffer));
+      break;
+    }
+
+    default:
+      return zs::errc::invalid_token;
+    }
+  }
+
+  return {};
+}
+
+zs::error_result json_document::to_object(uint32_t index, object& output) const {
+  const entry& e = _tape[index];
+
+  switch (e.type) {
+  case value_type::object: {
+    output = zs::_t(_engine);
+    zs::table_map& map = *output.get_table_internal_map();
+    map.reserve(e.size);
+
+    zs::string buffer((zs::string_allocator(_engine)));
+
+    for (uint32_t i = index + 1; i < e.next; i = _tape[i + 1].next) {
+      object key;
+
+      if (_tape[i].escaped) {
+        buffer.clear();
+        ZS_RETURN_IF_ERROR(get_string(i, buffer));
+        key = zs::object::create_interned_string(_engine, buffer);
+      }
+      else {
+        key = zs::object::create_interned_string(_engine, get_raw_string(i));
+      }
+
+      object value;
+      ZS_RETURN_IF_ERROR(to_object(i + 1, value));
+      map.insert_or_assign(std::move(key), std::move(value));
+    }
+
+    return {};
+  }
+
+  case value_type::array: {
+    output = zs::_a(_engine, 0);
+    zs::vector<object>& vec = *output.get_array_internal_vector();
+    vec.reserve(e.size);
+
+    for (uint32_t i = index + 1; i < e.next; i = _tape[i].next) {
+      object value;
+      ZS_RETURN_IF_ERROR(to_object(i, value));
+      vec.push_back(std::move(value));
+    }
+
+    return {};
+  }
+
+  case value_type::string: {
+    if (!e.escaped) {
+      output = zs::_s(_engine, get_raw_string(index));
+      return {};
+    }
+
+    zs::string buffer((zs::string_allocator(_engine)));
+    ZS_RETURN_IF_ERROR(get_string(index, buffer));
+    output = zs::_s(_engine, buffer);
+    return {};
+  }
+
+  case value_type::integer: {
+    const std::string_view str = _content.substr(e.offset, e.size);
+
+    int64_t value;
+    if (auto res = zb::from_chars(str, value); res and res.value() == str.data() + str.size()) {
+      output = (int_t)value;
+      return {};
+    }
+
+    // Out of the integer range.
+    double dvalue;
+    if (auto res = zb::from_chars(str, dvalue); res and res.value() == str.data() + str.size()) {
+      output = (float_t)dvalue;
+      return {};
+    }
+
+    return zs::errc::invalid_number;
+  }
+
+  case value_type::floating: {
+    const std::string_view str = _content.substr(e.offset, e.size);
+
+    double value;
+    if (auto res = zb::from_chars(str, value); res and res.value() == str.data() + str.size()) {
+      output = (float_t)value;
+      return {};
+    }
+
+    return zs::errc::invalid_number;
+  }
+
+  case value_type::true_value:
+  case value_type::false_value:
+    output = e.type == value_type::true_value;
+    return {};
+
+  case value_type::null:
+    output.reset();
+    return {};
+  }
+
+  return zs::errc::invalid_type;
+}
+} // namespace zs.
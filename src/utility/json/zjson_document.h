@@ -0,0 +1,105 @@
+// MIT License
+//
+// Copyright (c) 2024 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <zscript/zscript.h>
+
+namespace zs {
+
+/// JSON document indexed for random access.
+///
+/// The content is parsed in two passes:
+/// - The structural index: the content is classified 64 bytes at a time (with
+///   SSE2 when available) into bitmasks of quotes, backslashes, structural
+///   characters and white spaces. The masks give the escaped characters and the
+///   string ranges without looking at the bytes one by one. The positions of the
+///   structural characters outside of the strings and of the first character of
+///   each scalar are collected.
+/// - The tape: the index is walked once to validate the grammar and to write one
+///   entry per value. A container entry knows where its subtree ends, walking a
+///   container skips the nested ones in constant time.
+///
+/// `parse()` creates no objects, `to_object()` converts a whole value while
+/// `find()` and `at()` only read the entries on their way.
+/// The content must outlive the document.
+class json_document : public engine_holder {
+public:
+  enum class value_type : uint8_t { object, array, string, integer, floating, true_value, false_value, null };
+
+  struct entry {
+    value_type type;
+
+    /// Strings only, the content has escape sequences.
+    bool escaped;
+
+    /// Offset of the first character in the content.
+    uint32_t offset;
+
+    /// Index of the entry following this value and its children.
+    uint32_t next;
+
+    /// Number of members or elements of a container, length of a string or number.
+    uint32_t size;
+  };
+
+  json_document(zs::engine* eng);
+
+  ZS_CHECK zs::error_result parse(std::string_view content);
+
+  ZS_CK_INLINE std::string_view get_content() const noexcept { return _content; }
+
+  ZS_CK_INLINE const entry& get_entry(uint32_t index) const noexcept { return _tape[index]; }
+
+  ZS_CK_INLINE bool is_container(uint32_t index) const noexcept {
+    return _tape[index].type == value_type::object or _tape[index].type == value_type::array;
+  }
+
+  /// Returns the index of the value of the member `key` of the object at `index`, or -1.
+  ZS_CHECK int_t find(uint32_t index, std::string_view key) const;
+
+  /// Returns the index of the element `i` of the array at `index`, or -1.
+  ZS_CHECK int_t at(uint32_t index, size_t i) const noexcept;
+
+  /// Converts the value at `index` and all its children.
+  ZS_CHECK zs::error_result to_object(uint32_t index, object& output) const;
+
+private:
+  struct helper;
+
+  std::string_view _content;
+  zs::vector<uint32_t> _structurals;
+  zs::vector<uint32_t> _string_ends;
+  zs::vector<entry> _tape;
+
+  zs::error_result build_structural_index();
+  zs::error_result build_tape();
+
+  /// Raw content of the string at `index`, between the quotes.
+  ZS_CK_INLINE std::string_view get_raw_string(uint32_t index) const noexcept {
+    return _content.substr(_tape[index].offset + 1, _tape[index].size);
+  }
+
+  zs::error_result get_string(uint32_t index, zs::string& output) const;
+};
+} // namespace zs.
@@ -169,10 +169,10 @@ zs::error_result json_parser::parse_table_value(zs::object& key, zs::object& val
   using enum json_token_type;
 
   if (is(tok_string_value)) {
-    key = zs::_s(_engine, _lexer->get_string_value());
+    key = zs::object::create_interned_string(_engine, _lexer->get_string_value());
   }
   else if (is(tok_escaped_string_value)) {
-    key = zs::_s(_engine, _lexer->get_escaped_string_value());
+    key = zs::object::create_interned_string(_engine, _lexer->get_escaped_string_value());
   }
   else {
     return zs::error_code::invalid_token;
@@ -0,0 +1,128 @@
+#include "utility/zbytecode_cache.h"
+#include "zvirtual_machine.h"
+#include "object/zfunction_prototype.h"
+
+#include <chrono>
+#include <cstdio>
+
+#define XXH_INLINE_ALL
+#include <zscript/base/crypto/xxhash.h>
+
+namespace zs {
+
+namespace {
+  ZS_CK_INLINE uint64_t hash_bytes(const void* data, size_t size) noexcept { return XXH3_64bits(data, size); }
+
+  /// `<cache directory>/<hash of the source path>.zsbc`.
+  std::filesystem::path get_entry_path(zs::engine* eng, std::string_view filename) {
+    const object& dir = eng->get_bytecode_cache_directory();
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.zsbc",
+        (unsigned long long)hash_bytes(filename.data(), filename.size()));
+
+    return std::filesystem::path(std::string_view(dir.get_string_unchecked())) / name;
+  }
+
+  ZS_CK_INLINE bytecode_cache_header create_header(zb::byte_view content, size_t data_size) noexcept {
+    return bytecode_cache_header{ bytecode_cache_header::k_magic, bytecode_cache_header::k_format_version,
+      zs::k_version, (uint32_t)opcode::count, hash_bytes(content.data(), content.size()), data_size };
+  }
+
+  ZS_CK_INLINE bool is_same_header(
+      const bytecode_cache_header& lhs, const bytecode_cache_header& rhs) noexcept {
+    return lhs.magic == rhs.magic and lhs.format_version == rhs.format_version
+        and lhs.version.major == rhs.version.major and lhs.version.minor == rhs.version.minor
+        and lhs.version.patch == rhs.version.patch and lhs.version.build == rhs.version.build
+        and lhs.opcode_count == rhs.opcode_count and lhs.source_hash == rhs.source_hash;
+  }
+} // namespace.
+
+zs::error_result load_cached_bytecode(
+    zs::vm_ref vm, std::string_view filename, zb::byte_view content, object& output_closure) {
+  zs::engine* eng = vm.get_engine();
+
+  if (!eng->get_bytecode_cache_directory().is_string()) {
+    return zs::errc::not_found;
+  }
+
+  zs::file_loader loader(eng);
+  if (auto err = loader.open(get_entry_path(eng, filename).string())) {
+    return zs::errc::not_found;
+  }
+
+  const zb::byte_view entry = loader.data();
+  if (entry.size() < sizeof(bytecode_cache_header)) {
+    return zs::errc::not_found;
+  }
+
+  bytecode_cache_header header;
+  ::memcpy(&header, entry.data(), sizeof(bytecode_cache_header));
+
+  const zb::byte_view data = entry.subspan(sizeof(bytecode_cache_header));
+
+  if (!is_same_header(header, create_header(content, data.size())) or header.data_size != data.size()
+      or !function_prototype_object::is_compiled_data(data)) {
+    return zs::errc::not_found;
+  }
+
+  object fpo = zs::function_prototype_object::create(eng);
+  if (auto err = function_prototype_object::as_proto(fpo).load(data)) {
+    return zs::errc::not_found;
+  }
+
+  output_closure = zs::_c(eng, std::move(fpo), vm->global());
+  return {};
+}
+
+zs::error_result store_cached_bytecode(
+    zs::engine* eng, std::string_view filename, zb::byte_view content, const object& closure) {
+
+  if (!eng->get_bytecode_cache_directory().is_string() or !closure.is_closure()) {
+    return zs::errc::invalid_operation;
+  }
+
+  zb::byte_vector data;
+  if (auto err = closure.as_closure().get_function_prototype()->save(data)) {
+    return err;
+  }
+
+  const bytecode_cache_header header = create_header(content, data.size());
+  const std::filesystem::path entry_path = get_entry_path(eng, filename);
+
+  // Two processes writing the same entry don't share their temporary file.
+  const uint64_t tmp_id[2] = { (uint64_t)(uintptr_t)&header,
+    (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count() };
+
+  char tmp_ext[32];
+  std::snprintf(
+      tmp_ext, sizeof(tmp_ext), ".%016llx.tmp", (unsigned long long)hash_bytes(tmp_id, sizeof(tmp_id)));
+
+  std::filesystem::path tmp_path = entry_path;
+  tmp_path += tmp_ext;
+
+  FILE* file = std::fopen(tmp_path.string().c_str(), "wb");
+  if (!file) {
+    return zs::errc::open_file_error;
+  }
+
+  const bool written = std::fwrite(&header, sizeof(header), 1, file) == 1
+      and std::fwrite(data.data(), 1, data.size(), file) == data.size();
+
+  if (std::fclose(file) != 0 or !written) {
+    std::error_code ec;
+    std::filesystem::remove(tmp_path, ec);
+    return zs::errc::open_file_error;
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(tmp_path, entry_path, ec);
+
+  if (ec) {
+    std::filesystem::remove(tmp_path, ec);
+    return zs::errc::open_file_error;
+  }
+
+  return {};
+}
+} // namespace zs.
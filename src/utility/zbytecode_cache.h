@@ -0,0 +1,61 @@
+// MIT License
+//
+// Copyright (c) 2024 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <zscript/zscript.h>
+
+namespace zs {
+
+/// On-disk cache of the compiled source files (see `engine::set_bytecode_cache_directory()`).
+///
+/// There is one entry per source path, named after the hash of the path. An
+/// entry starts with a `bytecode_cache_header` followed by the output of
+/// `function_prototype_object::save()`. It is only used when the hash of the
+/// source content, the zscript version and the cache format all match,
+/// otherwise the source is compiled again and the entry is replaced.
+struct bytecode_cache_header {
+  static constexpr std::array<uint8_t, 4> k_magic = { 'Z', 'S', 'B', 'C' };
+
+  /// Bumped when the bytecode or its serialization changes.
+  static constexpr uint32_t k_format_version = 2;
+
+  std::array<uint8_t, 4> magic;
+  uint32_t format_version;
+  zs::version_t version;
+  uint32_t opcode_count;
+  uint64_t source_hash;
+  uint64_t data_size;
+};
+
+/// Loads the cached closure of `filename` if its entry matches `content`.
+/// Returns `errc::not_found` when there is no valid entry.
+ZS_CHECK zs::error_result load_cached_bytecode(
+    zs::vm_ref vm, std::string_view filename, zb::byte_view content, object& output_closure);
+
+/// Writes the function prototype of `closure`, freshly compiled from `content`,
+/// as the cache entry of `filename`. The entry is written to a temporary file
+/// first and renamed, concurrent processes never see a partial entry.
+ZS_CHECK zs::error_result store_cached_bytecode(
+    zs::engine* eng, std::string_view filename, zb::byte_view content, const object& closure);
+
+} // namespace zs.
@@ -0,0 +1,182 @@
+#include "utility/zdata_parser.h"
+#include "lex/zlexer.h"
+
+namespace zs {
+
+data_parser::data_parser(zs::engine* eng)
+    : engine_holder(eng) {}
+
+void data_parser::lex() { _token = _lexer->lex(); }
+
+zs::error_result data_parser::parse(std::string_view content, object& output) {
+  using enum token_type;
+
+  zs::lexer lexer(_engine, content);
+  _lexer = &lexer;
+  lex();
+
+  object value;
+  ZS_RETURN_IF_ERROR(parse_value(value));
+
+  if (_token == tok_semi_colon) {
+    lex();
+  }
+
+  if (_token != tok_eof) {
+    return zs::errc::unimplemented;
+  }
+
+  output = std::move(value);
+  return {};
+}
+
+bool data_parser::is_value_end() const noexcept {
+  using enum token_type;
+  return zb::is_one_of(_token, tok_comma, tok_rcrlbracket, tok_rsqrbracket, tok_identifier, tok_string_value,
+      tok_escaped_string_value, tok_semi_colon, tok_eof);
+}
+
+zs::error_result data_parser::parse_value(object& value) {
+  using enum token_type;
+
+  switch (_token) {
+  case tok_lcrlbracket:
+    ZS_RETURN_IF_ERROR(parse_table(value));
+    break;
+
+  case tok_lsqrbracket:
+    ZS_RETURN_IF_ERROR(parse_array(value));
+    break;
+
+  case tok_null:
+  case tok_none:
+  case tok_true:
+  case tok_false:
+  case tok_char_value:
+  case tok_integer_value:
+  case tok_float_value:
+  case tok_string_value:
+  case tok_escaped_string_value:
+    value = _lexer->get_value();
+    lex();
+    break;
+
+  case tok_sub:
+    lex();
+
+    if (_token == tok_integer_value) {
+      value = -_lexer->get_int_value();
+    }
+    else if (_token == tok_float_value) {
+      value = -_lexer->get_float_value();
+    }
+    else {
+      return zs::errc::unimplemented;
+    }
+
+    lex();
+    break;
+
+  default:
+    return zs::errc::unimplemented;
+  }
+
+  return is_value_end() ? zs::errc::success : zs::errc::unimplemented;
+}
+
+zs::error_result data_parser::parse_array(object& value) {
+  using enum token_type;
+
+  // Skip the '['.
+  lex();
+
+  value = zs::_a(_engine, 0);
+  zs::array_object& arr = value.as_array();
+
+  // Same as the compiler, the commas are optional.
+  while (_token != tok_rsqrbracket) {
+    object item;
+    ZS_RETURN_IF_ERROR(parse_value(item));
+    arr.push_back(std::move(item));
+
+    if (_token == tok_comma) {
+      lex();
+    }
+  }
+
+  lex();
+  return {};
+}
+
+zs::error_result data_parser::parse_key(object& key) {
+  using enum token_type;
+
+  switch (_token) {
+  case tok_identifier:
+    key = zs::_s(_engine, _lexer->get_identifier_value());
+    lex();
+    return _token == tok_eq ? zs::errc::success : zs::errc::unimplemented;
+
+  case tok_string_value:
+  case tok_escaped_string_value:
+    key = _lexer->get_value();
+    lex();
+    return _token == tok_colon ? zs::errc::success : zs::errc::unimplemented;
+
+  case tok_lsqrbracket:
+    lex();
+
+    // Only the keys that the table accepts at runtime.
+    if (!zb::is_one_of(_token, tok_integer_value, tok_char_value, tok_float_value, tok_string_value,
+            tok_escaped_string_value, tok_true, tok_false)) {
+      return zs::errc::unimplemented;
+    }
+
+    key = _lexer->get_value();
+    lex();
+
+    if (_token != tok_rsqrbracket) {
+      return zs::errc::unimplemented;
+    }
+
+    lex();
+    return _token == tok_eq ? zs::errc::success : zs::errc::unimplemented;
+
+  default:
+    return zs::errc::unimplemented;
+  }
+}
+
+zs::error_result data_parser::parse_table(object& value) {
+  using enum token_type;
+
+  // Skip the '{'.
+  lex();
+
+  value = zs::_t(_engine);
+  zs::table_object& tbl = value.as_table();
+
+  // Same as the compiler, the commas are optional.
+  while (_token != tok_rcrlbracket) {
+    object key;
+    ZS_RETURN_IF_ERROR(parse_key(key));
+
+    // Skip the '=' or ':'.
+    lex();
+
+    object item;
+    ZS_RETURN_IF_ERROR(parse_value(item));
+    (void)tbl.set(std::move(key), std::move(item));
+
+    if (_token == tok_comma) {
+      lex();
+    }
+    else if (_token == tok_rsqrbracket) {
+      return zs::errc::unimplemented;
+    }
+  }
+
+  lex();
+  return {};
+}
+} // namespace zs.
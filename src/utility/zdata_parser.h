@@ -0,0 +1,61 @@
+// MIT License
+//
+// Copyright (c) 2024 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <zscript/zscript.h>
+#include "lex/ztoken.h"
+
+namespace zs {
+
+class lexer;
+
+/// Builds the value of a data file in one pass, without emitting bytecode.
+///
+/// Only the literal subset of the language is accepted: tables, arrays,
+/// strings, numbers, bools, null and none. The table keys are identifiers
+/// (`key = value`), strings (`"key": value`) or literals (`[1] = value`).
+/// Anything else (an expression, a variable, a function, ...) makes `parse()`
+/// return `errc::unimplemented` and the content has to be compiled instead.
+class data_parser : public engine_holder {
+public:
+  data_parser(zs::engine* eng);
+
+  ZS_CHECK zs::error_result parse(std::string_view content, object& output);
+
+private:
+  zs::lexer* _lexer = nullptr;
+  zs::token_type _token = token_type::tok_none;
+
+  zs::error_result parse_value(object& value);
+  zs::error_result parse_table(object& value);
+  zs::error_result parse_array(object& value);
+  zs::error_result parse_key(object& key);
+
+  /// A value is followed by a separator, a closing bracket or the next key.
+  /// Anything else is part of an expression.
+  ZS_CHECK bool is_value_end() const noexcept;
+
+  void lex();
+};
+} // namespace zs.
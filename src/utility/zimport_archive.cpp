@@ -0,0 +1,170 @@
+#include "utility/zimport_archive.h"
+
+#define MINIZ_HEADER_FILE_ONLY
+#include "zbase/sys/zip/zip_file.h"
+
+namespace zs {
+
+namespace {
+  inline constexpr object k_import_archive_uid = _sv("__import_archive_object__");
+} // namespace.
+
+import_archive::import_archive(zs::engine* eng)
+    : engine_holder(eng)
+    , _index(zs::unordered_map_allocator<object, uint32_t>(eng))
+    , _names(zs::allocator<object>(eng))
+    , _buffer(zs::allocator<uint8_t>(eng)) {}
+
+import_archive::~import_archive() {
+  if (_archive) {
+    mz_zip_reader_end(_archive);
+    _engine->deallocate(_archive, (alloc_info_t)memory_tag::nt_engine);
+  }
+}
+
+zs::error_result import_archive::open(const char* path) {
+  if (_archive) {
+    return zs::errc::invalid_operation;
+  }
+
+  if (auto err = _file.open(path)) {
+    return zs::errc::open_file_error;
+  }
+
+  _archive = (mz_zip_archive*)_engine->allocate(sizeof(mz_zip_archive), (alloc_info_t)memory_tag::nt_engine);
+  ::memset(_archive, 0, sizeof(mz_zip_archive));
+
+  // The central directory is indexed below, miniz doesn't need to sort it.
+  if (!mz_zip_reader_init_mem(
+          _archive, _file.data(), _file.size(), MZ_ZIP_FLAG_DO_NOT_SORT_CENTRAL_DIRECTORY)) {
+    _engine->deallocate(_archive, (alloc_info_t)memory_tag::nt_engine);
+    _archive = nullptr;
+    _file.close();
+    return zs::errc::invalid_include_file;
+  }
+
+  _path = zs::_s(_engine, path);
+
+  const mz_uint count = mz_zip_reader_get_num_files(_archive);
+  _index.reserve(count);
+  _names.reserve(count);
+
+  for (mz_uint i = 0; i < count; i++) {
+    mz_zip_archive_file_stat stat;
+    if (!mz_zip_reader_file_stat(_archive, i, &stat)) {
+      return zs::errc::invalid_include_file;
+    }
+
+    object name = zs::_s(_engine, std::string_view(stat.m_filename));
+    _names.push_back(name);
+
+    if (!mz_zip_reader_is_file_a_directory(_archive, i)) {
+      _index.emplace(std::move(name), (uint32_t)i);
+    }
+  }
+
+  return {};
+}
+
+int_t import_archive::find(std::string_view name) const noexcept {
+  auto it = _index.find(name);
+  return it == _index.end() ? -1 : (int_t)it->second;
+}
+
+int_t import_archive::find_module(std::string_view import_value) const {
+  zs::string name(import_value, zs::string_allocator(_engine));
+
+  const auto find_with_extension = [&](std::string_view ext) {
+    const size_t sz = name.size();
+    name.append(ext);
+    const int_t index = find(name);
+    name.resize(sz);
+    return index;
+  };
+
+  if (name.ends_with(".zs")) {
+    if (int_t index = find_with_extension("c"); index != -1) {
+      return index;
+    }
+
+    return find(name);
+  }
+
+  if (int_t index = find_with_extension(".zsc"); index != -1) {
+    return index;
+  }
+
+  if (int_t index = find_with_extension(".zs"); index != -1) {
+    return index;
+  }
+
+  if (name.contains('.')) {
+    zs::string fpath_str = name;
+    std::replace(name.begin(), name.end(), '.', '/');
+
+    if (int_t index = find_with_extension(".zsc"); index != -1) {
+      return index;
+    }
+
+    if (int_t index = find_with_extension(".zs"); index != -1) {
+      return index;
+    }
+
+    name = std::move(fpath_str);
+  }
+
+  return find(name);
+}
+
+zs::error_result import_archive::read(int_t index, zb::byte_view& output) {
+  if (!_archive or index < 0 or index >= (int_t)_names.size()) {
+    return zs::errc::out_of_bounds;
+  }
+
+  mz_zip_archive_file_stat stat;
+  if (!mz_zip_reader_file_stat(_archive, (mz_uint)index, &stat)) {
+    return zs::errc::invalid_include_file;
+  }
+
+  _buffer.resize((size_t)stat.m_uncomp_size);
+
+  if (!mz_zip_reader_extract_to_mem(_archive, (mz_uint)index, _buffer.data(), _buffer.size(), 0)) {
+    return zs::errc::invalid_include_file;
+  }
+
+  output = zb::byte_view(_buffer.data(), _buffer.size());
+  return {};
+}
+
+object import_archive::get_entry_path(int_t index) const {
+  zs::string path(_path.get_string_unchecked(), zs::string_allocator(_engine));
+  path.push_back('/');
+  path.append(_names[index].get_string_unchecked());
+  return zs::_s(_engine, path);
+}
+
+bool is_import_archive(const object& obj) noexcept {
+  return obj.is_user_data() and obj.as_udata().get_uid() == k_import_archive_uid;
+}
+
+import_archive& as_import_archive(const object& obj) noexcept {
+  return obj.as_udata().data_ref<import_archive>();
+}
+
+zs::error_result create_import_archive(zs::engine* eng, const char* path, object& output) {
+  user_data_object* uobj = user_data_object::create<import_archive>(eng, eng);
+  if (!uobj) {
+    return zs::errc::out_of_memory;
+  }
+
+  uobj->set_uid(k_import_archive_uid);
+  object obj(uobj, false);
+
+  if (auto err = as_import_archive(obj).open(path)) {
+    return err;
+  }
+
+  output = std::move(obj);
+  return {};
+}
+} // namespace zs.
@@ -0,0 +1,81 @@
+// MIT License
+//
+// Copyright (c) 2024 Alexandre Arsenault
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <zscript/zscript.h>
+#include <zscript/base/sys/file_view.h>
+
+struct mz_zip_archive_tag;
+
+namespace zs {
+
+/// Zip archive used as an import root (see `engine::add_import_archive()`).
+///
+/// The archive is mapped and its central directory is indexed once by entry
+/// name, finding a module costs a hash lookup instead of a stat per candidate
+/// path. Entries are decompressed into a buffer that is reused by every read.
+class import_archive : public engine_holder {
+public:
+  import_archive(zs::engine* eng);
+  ~import_archive();
+
+  import_archive(const import_archive&) = delete;
+  import_archive& operator=(const import_archive&) = delete;
+
+  ZS_CHECK zs::error_result open(const char* path);
+
+  /// Returns the index of the entry `name` or -1.
+  ZS_CHECK int_t find(std::string_view name) const noexcept;
+
+  /// Returns the index of the entry of the module `import_value` or -1.
+  /// The candidate names are the same as in `engine::resolve_file_path()`.
+  ZS_CHECK int_t find_module(std::string_view import_value) const;
+
+  /// Decompresses the entry at `index`.
+  /// The output is valid until the next call to `read()`.
+  ZS_CHECK zs::error_result read(int_t index, zb::byte_view& output);
+
+  /// `<archive path>/<entry name>`, used as module name and filename.
+  ZS_CHECK object get_entry_path(int_t index) const;
+
+  ZS_CK_INLINE const object& get_path() const noexcept { return _path; }
+
+private:
+  zb::file_view _file;
+  mz_zip_archive_tag* _archive = nullptr;
+  object _path;
+  zs::object_unordered_map<uint32_t> _index;
+  zs::vector<object> _names;
+  zs::vector<uint8_t> _buffer;
+};
+
+/// Returns true if 'obj' is an import archive.
+ZS_CHECK bool is_import_archive(const object& obj) noexcept;
+
+ZS_CHECK import_archive& as_import_archive(const object& obj) noexcept;
+
+/// Creates and opens an import archive user data.
+ZS_CHECK zs::error_result create_import_archive(zs::engine* eng, const char* path, object& output);
+
+} // namespace zs.
@@ -0,0 +1,254 @@
+#include <zscript/utility/pool_allocator.h>
+
+namespace zs {
+
+struct pool_allocator::slab_header {
+  size_t size_class;
+  size_t padding;
+};
+
+struct pool_allocator::large_header {
+  large_header* prev;
+  large_header* next;
+  size_t size;
+  size_t padding;
+};
+
+static_assert(zb::is_power_of_two(pool_allocator::k_slab_size), "the slab size must be a power of two");
+
+pool_allocator::~pool_allocator() {
+  for (uintptr_t slab : _slabs) {
+    zb::aligned_deallocate((void*)slab);
+  }
+
+  while (_large_allocations) {
+    large_header* next = _large_allocations->next;
+    ::free(_large_allocations);
+    _large_allocations = next;
+  }
+}
+
+void* pool_allocator::allocate_callback(
+    zs::engine* eng, raw_pointer_t user_ptr, void* ptr, size_t size, size_t old_size, alloc_info_t info) {
+  zbase_assert(user_ptr, "invalid pool allocator");
+  pool_allocator* pool = (pool_allocator*)user_ptr;
+
+  if (!size) {
+    zbase_assert(ptr, "invalid pointer");
+    pool->deallocate(ptr, info);
+    return nullptr;
+  }
+
+  if (ptr) {
+    return pool->reallocate(ptr, size, info);
+  }
+
+  return pool->allocate(size, info);
+}
+
+void pool_allocator::release(allocate_t alloc_cb, raw_pointer_t user_ptr) {
+  zbase_assert(alloc_cb == &pool_allocator::allocate_callback, "invalid pool allocator callback");
+  delete (pool_allocator*)user_ptr;
+}
+
+config_t pool_allocator::create_config(size_t stack_size) {
+  config_t config;
+  config.stack_size = stack_size;
+  config.alloc_callback = &pool_allocator::allocate_callback;
+  config.user_pointer = new pool_allocator();
+  config.user_release = &pool_allocator::release;
+  return config;
+}
+
+pool_allocator* pool_allocator::get(zs::engine* eng) noexcept {
+  return eng->get_allocate_callback() == &pool_allocator::allocate_callback
+      ? (pool_allocator*)eng->get_user_pointer()
+      : nullptr;
+}
+
+void* pool_allocator::allocate(size_t size, alloc_info_t info) {
+  tag_stats& tstats = get_tag_stats(info);
+  tstats.allocations++;
+  tstats.allocated_bytes += size;
+
+  if (size > k_max_small_size) {
+    void* ptr = allocate_large(size);
+    if (ptr) {
+      add_live_bytes(size);
+    }
+    return ptr;
+  }
+
+  const size_t size_class = get_size_class(size);
+  void* ptr = allocate_small(size_class);
+  if (ptr) {
+    add_live_bytes(get_class_size(size_class));
+  }
+  return ptr;
+}
+
+void* pool_allocator::reallocate(void* ptr, size_t size, alloc_info_t info) {
+  tag_stats& tstats = get_tag_stats(info);
+  tstats.reallocations++;
+
+  const size_t block_size = get_block_size(ptr);
+
+  // Still fits in the same size class.
+  if (size <= k_max_small_size and block_size <= k_max_small_size
+      and get_size_class(size) == get_size_class(block_size)) {
+    return ptr;
+  }
+
+  if (size > k_max_small_size and block_size > k_max_small_size) {
+    large_header* header = ((large_header*)ptr) - 1;
+    large_header* prev = header->prev;
+    large_header* next = header->next;
+
+    large_header* new_header = (large_header*)::realloc(header, sizeof(large_header) + size);
+    if (!new_header) {
+      return nullptr;
+    }
+
+    if (prev) {
+      prev->next = new_header;
+    }
+    else {
+      _large_allocations = new_header;
+    }
+
+    if (next) {
+      next->prev = new_header;
+    }
+
+    tstats.allocated_bytes += size;
+    _stats.live_bytes -= block_size;
+    add_live_bytes(size);
+
+    new_header->size = size;
+    return new_header + 1;
+  }
+
+  // Moving between the small and large allocations, or between two size classes.
+  void* new_ptr = allocate(size, info);
+  if (!new_ptr) {
+    return nullptr;
+  }
+
+  // `allocate()` counted a new allocation.
+  tstats.allocations--;
+
+  zb::memcpy(new_ptr, ptr, zb::minimum(size, block_size));
+  deallocate(ptr, info);
+  tstats.deallocations--;
+  return new_ptr;
+}
+
+void pool_allocator::deallocate(void* ptr, alloc_info_t info) {
+  get_tag_stats(info).deallocations++;
+
+  if (slab_header* slab = find_slab(ptr)) {
+    _stats.live_bytes -= get_class_size(slab->size_class);
+
+    free_block* block = (free_block*)ptr;
+    block->next = _free_lists[slab->size_class];
+    _free_lists[slab->size_class] = block;
+    return;
+  }
+
+  large_header* header = ((large_header*)ptr) - 1;
+  _stats.live_bytes -= header->size;
+  _stats.large_allocation_count--;
+
+  if (header->prev) {
+    header->prev->next = header->next;
+  }
+  else {
+    _large_allocations = header->next;
+  }
+
+  if (header->next) {
+    header->next->prev = header->prev;
+  }
+
+  ::free(header);
+}
+
+void* pool_allocator::allocate_small(size_t size_class) {
+  if (free_block* block = _free_lists[size_class]) {
+    _free_lists[size_class] = block->next;
+    return block;
+  }
+
+  const size_t class_size = get_class_size(size_class);
+  slab_range& range = _slab_ranges[size_class];
+
+  if ((size_t)(range.end - range.begin) < class_size) {
+    uint8_t* slab = (uint8_t*)zb::aligned_allocate(k_slab_size, k_slab_size);
+    if (!slab) {
+      return nullptr;
+    }
+
+    zb_placement_new(slab) slab_header{ size_class, 0 };
+    _slabs.insert((uintptr_t)slab);
+    _stats.slab_count++;
+
+    range.begin = slab + sizeof(slab_header);
+    range.end = slab + k_slab_size;
+  }
+
+  void* ptr = range.begin;
+  range.begin += class_size;
+  return ptr;
+}
+
+void* pool_allocator::allocate_large(size_t size) {
+  large_header* header = (large_header*)::malloc(sizeof(large_header) + size);
+  if (!header) {
+    return nullptr;
+  }
+
+  header->prev = nullptr;
+  header->next = _large_allocations;
+  header->size = size;
+
+  if (_large_allocations) {
+    _large_allocations->prev = header;
+  }
+
+  _large_allocations = header;
+  _stats.large_allocation_count++;
+  return header + 1;
+}
+
+pool_allocator::slab_header* pool_allocator::find_slab(void* ptr) const noexcept {
+  // A large allocation can't be inside a slab, masking its address never gives a slab.
+  const uintptr_t slab = (uintptr_t)ptr & ~(uintptr_t)(k_slab_size - 1);
+  return _slabs.contains(slab) ? (slab_header*)slab : nullptr;
+}
+
+size_t pool_allocator::get_block_size(void* ptr) const noexcept {
+  if (slab_header* slab = find_slab(ptr)) {
+    return get_class_size(slab->size_class);
+  }
+
+  return (((large_header*)ptr) - 1)->size;
+}
+
+void pool_allocator::add_live_bytes(size_t size) noexcept {
+  _stats.live_bytes += size;
+  _stats.peak_live_bytes = zb::maximum(_stats.peak_live_bytes, _stats.live_bytes);
+}
+
+pool_allocator::tag_stats& pool_allocator::get_tag_stats(alloc_info_t info) noexcept {
+  switch (info) {
+  case constants::k_engine_deallocation:
+    return _stats.tags[(size_t)memory_tag::nt_engine];
+
+  case constants::k_user_pointer_deallocation:
+    return _stats.tags[(size_t)memory_tag::nt_unknown];
+
+  default:
+    return _stats.tags[info < k_memory_tag_count ? info : (size_t)memory_tag::nt_unknown];
+  }
+}
+} // namespace zs.
@@ -1,44 +1,197 @@
 #include <zscript/utility/string_template.h>
 #include "zvirtual_machine.h"
 #include "jit/zjit_compiler.h"
+#include "object/zfunction_prototype.h"
+#include "utility/zparameter_stream.h"
+
+#define XXH_INLINE_ALL
+#include <zscript/base/crypto/xxhash.h>
 
 namespace zs {
 
-static zs::object get_content(zs::vm_ref vm, const zs::object& tbl, std::string_view content) {
+namespace {
+  inline constexpr object k_string_template_uid = _sv("__string_template_object__");
+  inline constexpr object k_string_template_delegate_id = _sv("__string_template_delegate__");
+  inline constexpr object k_string_template_cache_id = _sv("__string_template_cache__");
+
+  inline constexpr size_t k_default_string_template_cache_size = 256;
 
-  zs::object closure = [](zs::vm_ref vm, std::string_view content) -> zs::object {
-    zs::jit_compiler compiler(vm.get_engine());
+  /// Compiled without a vm, the templates of `render_template_string()` are shared
+  /// by all the vms of the engine.
+  zs::object compile_fragment(zs::engine* eng, std::string_view content) {
+    zs::jit_compiler compiler(eng);
     zs::object fct_state;
 
     zs::token_type tok = zs::token_type::tok_return;
-    if (auto err = compiler.compile(content, "stemplate", fct_state, vm.get_virtual_machine(), &tok, false)) {
+    if (auto err = compiler.compile(content, "stemplate", fct_state, nullptr, &tok, false)) {
       return nullptr;
     }
 
-    return zs::_c(vm.get_engine(), std::move(fct_state), vm->global());
-  }(vm, content);
+    return fct_state;
+  }
+
+  /// Compiled templates of `render_template_string()`, stored in the engine registry.
+  ///
+  /// Looked up by the hash of the content and quotes, the least recently used
+  /// entry is only searched for when the cache is full and a template is added.
+  class string_template_cache : public engine_holder {
+  public:
+    struct entry {
+      uint64_t hash;
+      zs::object content;
+      zs::object l_quote;
+      zs::object r_quote;
+      zs::object tmpl;
+      uint64_t last_used;
+    };
+
+    inline string_template_cache(zs::engine* eng)
+        : engine_holder(eng)
+        , _entries(zs::allocator<entry>(eng))
+        , _indices(zs::unordered_map_allocator<uint64_t, size_t>(eng)) {}
+
+    static string_template_cache& get(zs::engine* eng) {
+      object& obj = eng->get_registry_table_object()[k_string_template_cache_id];
+
+      if (!obj.is_user_data()) {
+        obj = zs::object(user_data_object::create<string_template_cache>(eng, eng), false);
+      }
+
+      return obj.as_udata().data_ref<string_template_cache>();
+    }
+
+    static uint64_t hash(std::string_view content, std::string_view l_quote, std::string_view r_quote) {
+      const uint64_t quotes_hash
+          = XXH3_64bits_withSeed(l_quote.data(), l_quote.size(), XXH3_64bits(r_quote.data(), r_quote.size()));
+      return XXH3_64bits_withSeed(content.data(), content.size(), quotes_hash);
+    }
+
+    /// Returns the template object of `content` or null.
+    /// A copy is returned, rendering can add templates and drop this one from the cache.
+    zs::object find(
+        uint64_t h, std::string_view content, std::string_view l_quote, std::string_view r_quote) {
+      auto it = _indices.find(h);
+      if (it == _indices.end()) {
+        return nullptr;
+      }
+
+      entry& e = _entries[it->second];
+      if (e.content != content or e.l_quote != l_quote or e.r_quote != r_quote) {
+        return nullptr;
+      }
+
+      e.last_used = ++_tick;
+      return e.tmpl;
+    }
+
+    void insert(uint64_t h, std::string_view content, std::string_view l_quote, std::string_view r_quote,
+        const zs::object& tmpl) {
+      if (!_max_size) {
+        return;
+      }
+
+      entry e = { h, zs::_s(_engine, content), zs::_s(_engine, l_quote), zs::_s(_engine, r_quote), tmpl,
+        ++_tick };
+
+      // Another content with the same hash gets replaced.
+      if (auto it = _indices.find(h); it != _indices.end()) {
+        _entries[it->second] = std::move(e);
+        return;
+      }
+
+      if (_entries.size() >= _max_size) {
+        remove(get_least_recently_used());
+      }
+
+      _indices[h] = _entries.size();
+      _entries.push_back(std::move(e));
+    }
+
+    void clear() {
+      _entries.clear();
+      _indices.clear();
+    }
+
+    void set_max_size(size_t size) {
+      _max_size = size;
+
+      while (_entries.size() > _max_size) {
+        remove(get_least_recently_used());
+      }
+    }
+
+  private:
+    zs::vector<entry> _entries;
+    zs::unordered_map<uint64_t, size_t> _indices;
+    size_t _max_size = k_default_string_template_cache_size;
+    uint64_t _tick = 0;
+
+    size_t get_least_recently_used() const noexcept {
+      return std::distance(_entries.begin(),
+          std::min_element(_entries.begin(), _entries.end(),
+              [](const entry& lhs, const entry& rhs) { return lhs.last_used < rhs.last_used; }));
+    }
+
+    /// The last entry takes the place of the removed one.
+    void remove(size_t index) {
+      _indices.erase(_entries[index].hash);
+
+      if (index != _entries.size() - 1) {
+        _entries[index] = std::move(_entries.back());
+        _indices[_entries[index].hash] = index;
+      }
+
+      _entries.pop_back();
+    }
+  };
 
-  if (!closure.is_closure()) {
-    return nullptr;
+  int_t string_template_render_impl(zs::vm_ref vm) {
+    if (vm.stack_size() != 2 or !is_string_template(vm[0])) {
+      vm.set_error("Invalid parameters, expected template.render(table).");
+      return -1;
+    }
+
+    zs::string output(vm.get_engine());
+    if (auto err = as_string_template(vm[0]).render(vm, vm[1], output)) {
+      vm.set_error("Invalid template fragment.");
+      return -1;
+    }
+
+    return vm.push_string(output);
   }
 
-  zs::object value;
-  if (auto err = vm->call(closure, tbl, value)) {
-    return nullptr;
+  zs::object create_string_template_delegate(zs::engine* eng) {
+    using namespace literals;
+
+    table_object* tbl = table_object::create(eng);
+    tbl->reserve(4);
+
+    tbl->emplace(constants::get<meta_method::mt_typeof>(), "string_template"_ss);
+    tbl->emplace("render"_ss, string_template_render_impl);
+
+    tbl->set_no_default_none();
+    return object(tbl, false);
   }
 
-  return value;
-}
+  zs::object& get_string_template_delegate(zs::engine* eng) {
+    object& obj = eng->get_registry_table_object()[k_string_template_delegate_id];
+    return obj.is_table() ? obj : (obj = create_string_template_delegate(eng));
+  }
+} // namespace.
 
-// static inline bool is_null_none_or_error(const zs::object& obj) {
-//   return obj.is_type(zs::object_type::k_null) or obj.is_none() or obj.is_error();
-// }
+string_template::string_template(zs::engine* eng)
+    : engine_holder(eng)
+    , _chunks(zs::allocator<zs::object>(eng))
+    , _closures(zs::allocator<zs::object>(eng)) {}
 
-zs::string render_template_string(zs::vm_ref vm, const zs::object& tbl, std::string_view content,
-    std::string_view l_quote, std::string_view r_quote) {
+zs::error_result string_template::compile(
+    zs::vm_ref vm, std::string_view content, std::string_view l_quote, std::string_view r_quote) {
   zs::engine* eng = vm.get_engine();
+  zs::error_result result;
 
-  zs::string output_str(eng);
+  _chunks.clear();
+  _closures.clear();
+  _closures_root.reset();
 
   const char* it = content.data();
   const char* end = content.data() + content.size();
@@ -61,7 +214,7 @@ zs::string render_template_string(zs::vm_ref vm, const zs::object& tbl, std::str
           side = side::right;
 
           if (zs::int_t sz = it - l_begin - lq_sz; sz > 0) {
-            output_str.append(std::string_view(l_begin, sz));
+            _chunks.push_back(zs::_s(eng, std::string_view(l_begin, sz)));
           }
 
           l_begin = it;
@@ -79,15 +232,13 @@ zs::string render_template_string(zs::vm_ref vm, const zs::object& tbl, std::str
           std::string_view sstr = zb::strip_all(std::string_view(l_begin, it - rq_sz - l_begin));
 
           if (!sstr.empty()) {
-            if (auto obj = get_content(vm, tbl, sstr); !obj.is_null_or_none()) {
+            zs::object fct_state = compile_fragment(eng, sstr);
 
-              output_str.append(
-                  (zs::create_string_stream(eng) << zs::streamer<zs::serializer_type::plain>(obj)).view());
-              //              output_str.append((zs::create_string_stream(eng) << obj).view());
-            }
-            else {
-              zb::print("ERRORRRRR");
+            if (fct_state.is_null() and !result) {
+              result = zs::errc::invalid;
             }
+
+            _chunks.push_back(std::move(fct_state));
           }
 
           count_index = 0;
@@ -102,10 +253,137 @@ zs::string render_template_string(zs::vm_ref vm, const zs::object& tbl, std::str
   }
 
   if (zs::int_t sz = end - l_begin; sz > 0) {
-    output_str.append(std::string_view(l_begin, sz));
+    _chunks.push_back(zs::_s(eng, std::string_view(l_begin, sz)));
+  }
+
+  return result;
+}
+
+zs::error_result string_template::render(zs::vm_ref vm, const zs::object& tbl, zs::string& output) const {
+  zs::engine* eng = vm.get_engine();
+  const zs::object& root = vm->global();
+
+  if (!_closures_root.strict_equal(root)) {
+    _closures.assign(_chunks.size(), nullptr);
+
+    for (size_t i = 0; i < _chunks.size(); i++) {
+      if (function_prototype_object::is_proto(_chunks[i])) {
+        _closures[i] = zs::_c(eng, _chunks[i], root);
+      }
+    }
+
+    _closures_root = root;
+  }
+
+  zs::string output_str(eng);
+
+  for (size_t i = 0; i < _chunks.size(); i++) {
+    const zs::object& chunk = _chunks[i];
+
+    if (chunk.is_string()) {
+      output_str.append(chunk.get_string_unchecked());
+      continue;
+    }
+
+    // The fragment didn't compile.
+    if (chunk.is_null()) {
+      return zs::errc::invalid;
+    }
+
+    // A copy, a fragment can render this template with another vm.
+    const zs::object closure = _closures[i];
+
+    zs::object value;
+    ZS_RETURN_IF_ERROR(vm->call(closure, tbl, value));
+
+    if (!value.is_null_or_none()) {
+      output_str.append(
+          (zs::create_string_stream(eng) << zs::streamer<zs::serializer_type::plain>(value)).view());
+    }
+  }
+
+  output = std::move(output_str);
+  return {};
+}
+
+zs::error_result create_string_template(zs::vm_ref vm, std::string_view content, std::string_view l_quote,
+    std::string_view r_quote, zs::object& output) {
+  zs::engine* eng = vm.get_engine();
+
+  user_data_object* uobj = user_data_object::create<string_template>(eng, eng);
+  if (!uobj) {
+    return zs::errc::out_of_memory;
   }
 
-  return output_str;
+  uobj->set_uid(k_string_template_uid);
+  uobj->set_type_id(k_string_template_uid);
+  uobj->set_delegate(get_string_template_delegate(eng));
+
+  output = zs::object(uobj, false);
+  return as_string_template(output).compile(vm, content, l_quote, r_quote);
+}
+
+bool is_string_template(const object& obj) noexcept {
+  return obj.is_user_data() and obj.as_udata().get_uid() == k_string_template_uid;
 }
 
+string_template& as_string_template(const object& obj) noexcept {
+  return obj.as_udata().data_ref<string_template>();
+}
+
+int_t vm_create_string_template(zs::vm_ref vm) {
+  zs::parameter_stream ps(vm);
+  ++ps;
+
+  std::string_view content;
+  ZS_RETURN_IF_ERROR(ps.require<string_parameter>(content), -1);
+
+  std::string_view l_quote = "≤≤";
+  ZS_RETURN_IF_ERROR(ps.require_if_valid<string_parameter>(l_quote), -1);
+
+  std::string_view r_quote = "≥≥";
+  ZS_RETURN_IF_ERROR(ps.require_if_valid<string_parameter>(r_quote), -1);
+
+  if (l_quote.empty() or r_quote.empty()) {
+    vm.set_error("Invalid empty template quote.");
+    return -1;
+  }
+
+  zs::object tmpl;
+  if (auto err = create_string_template(vm, content, l_quote, r_quote, tmpl)) {
+    vm.set_error("Invalid template expression.");
+    return -1;
+  }
+
+  return vm.push(tmpl);
+}
+
+zs::error_result render_template_string(zs::vm_ref vm, const zs::object& tbl, std::string_view content,
+    zs::string& output, std::string_view l_quote, std::string_view r_quote) {
+  zs::engine* eng = vm.get_engine();
+  string_template_cache& cache = string_template_cache::get(eng);
+
+  const uint64_t h = string_template_cache::hash(content, l_quote, r_quote);
+
+  if (zs::object tmpl = cache.find(h, content, l_quote, r_quote); tmpl.is_user_data()) {
+    return as_string_template(tmpl).render(vm, tbl, output);
+  }
+
+  zs::object tmpl;
+  ZS_RETURN_IF_ERROR(create_string_template(vm, content, l_quote, r_quote, tmpl));
+
+  cache.insert(h, content, l_quote, r_quote, tmpl);
+  return as_string_template(tmpl).render(vm, tbl, output);
+}
+
+void set_string_template_cache_size(zs::engine* eng, size_t size) {
+  string_template_cache::get(eng).set_max_size(size);
+}
+
+void clear_string_template_cache(zs::engine* eng) {
+  // Not created if it was never used.
+  if (object obj = eng->get_registry_object(k_string_template_cache_id); obj.is_user_data()) {
+    obj.as_udata().data_ref<string_template_cache>().clear();
+  }
+}
 } // namespace zs.
@@ -4,6 +4,8 @@
 #include "jit/zjit_compiler.h"
 #include "utility/json/zjson_lexer.h"
 #include "utility/json/zjson_parser.h"
+#include "utility/json/zjson_document.h"
+#include "utility/zdata_parser.h"
 
 namespace zs {
 
@@ -15,6 +17,11 @@ zs::error_result load_buffer_as_array(zs::vm_ref vm, std::string_view content, s
 zs::error_result load_buffer_as_value(
     zs::vm_ref vm, std::string_view content, std::string_view source_name, zs::object& value) {
 
+  // Pure data doesn't need to be compiled and executed.
+  if (!zs::data_parser(vm.get_engine()).parse(content, value)) {
+    return {};
+  }
+
   zs::jit_compiler compiler(vm.get_engine());
   zs::object fct_state;
 
@@ -70,11 +77,28 @@ zs::error_result load_file_as_array(zs::vm_ref vm, const char* filepath, std::st
 
 zs::error_result load_json_table(
     zs::vm_ref vm, std::string_view content, const object& table, object& output) {
+
+  // Plain json goes through the structural index, the parser handles the identifiers
+  // resolved from `table` and gives the error messages.
+  // `output` is only assigned on success, a failed conversion can leave a partial value.
+  if (!table.is_table()) {
+    zs::json_document doc(vm.get_engine());
+
+    object value;
+    if (!doc.parse(content) and !doc.to_object(0, value)) {
+      output = std::move(value);
+      return {};
+    }
+  }
+
   zs::json_parser parser(vm.get_engine());
 
-  if (auto err = parser.parse(vm.get_virtual_machine(), content, table, output)) {
+  object value;
+  if (auto err = parser.parse(vm.get_virtual_machine(), content, table, value)) {
     return err;
   }
+
+  output = std::move(value);
   return {};
 }
 
@@ -1,4 +1,7 @@
 #include "utility/zvm_module.h"
+#include "utility/zbytecode_cache.h"
+#include "utility/zimport_archive.h"
+#include "bytecode/zmapped_module.h"
 #include "zvirtual_machine.h"
 #include "object/zfunction_prototype.h"
 
@@ -35,6 +38,53 @@ zs::error_result try_import_module_from_cache(
   return zs::errc::not_found;
 }
 
+namespace {
+  /// Looks for `name` in the import archives, no file system access is needed.
+  /// Returns `errc::not_found` when no archive has the module.
+  zs::error_result import_archive_module(zs::vm_ref vm, const zs::object& name, zs::object& output_module) {
+    const zs::array_object& archives = vm.get_engine()->get_import_archives().as_array();
+
+    for (const object& obj : archives) {
+      import_archive& archive = as_import_archive(obj);
+
+      const int_t index = archive.find_module(name.get_string_unchecked());
+      if (index == -1) {
+        continue;
+      }
+
+      const object entry_path = archive.get_entry_path(index);
+
+      if (zs::status_result status = try_import_module_from_cache(vm, entry_path, output_module)) {
+        return {};
+      }
+      else if (status != zs::errc::not_found) {
+        return status;
+      }
+
+      // The content is only valid until the next read of the archive,
+      // it is compiled before running the module (which can import others).
+      zb::byte_view content;
+      if (auto err = archive.read(index, content)) {
+        return err;
+      }
+
+      object module_closure;
+      if (auto err = compile_or_load_buffer(vm, content, entry_path, module_closure)) {
+        return err;
+      }
+
+      if (auto err = vm->call(module_closure, vm->global(), output_module)) {
+        return err;
+      }
+
+      vm->get_imported_modules().emplace(entry_path, output_module);
+      return {};
+    }
+
+    return zs::errc::not_found;
+  }
+} // namespace.
+
 zs::error_result import_module(zs::vm_ref vm, const zs::object& name, zs::object& output_module) {
 
   zs::engine* eng = vm.get_engine();
@@ -46,6 +96,10 @@ zs::error_result import_module(zs::vm_ref vm, const zs::object& name, zs::object
     return status;
   }
 
+  if (auto err = import_archive_module(vm, name, output_module); err != zs::errc::not_found) {
+    return err;
+  }
+
   object res_file_name;
   if (auto err = eng->resolve_file_path(name.get_string_unchecked(), res_file_name)) {
     return zs::errc::invalid_include_file;
@@ -145,6 +199,51 @@ zs::error_result compile_or_load_buffer(
   return compile_or_load_buffer(vm, content, std::string_view(filename), output_closure);
 }
 
+namespace {
+  /// Mapped modules are used in place instead of being read.
+  /// Only called once the loaded content starts with the mapped module magic.
+  zs::error_result load_mapped_file(zs::vm_ref vm, std::string_view filename, object& output_closure) {
+    zs::engine* eng = vm.get_engine();
+
+    object fpo;
+    if (auto err = load_mapped_module(eng, std::string(filename).c_str(), fpo)) {
+      return err;
+    }
+
+    output_closure = zs::_c(eng, std::move(fpo), vm->global());
+    return {};
+  }
+
+  /// `content` is the file read by the file loader. A mapped module is mapped
+  /// again to be used in place, source code goes through the bytecode cache when
+  /// the engine has one.
+  zs::error_result compile_or_load_file_content(
+      zs::vm_ref vm, zb::byte_view content, std::string_view filename, object& output_closure) {
+    zs::engine* eng = vm.get_engine();
+
+    if (is_mapped_module_data(content)) {
+      return load_mapped_file(vm, filename, output_closure);
+    }
+
+    if (!eng->get_bytecode_cache_directory().is_string()
+        or zs::function_prototype_object::is_compiled_data(content)) {
+      return compile_or_load_buffer(vm, content, filename, output_closure);
+    }
+
+    if (!load_cached_bytecode(vm, filename, content, output_closure)) {
+      return {};
+    }
+
+    if (auto err = compile_or_load_buffer(vm, content, filename, output_closure)) {
+      return err;
+    }
+
+    // A cache that can't be written only costs the next import a compilation.
+    (void)store_cached_bytecode(eng, filename, content, output_closure);
+    return {};
+  }
+} // namespace.
+
 zs::error_result compile_or_load_file(zs::vm_ref vm, const char* filename, object& output_closure) {
   zs::engine* eng = vm.get_engine();
 
@@ -153,7 +252,7 @@ zs::error_result compile_or_load_file(zs::vm_ref vm, const char* filename, objec
     return err;
   }
 
-  return compile_or_load_buffer(vm, loader.data(), filename, output_closure);
+  return compile_or_load_file_content(vm, loader.data(), filename, output_closure);
 }
 
 zs::error_result compile_or_load_file(zs::vm_ref vm, const object& filename, object& output_closure) {
@@ -164,7 +263,7 @@ zs::error_result compile_or_load_file(zs::vm_ref vm, const object& filename, obj
     return err;
   }
 
-  return compile_or_load_buffer(vm, loader.data(), filename.get_string_unchecked(), output_closure);
+  return compile_or_load_file_content(vm, loader.data(), filename.get_string_unchecked(), output_closure);
 }
 
 zs::error_result compile_or_load_file(zs::vm_ref vm, std::string_view filename, object& output_closure) {
@@ -175,7 +274,7 @@ zs::error_result compile_or_load_file(zs::vm_ref vm, std::string_view filename,
     return err;
   }
 
-  return compile_or_load_buffer(vm, loader.data(), filename, output_closure);
+  return compile_or_load_file_content(vm, loader.data(), filename, output_closure);
 }
 
 } // namespace zs.
@@ -23,23 +23,7 @@ ZS_DECL_RT_ACTION(
     handle_error, zs::function_prototype_object* fct, zs::instruction_iterator it, zs::error_code ec) {
 
   size_t inst_byte_index = it.get_index(fct->_instructions);
-
-  const line_info_op_t* last_linfo = nullptr;
-  const line_info_op_t* linfo = nullptr;
-
-  for (const line_info_op_t& line : fct->_line_info) {
-    if (line.op_index <= (int_t)inst_byte_index) {
-      last_linfo = linfo;
-      linfo = &line;
-
-      if (line.op_index == (int_t)inst_byte_index) {
-        break;
-      }
-    }
-    else {
-      break;
-    }
-  }
+  const line_table::entry* linfo = fct->_line_info.find(inst_byte_index);
 
   zs::string err_msg(_engine);
   constexpr std::string_view pre = "\n      ";
@@ -55,17 +39,12 @@ ZS_DECL_RT_ACTION(
       pre, "call stack previous stack base:", _call_stack.back().previous_stack_base, //
       pre, "call stack previous top index:", _call_stack.back().previous_top_index);
 
-  if (last_linfo) {
-    err_msg += zs::strprint(_engine, //
-        pre, " line: [ ", last_linfo->line, " : ", last_linfo->column, " ]");
-  }
-
   zs::line_info iline;
   if (linfo) {
     iline.line = linfo->line;
     iline.column = linfo->column;
     err_msg += zs::strprint(_engine, //
-        pre, " line end: [ ", linfo->line, " : ", linfo->column, " ]");
+        pre, " line: [ ", linfo->line, " : ", linfo->column, " ]");
   }
 
   err_msg += "\n";
@@ -10,19 +10,7 @@ struct virtual_machine::runtime_table_proxy {
       const object& delegate, object& dest, bool& keep_looking) {
 
     object fct;
-
-    if (auto err = vm->raw_get(delegate, zs::_sv(constants::k_mt_get_string), fct)) {
-      keep_looking = true;
-      return {};
-    }
-
-    if (fct.is_null()) {
-      keep_looking = true;
-      return {};
-    }
-
-    // ?????
-    if (fct.is_none()) {
+    if (!proxy::find_meta_get_func(vm, delegate, fct)) {
       keep_looking = true;
       return {};
     }
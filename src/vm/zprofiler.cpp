@@ -0,0 +1,267 @@
+#include "vm/zprofiler.h"
+#include "zvirtual_machine.h"
+#include "object/zfunction_prototype.h"
+
+namespace zs {
+
+sampling_profiler::sampling_profiler(zs::engine* eng)
+    : engine_holder(eng)
+    , _functions(zs::allocator<function_info>(eng, memory_tag::nt_vm))
+    , _function_slots(zs::allocator<uint32_t>(eng, memory_tag::nt_vm))
+    , _frames(zs::allocator<frame>(eng, memory_tag::nt_vm))
+    , _samples(zs::allocator<sample>(eng, memory_tag::nt_vm)) {}
+
+void sampling_profiler::start(const options& opts) {
+  _options = opts;
+  _options.capacity = zb::maximum(_options.capacity, (size_t)1);
+  _options.max_depth = zb::maximum(_options.max_depth, (size_t)1);
+  _options.max_functions = zb::maximum(_options.max_functions, (size_t)1);
+
+  // Everything is allocated here, `safe_point()` is noexcept and doesn't allocate.
+  _functions.clear();
+  _functions.reserve(_options.max_functions);
+  _function_slots.assign((size_t)zb::round_to_power_of_two(_options.max_functions * 2), 0);
+
+  _frames.resize(_options.capacity * _options.max_depth);
+  _samples.resize(_options.capacity);
+  _next = 0;
+  _size = 0;
+  _dropped_count = 0;
+
+  _last_sample_time = clock_type::now();
+  _is_running = true;
+}
+
+uint32_t sampling_profiler::get_function_index(const closure_object* cobj) noexcept {
+  const function_prototype_object* fct = cobj ? cobj->get_function_prototype() : nullptr;
+
+  const size_t mask = _function_slots.size() - 1;
+  size_t slot_index = (std::hash<const void*>()(fct) * 0x9E3779B97F4A7C15ull >> 16) & mask;
+
+  while (const uint32_t slot = _function_slots[slot_index]) {
+    if (_functions[slot - 1].key == fct) {
+      return slot - 1;
+    }
+
+    slot_index = (slot_index + 1) & mask;
+  }
+
+  if (_functions.size() == _options.max_functions) {
+    return k_invalid_function_index;
+  }
+
+  // The capacity was reserved by `start()`.
+  function_info& finfo = _functions.emplace_back();
+  finfo.key = fct;
+
+  if (fct) {
+    finfo.function = cobj->_function;
+    finfo.name = fct->_name;
+    finfo.source_name = fct->_source_name;
+  }
+  else {
+    finfo.name = zs::_ss("[native]");
+  }
+
+  _function_slots[slot_index] = (uint32_t)_functions.size();
+  return (uint32_t)(_functions.size() - 1);
+}
+
+void sampling_profiler::safe_point(
+    std::span<const call_info> call_stack, const function_prototype_object* fct, const uint8_t* ip) noexcept {
+
+  const clock_type::time_point now = clock_type::now();
+  if (now - _last_sample_time < _options.interval) {
+    return;
+  }
+
+  // The first call info is the root one, it has no closure.
+  if (call_stack.size() < 2) {
+    return;
+  }
+
+  const size_t max_depth = _options.max_depth;
+  const size_t n_frames = call_stack.size() - 1;
+  const size_t depth = zb::minimum(n_frames, max_depth);
+
+  frame* frames = _frames.data() + _next * max_depth;
+
+  // The frames are walked from the leaf, `ip` and `fct` are updated to the caller
+  // position when it is known.
+  for (size_t i = 0; i < depth; i++) {
+    const call_info& cinfo = call_stack[call_stack.size() - 1 - i];
+
+    const closure_object* cobj = cinfo.closure.is_closure() ? &cinfo.closure.as_closure() : nullptr;
+    const function_prototype_object* frame_fct = cobj ? cobj->get_function_prototype() : nullptr;
+
+    uint32_t line = 0;
+    if (frame_fct and frame_fct == fct and ip) {
+      const size_t inst_index = zs::instruction_iterator(ip).get_index(fct->_instructions);
+      if (const line_table::entry* linfo = fct->_line_info.find(inst_index)) {
+        line = linfo->line;
+      }
+    }
+
+    const uint32_t function_index = get_function_index(cobj);
+    if (function_index == k_invalid_function_index) {
+      _last_sample_time = now;
+      return;
+    }
+
+    frames[depth - 1 - i] = { function_index, line };
+
+    fct = cinfo.caller_fct;
+    ip = cinfo.call_ptr;
+  }
+
+  _samples[_next] = { (uint32_t)depth, now - _last_sample_time };
+  _last_sample_time = now;
+  _next = (_next + 1) % _options.capacity;
+
+  if (_size == _options.capacity) {
+    _dropped_count++;
+  }
+  else {
+    _size++;
+  }
+}
+
+zs::vector<size_t> sampling_profiler::get_sample_indices() const {
+  zs::vector<size_t> indices((zs::allocator<size_t>(_engine)));
+  indices.resize(_size);
+
+  const size_t first = _size == _options.capacity ? _next : 0;
+  for (size_t i = 0; i < _size; i++) {
+    indices[i] = (first + i) % _options.capacity;
+  }
+
+  return indices;
+}
+
+static void append_frame_name(
+    zs::string& str, const object& name, const object& source_name, uint32_t line) {
+  const bool has_name = name.is_string() and !name.get_string_unchecked().empty();
+  str += has_name ? name.get_string_unchecked() : std::string_view("<anonymous>");
+
+  if (source_name.is_string() and !source_name.get_string_unchecked().empty()) {
+    str += " (";
+    str += source_name.get_string_unchecked();
+
+    if (line) {
+      char buffer[16];
+      std::snprintf(buffer, sizeof(buffer), ":%u", line);
+      str += buffer;
+    }
+
+    str += ")";
+  }
+}
+
+zs::string sampling_profiler::get_collapsed_stacks() const {
+  zs::vector<size_t> indices = get_sample_indices();
+
+  // Identical stacks end up next to each other.
+  std::sort(indices.begin(), indices.end(), [&](size_t lhs, size_t rhs) {
+    std::span<const frame> lframes = get_frames(lhs);
+    std::span<const frame> rframes = get_frames(rhs);
+    return std::lexicographical_compare(lframes.begin(), lframes.end(), rframes.begin(), rframes.end());
+  });
+
+  zs::string output((zs::string_allocator(_engine)));
+
+  for (size_t i = 0; i < indices.size();) {
+    std::span<const frame> frames = get_frames(indices[i]);
+
+    size_t count = 1;
+    while (i + count < indices.size() and std::ranges::equal(frames, get_frames(indices[i + count]))) {
+      count++;
+    }
+
+    for (size_t k = 0; k < frames.size(); k++) {
+      if (k) {
+        output += ";";
+      }
+
+      const function_info& finfo = _functions[frames[k].function_index];
+      append_frame_name(output, finfo.name, finfo.source_name, frames[k].line);
+    }
+
+    output += " ";
+    output += zs::strprint(_engine, count);
+    output += "\n";
+
+    i += count;
+  }
+
+  return output;
+}
+
+zs::vector<sampling_profiler::function_stats> sampling_profiler::get_function_stats() const {
+  zs::vector<function_stats> stats((zs::allocator<function_stats>(_engine)));
+  stats.resize(_functions.size());
+
+  for (size_t i = 0; i < _functions.size(); i++) {
+    stats[i].name = _functions[i].name;
+    stats[i].source_name = _functions[i].source_name;
+  }
+
+  // Used to count a recursive function once per sample in its total.
+  zs::vector<size_t> last_sample((zs::allocator<size_t>(_engine)));
+  last_sample.resize(_functions.size(), (size_t)-1);
+
+  for (size_t sample_index : get_sample_indices()) {
+    std::span<const frame> frames = get_frames(sample_index);
+    const std::chrono::nanoseconds elapsed = _samples[sample_index].elapsed;
+
+    for (const frame& f : frames) {
+      if (last_sample[f.function_index] != sample_index) {
+        last_sample[f.function_index] = sample_index;
+        stats[f.function_index].total_samples++;
+        stats[f.function_index].total_time += elapsed;
+      }
+    }
+
+    if (!frames.empty()) {
+      function_stats& leaf = stats[frames.back().function_index];
+      leaf.self_samples++;
+      leaf.self_time += elapsed;
+    }
+  }
+
+  std::stable_sort(stats.begin(), stats.end(), [](const function_stats& lhs, const function_stats& rhs) {
+    return lhs.self_time == rhs.self_time ? lhs.self_samples > rhs.self_samples
+                                          : lhs.self_time > rhs.self_time;
+  });
+
+  return stats;
+}
+
+zs::string sampling_profiler::get_function_table() const {
+  zs::vector<function_stats> stats = get_function_stats();
+
+  std::chrono::nanoseconds sampled_time = {};
+  for (const function_stats& s : stats) {
+    sampled_time += s.self_time;
+  }
+
+  const double total_ms = std::chrono::duration<double, std::milli>(sampled_time).count();
+
+  zs::string output((zs::string_allocator(_engine)));
+  output += "   self %    self ms   total ms    samples  function\n";
+
+  for (const function_stats& s : stats) {
+    const double self_ms = std::chrono::duration<double, std::milli>(s.self_time).count();
+    const double fct_total_ms = std::chrono::duration<double, std::milli>(s.total_time).count();
+
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%9.2f %10.3f %10.3f %10zu  ",
+        total_ms > 0 ? 100.0 * self_ms / total_ms : 0.0, self_ms, fct_total_ms, s.self_samples);
+
+    output += buffer;
+    append_frame_name(output, s.name, s.source_name, 0);
+    output += "\n";
+  }
+
+  return output;
+}
+} // namespace zs.
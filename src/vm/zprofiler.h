@@ -0,0 +1,164 @@
+#pragma once
+
+#include <zscript/zscript.h>
+#include <chrono>
+
+namespace zs {
+
+class function_prototype_object;
+struct call_info;
+
+/// Sampling profiler of the script code (see `virtual_machine::start_profiler()`).
+///
+/// `virtual_machine::executor::run()` calls `safe_point()` every
+/// `k_safe_point_interval` instructions. Once `options::interval` elapsed since
+/// the last sample, the script call stack is copied in a ring buffer allocated by
+/// `start()`, the oldest samples are overwritten when it is full.
+///
+/// Each sample has the function prototype `_name`, `_source_name` and line of
+/// every frame and the time elapsed since the previous sample. The line of a
+/// caller is only known when it called with an `op_call` (the line of a frame
+/// called from native code is 0).
+class sampling_profiler : public engine_holder {
+public:
+  /// Number of instructions between two clock checks.
+  static constexpr uint32_t k_safe_point_interval = 256;
+
+  struct options {
+    /// Time between two samples.
+    std::chrono::microseconds interval = std::chrono::microseconds(1000);
+
+    /// Number of samples kept in the ring buffer.
+    size_t capacity = 4096;
+
+    /// Deeper call stacks only keep their innermost `max_depth` frames.
+    size_t max_depth = 64;
+
+    /// Number of distinct functions, a sample with a new function past this
+    /// count is dropped.
+    size_t max_functions = 1024;
+  };
+
+  struct function_stats {
+    zs::object name;
+    zs::object source_name;
+
+    /// Number of samples where the function was running (self) or on the call stack (total).
+    size_t self_samples = 0;
+    size_t total_samples = 0;
+
+    std::chrono::nanoseconds self_time = {};
+    std::chrono::nanoseconds total_time = {};
+  };
+
+  sampling_profiler(zs::engine* eng);
+
+  /// Clears the previous samples and starts sampling.
+  void start(const options& opts);
+
+  /// Stops sampling, the samples are kept until the next `start()`.
+  ZS_INLINE void stop() noexcept { _is_running = false; }
+
+  ZS_CK_INLINE bool is_running() const noexcept { return _is_running; }
+
+  /// Called by `virtual_machine::executor::run()` for every script entered from
+  /// native code. When no script was running, the time spent outside of the
+  /// scripts isn't part of the next sample.
+  ZS_INLINE void enter_script() noexcept {
+    if (_script_depth++ == 0 and _is_running) {
+      _last_sample_time = clock_type::now();
+    }
+  }
+
+  ZS_INLINE void leave_script() noexcept { _script_depth--; }
+
+  /// Records a sample if the interval elapsed. `fct` is the function being run and
+  /// `ip` its current instruction, it is the last frame of `call_stack`.
+  void safe_point(std::span<const call_info> call_stack, const function_prototype_object* fct,
+      const uint8_t* ip) noexcept;
+
+  /// Number of samples in the ring buffer.
+  ZS_CK_INLINE size_t size() const noexcept { return _size; }
+
+  /// Number of samples overwritten because the ring buffer was full.
+  ZS_CK_INLINE size_t get_dropped_count() const noexcept { return _dropped_count; }
+
+  /// Returns the samples in the collapsed stack format used by the flame graph
+  /// tools, one line per distinct stack with its number of samples:
+  /// `main (main.zs:12);update (main.zs:40);compute (lib.zs:7) 42`.
+  ZS_CHECK zs::string get_collapsed_stacks() const;
+
+  /// Returns the self and total time of every sampled function, sorted by self time.
+  ZS_CHECK zs::vector<function_stats> get_function_stats() const;
+
+  /// Returns `get_function_stats()` as a text table.
+  ZS_CHECK zs::string get_function_table() const;
+
+private:
+  struct function_info {
+    /// The function prototype, null for all the native functions.
+    const function_prototype_object* key;
+
+    /// Keeps the function prototype alive, the frames refer to it by address.
+    zs::object function;
+    zs::object name;
+    zs::object source_name;
+  };
+
+  struct frame {
+    uint32_t function_index;
+    uint32_t line;
+
+    ZS_CK_INLINE friend bool operator==(const frame& lhs, const frame& rhs) noexcept {
+      return lhs.function_index == rhs.function_index and lhs.line == rhs.line;
+    }
+
+    ZS_CK_INLINE friend bool operator<(const frame& lhs, const frame& rhs) noexcept {
+      return lhs.function_index == rhs.function_index ? lhs.line < rhs.line
+                                                      : lhs.function_index < rhs.function_index;
+    }
+  };
+
+  struct sample {
+    uint32_t depth;
+    std::chrono::nanoseconds elapsed;
+  };
+
+  using clock_type = std::chrono::steady_clock;
+
+  static constexpr uint32_t k_invalid_function_index = (uint32_t)-1;
+
+  options _options;
+
+  /// Both are allocated by `start()`, nothing is allocated while sampling.
+  /// `_function_slots` is an open addressing table of `_functions` indices + 1
+  /// (0 is an empty slot), with at least twice as many slots as functions.
+  zs::vector<function_info> _functions;
+  zs::vector<uint32_t> _function_slots;
+
+  /// `_frames` has `max_depth` frames per sample, from the root to the leaf.
+  zs::vector<frame> _frames;
+  zs::vector<sample> _samples;
+  size_t _next = 0;
+  size_t _size = 0;
+  size_t _dropped_count = 0;
+
+  clock_type::time_point _last_sample_time;
+
+  /// Number of nested `executor::run()`.
+  size_t _script_depth = 0;
+  bool _is_running = false;
+
+  /// Returns `k_invalid_function_index` when `max_functions` is reached.
+  /// `cobj` is null for a native function.
+  uint32_t get_function_index(const closure_object* cobj) noexcept;
+
+  ZS_CK_INLINE std::span<const frame> get_frames(size_t sample_index) const noexcept {
+    return std::span<const frame>(_frames.data() + sample_index * _options.max_depth,
+        _samples[sample_index].depth);
+  }
+
+  /// Sample indices from the oldest to the newest.
+  ZS_CHECK zs::vector<size_t> get_sample_indices() const;
+};
+} // namespace zs.
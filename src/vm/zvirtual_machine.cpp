@@ -59,7 +59,7 @@ int_t virtual_machine::exec_op_data_t::get_iterator_index(
 
 zs::instruction_vector::iterator virtual_machine::exec_op_data_t::get_instruction(
     size_t index) const noexcept {
-  ZS_ASSERT(index < fct->_instructions._data.size());
+  ZS_ASSERT(index < fct->_instructions.size());
   return fct->_instructions[index];
 }
 
@@ -91,6 +91,16 @@ ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_if_not)
 ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_and)
 ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_or)
 ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_triple_or)
+ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_foreach_next)
+ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_call)
+ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_cmp_jz)
+ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_cmp_int_jz)
+ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_eq_int_jz_ii)
+ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_ne_int_jz_ii)
+ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_lt_int_jz_ii)
+ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_le_int_jz_ii)
+ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_gt_int_jz_ii)
+ZS_VM_DECL_OP_NO_INST_PTR_INCR(op_ge_int_jz_ii)
 
 #undef ZS_VM_DECL_OP_NO_INST_PTR_INCR
 
@@ -110,6 +120,157 @@ struct virtual_machine::executor {
 
     return (v->*executor::operations[code])(it, op_data);
   }
+
+#if ZS_SCRIPT_PROFILER
+  /// Gives the current position to the profiler, see `sampling_profiler::safe_point()`.
+  ZB_INLINE static void profiler_safe_point(
+      virtual_machine* v, exec_op_data_t& op_data, zs::instruction_iterator it) noexcept {
+    if (v->_profiler.is_running()) {
+      v->_profiler.safe_point(
+          std::span<const call_info>(v->_call_stack.data(), v->_call_stack.size()), op_data.fct, it.data());
+    }
+  }
+
+#define ZS_VM_PROFILER_SAFE_POINT()                                  \
+  if (ZBASE_UNLIKELY(--safe_point_countdown == 0)) {                 \
+    safe_point_countdown = sampling_profiler::k_safe_point_interval; \
+    profiler_safe_point(v, op_data, it);                             \
+  }
+#else
+#define ZS_VM_PROFILER_SAFE_POINT()
+#endif // ZS_SCRIPT_PROFILER.
+
+  ZBASE_PRAGMA_PUSH()
+  ZBASE_PRAGMA_DISABLE_WARNING_CLANG("-Wgnu-label-as-value")
+  ZBASE_PRAGMA_DISABLE_WARNING_GCC("-Wpedantic")
+
+  /// Runs the instructions of `op_data.fct` until an `op_return` or an error.
+  /// With `ZS_USE_COMPUTED_GOTO`, each handler jumps directly to the next one
+  /// through a label table instead of going back to a single dispatch point.
+  ///
+  /// A script closure called with `op_call` is run by this same loop, `op_data`
+  /// and `it` are switched to the callee and restored from its call info when
+  /// it returns.
+  ZB_CHECK static zs::error_result run(virtual_machine* v, exec_op_data_t& op_data) {
+    zs::instruction_iterator end_it = op_data.fct->_instructions.end();
+    zs::instruction_iterator it = op_data.fct->_instructions.begin();
+
+    // The frames entered by `op_call` are the `n_calls` call infos starting at `first_call_index`.
+    const size_t first_call_index = v->_call_stack.size();
+    size_t n_calls = 0;
+
+    // Keeping the last instruction iterator in case of an error.
+    zs::instruction_iterator inst_it = it;
+    zs::error_code ec = errc::success;
+
+#if ZS_SCRIPT_PROFILER
+    uint32_t safe_point_countdown = sampling_profiler::k_safe_point_interval;
+
+    v->_profiler.enter_script();
+    zb::scoped leave_script([&]() { v->_profiler.leave_script(); });
+#endif // ZS_SCRIPT_PROFILER.
+
+#if ZS_MEMORY_PROFILER
+    // Lets the allocation tracker find the function and line being run.
+    const engine::script_position position = { &op_data.fct, &inst_it };
+    const engine::script_position* prev_position = v->_engine->set_script_position(&position);
+    zb::scoped restore_position([&]() { v->_engine->set_script_position(prev_position); });
+#endif // ZS_MEMORY_PROFILER.
+
+#if ZS_USE_COMPUTED_GOTO
+    static void* const labels[] = {
+#define ZS_DECL_OPCODE(name, INST_TYPES) &&ZBASE_CONCAT(zs_label_op_, name),
+#include "bytecode/zopcode_def.h"
+#undef ZS_DECL_OPCODE
+    };
+
+    static_assert(std::size(labels) == (size_t)opcode::count);
+
+  zs_label_dispatch:
+    if (it == end_it) {
+      goto zs_label_done;
+    }
+
+    goto* labels[(size_t)*it];
+
+    // The `op_return` returns zs::error_code::returned on success.
+#define ZS_DECL_OPCODE(name, INST_TYPES)                                                 \
+  ZBASE_CONCAT(zs_label_op_, name) : inst_it = it;                                       \
+  ZS_VM_PROFILER_SAFE_POINT()                                                            \
+  ec = v->exec_op_wrapper<ZS_OPCODE_ENUM_VALUE(name)>(it, op_data);                      \
+  if (ZBASE_UNLIKELY(ec != errc::success or it == end_it)) {                             \
+    goto zs_label_done;                                                                  \
+  }                                                                                      \
+  goto* labels[(size_t)*it];
+#include "bytecode/zopcode_def.h"
+#undef ZS_DECL_OPCODE
+
+  zs_label_done:
+#else
+  zs_label_dispatch:
+    while (it != end_it) {
+      inst_it = it;
+      ZS_VM_PROFILER_SAFE_POINT()
+
+      // The `op_return` returns zs::error_code::returned on success.
+      if ((ec = call_op(v, *it, it, op_data)) != errc::success) {
+        break;
+      }
+    }
+#endif // ZS_USE_COMPUTED_GOTO.
+
+    if (ec == k_entered_call) {
+      n_calls++;
+      end_it = op_data.fct->_instructions.end();
+      ec = errc::success;
+      goto zs_label_dispatch;
+    }
+
+    // Reaching the end of a function is the same as returning null.
+    if (n_calls and (ec == errc::success or ec == errc::returned)) {
+      n_calls--;
+
+      // The frame is popped even on error, the remaining ones are popped like
+      // on a script error.
+      if (auto err = v->leave_call_frame(it, op_data, ec == errc::returned)) {
+        for (; n_calls; n_calls--) {
+          (void)v->leave_function_call();
+        }
+
+        return err;
+      }
+
+      end_it = op_data.fct->_instructions.end();
+      ec = errc::success;
+      goto zs_label_dispatch;
+    }
+
+    if (zs::error_result err = ec) {
+      (void)v->runtime_action<runtime_code::handle_error>(op_data.fct, inst_it, ec);
+
+      // One error per caller, like the nested `run()` calls would have done.
+      for (size_t i = first_call_index + n_calls; i-- > first_call_index;) {
+        const call_info& cinfo = v->_call_stack[i];
+        (void)v->runtime_action<runtime_code::handle_error>(
+            cinfo.caller_fct, zs::instruction_iterator(cinfo.call_ptr), ec);
+      }
+
+      // The frames entered by `op_call` are popped and their captures closed.
+      // Only the frame of the caller of `run()` is left as is, same as a
+      // non-protected `call_closure()`.
+      for (; n_calls; n_calls--) {
+        (void)v->leave_function_call();
+      }
+
+      return err;
+    }
+
+    return ec;
+  }
+
+  ZBASE_PRAGMA_POP()
+
+#undef ZS_VM_PROFILER_SAFE_POINT
 };
 
 //
@@ -189,8 +350,7 @@ virtual_machine* virtual_machine::create(zs::virtual_machine* vm, size_t stack_s
 
 template <>
 struct internal::proxy<virtual_machine> {
-  inline static void reset_engine_user_pointer(zs::engine* eng) {
-    eng->_user_pointer = nullptr;
+  inline static void reset_engine_user_pointer_release_hook(zs::engine* eng) {
     eng->_user_pointer_release = nullptr;
   }
 };
@@ -202,6 +362,7 @@ virtual_machine::virtual_machine(zs::engine* eng, size_t stack_size, bool owns_e
     , _call_stack({ { nullptr, 0, 0 } }, (zs::allocator<call_info>(eng, zs::memory_tag::nt_vm)))
     , _open_captures(zs::allocator<object>(eng))
     , _errors(eng)
+    , _profiler(eng)
     , _owns_engine(owns_engine) {}
 
 virtual_machine::virtual_machine(zs::virtual_machine* vm, size_t stack_size, bool same_global)
@@ -211,6 +372,7 @@ virtual_machine::virtual_machine(zs::virtual_machine* vm, size_t stack_size, boo
     , _call_stack({ { nullptr, 0, 0 } }, (zs::allocator<call_info>(vm->_engine, zs::memory_tag::nt_vm)))
     , _open_captures(zs::allocator<object>(vm->_engine))
     , _errors(vm->_engine)
+    , _profiler(vm->_engine)
     , _owns_engine(false) {}
 
 zs::error_result virtual_machine::init() {
@@ -255,7 +417,9 @@ static void destroy_engine(zs::engine* eng) {
 
   // Prevent the engine from calling the user release callback in it's
   // destructor. It will be called after deleting the engine.
-  internal::proxy<virtual_machine>::reset_engine_user_pointer(eng);
+  // The user pointer stays valid, the engine members still deallocate
+  // through the allocator callback after the destructor body.
+  internal::proxy<virtual_machine>::reset_engine_user_pointer_release_hook(eng);
 
   // Delete the engine.
   // Can't use zs_delete or anything special here since we are
@@ -291,6 +455,19 @@ void virtual_machine::release() noexcept {
   }
 }
 
+zs::error_result virtual_machine::start_profiler(const sampling_profiler::options& opts) {
+#if ZS_SCRIPT_PROFILER
+  _profiler.start(opts);
+  return {};
+#else
+  (void)opts;
+  set_error("The script profiler is disabled (ZS_SCRIPT_PROFILER).\n");
+  return errc::unimplemented;
+#endif // ZS_SCRIPT_PROFILER.
+}
+
+void virtual_machine::stop_profiler() noexcept { _profiler.stop(); }
+
 const object& virtual_machine::get_default_table_delegate() const noexcept {
   return global_table()[k_table_delegate_name];
 }
@@ -341,6 +518,26 @@ table_object& virtual_machine::get_module_loaders() noexcept {
   return global_table()[k_module_loaders_name].as_table();
 }
 
+zs::error_result virtual_machine::begin_arena(size_t chunk_size) {
+  if (auto err = _engine->begin_arena(chunk_size)) {
+    return ZS_VM_ERROR(err, "Could not begin an arena, the previous one is still in use.");
+  }
+
+  return {};
+}
+
+zs::error_result virtual_machine::end_arena() {
+  if (!_engine->is_arena_open()) {
+    return ZS_VM_ERROR(errc::invalid_operation, "No arena to end.");
+  }
+
+  if (auto err = _engine->end_arena()) {
+    return ZS_VM_ERROR(err, "Some arena objects are still referenced outside of the arena scope.");
+  }
+
+  return {};
+}
+
 void virtual_machine::push(object&& obj) { _stack.push(std::move(obj)); }
 
 void virtual_machine::push(const object& obj) { _stack.push(obj); }
@@ -609,29 +806,13 @@ void virtual_machine::reset_protected_call_stack(size_t call_stack_index) {
   ZS_ASSERT(cinfo.previous_top_index == (int_t)_stack.get_absolute_top());
 }
 
-zs::error_result virtual_machine::call_closure(
-    const object& closure_obj, zs::parameter_list params, object& ret_value, bool is_protected_call) {
-
-  zs::native_closure_object* nclosure = closure_obj._native_closure;
-  zs::closure_object* closure = closure_obj._closure;
-  zs::function_t nfct = closure_obj._nfct;
-
-  const bool is_native_closure = closure_obj.is_native_closure();
-  const size_t call_stack_index = _call_stack.size();
+zs::error_result virtual_machine::push_call_frame(const object& closure_obj,
+    const zs::function_parameter_interface& cl_info, zs::parameter_list params, const object& this_obj) {
 
   // The call was made with `n_params` parameters.
   // This value will change during this function.
   int_t n_params = params.size();
 
-  zs::function_parameter_interface cl_info;
-
-  if (is_native_closure) {
-    cl_info = nclosure->get_parameter_interface();
-  }
-  else if (closure_obj.is_closure()) {
-    cl_info = closure->get_parameter_interface();
-  }
-
   // The function expects `n_expected_params` parameters.
   const int_t n_expected_params = cl_info.get_parameters_count();
 
@@ -641,56 +822,6 @@ zs::error_result virtual_machine::call_closure(
   const bool has_variadic_parameters = cl_info.has_variadic_parameters();
   std::span<const object> closure_default_params = cl_info.get_default_parameters();
 
-  object base_obj = params[0];
-  object this_obj = base_obj;
-
-  // ?????????????????
-  if (!_registers[0].is_null()) {
-    this_obj = _registers[0];
-    _registers[0] = nullptr;
-  }
-  else if (cl_info.get_this() and !cl_info.get_this()->is_null()) {
-    this_obj = *cl_info.get_this();
-  }
-
-  if (closure_obj.is_native_function() or (is_native_closure and !n_expected_params)) {
-    // Enter function call.
-    // Get the stack state before pushing the parameters.
-    // Set the new stack base (the current top of the stack will be the next stack base).
-    _stack.set_stack_base(_call_stack.emplace_back(closure_obj, _stack.get_state()).previous_top_index);
-
-    // Push `n_params` elements starting at `stack_base` on top of the stack.
-    _stack.push(params);
-
-    ZS_ASSERT(_call_stack.back().previous_top_index == int_t(_stack.get_absolute_top() - n_params),
-        "invalid stack parameters");
-    ZS_ASSERT(stack_size() == n_params, "invalid stack parameters");
-
-    // This.
-    _stack[0] = this_obj;
-
-    const int_t native_call_result = is_native_closure ? nclosure->call(this) : (*nfct)(this);
-    _stack[0] = base_obj;
-    ret_value = nullptr;
-
-    if (native_call_result < 0) {
-      if (is_protected_call) {
-        reset_protected_call_stack(call_stack_index);
-      }
-
-      // We leave the stack as is when a non-protected call error occurs.
-      // In other words, we don't call `leave_function_call()`, this might help
-      // to retrieve more accurate debug information.
-      return errc::invalid_native_function_call;
-    }
-
-    if (native_call_result > 0) {
-      ret_value = _stack.top();
-    }
-
-    return leave_function_call();
-  }
-
   // A span of missing default parameters that will be pushed after the given `n_params` if needed.
   std::span<const object> extra_params;
 
@@ -754,11 +885,114 @@ zs::error_result virtual_machine::call_closure(
 
   // We push the extra default params.
   _stack.push(extra_params);
-  n_params += extra_params.size();
 
   // This.
   _stack[0] = this_obj;
 
+  return {};
+}
+
+zs::error_result virtual_machine::leave_call_frame(
+    zs::instruction_iterator& it, exec_op_data_t& op_data, bool has_returned) {
+  object ret_value;
+
+  if (has_returned) {
+    ret_value = std::move(op_data.ret_value);
+    op_data.ret_value.reset();
+  }
+
+  const call_info& cinfo = _call_stack.back();
+  const instruction_t<op_call>& inst = zs::instruction_iterator(cinfo.call_ptr).get_ref<op_call>();
+
+  op_data.closure = cinfo.caller_closure;
+  op_data.fct = cinfo.caller_fct;
+  it = zs::instruction_iterator(cinfo.call_ptr + get_instruction_size<op_call>());
+
+  // Reset the base object, same as `call_closure()`.
+  _stack[0] = _stack.get_internal_vector()[cinfo.previous_stack_base + inst.stack_base];
+
+  ZS_RETURN_IF_ERROR(leave_function_call());
+  _stack[inst.target_idx] = std::move(ret_value);
+  return {};
+}
+
+zs::error_result virtual_machine::call_closure(
+    const object& closure_obj, zs::parameter_list params, object& ret_value, bool is_protected_call) {
+
+  zs::native_closure_object* nclosure = closure_obj._native_closure;
+  zs::closure_object* closure = closure_obj._closure;
+  zs::function_t nfct = closure_obj._nfct;
+
+  const bool is_native_closure = closure_obj.is_native_closure();
+  const size_t call_stack_index = _call_stack.size();
+
+  // The call was made with `n_params` parameters.
+  const int_t n_params = params.size();
+
+  zs::function_parameter_interface cl_info;
+
+  if (is_native_closure) {
+    cl_info = nclosure->get_parameter_interface();
+  }
+  else if (closure_obj.is_closure()) {
+    cl_info = closure->get_parameter_interface();
+  }
+
+  // The function expects `n_expected_params` parameters.
+  const int_t n_expected_params = cl_info.get_parameters_count();
+
+  object base_obj = params[0];
+  object this_obj = base_obj;
+
+  // ?????????????????
+  if (!_registers[0].is_null()) {
+    this_obj = _registers[0];
+    _registers[0] = nullptr;
+  }
+  else if (cl_info.get_this() and !cl_info.get_this()->is_null()) {
+    this_obj = *cl_info.get_this();
+  }
+
+  if (closure_obj.is_native_function() or (is_native_closure and !n_expected_params)) {
+    // Enter function call.
+    // Get the stack state before pushing the parameters.
+    // Set the new stack base (the current top of the stack will be the next stack base).
+    _stack.set_stack_base(_call_stack.emplace_back(closure_obj, _stack.get_state()).previous_top_index);
+
+    // Push `n_params` elements starting at `stack_base` on top of the stack.
+    _stack.push(params);
+
+    ZS_ASSERT(_call_stack.back().previous_top_index == int_t(_stack.get_absolute_top() - n_params),
+        "invalid stack parameters");
+    ZS_ASSERT(stack_size() == n_params, "invalid stack parameters");
+
+    // This.
+    _stack[0] = this_obj;
+
+    const int_t native_call_result = is_native_closure ? nclosure->call(this) : (*nfct)(this);
+    _stack[0] = base_obj;
+    ret_value = nullptr;
+
+    if (native_call_result < 0) {
+      if (is_protected_call) {
+        reset_protected_call_stack(call_stack_index);
+      }
+
+      // We leave the stack as is when a non-protected call error occurs.
+      // In other words, we don't call `leave_function_call()`, this might help
+      // to retrieve more accurate debug information.
+      return errc::invalid_native_function_call;
+    }
+
+    if (native_call_result > 0) {
+      ret_value = _stack.top();
+    }
+
+    return leave_function_call();
+  }
+
+  ZS_RETURN_IF_ERROR(push_call_frame(closure_obj, cl_info, params, this_obj));
+
   zs::error_result call_error_result;
 
   if (is_native_closure) {
@@ -775,30 +1009,11 @@ zs::error_result virtual_machine::call_closure(
   else {
     // We make room for the function stack by pushing some empty objects.
     zs::function_prototype_object* fpo = closure->get_function_prototype();
-    _stack.push_n(fpo->_stack_size - n_params);
+    _stack.push_n(fpo->_stack_size - stack_size());
 
     // Execute.
-    zs::instruction_vector& instructions = fpo->_instructions;
     exec_op_data_t op_data{ closure, fpo, ret_value };
-    const instruction_iterator end_it = instructions.end();
-
-    for (zs::instruction_iterator it = instructions.begin(); it != end_it;) {
-      // Keeping the last instruction iterator in case of an error.
-      const zs::instruction_iterator inst_it = it;
-
-      call_error_result = executor::call_op(this, *it, it, op_data);
-
-      if (call_error_result) {
-        (void)runtime_action<runtime_code::handle_error>(fpo, inst_it, call_error_result.code);
-        break;
-      }
-
-      else if (call_error_result == errc::returned) {
-        // The `op_return` returns zs::error_code::returned on success.
-        // We are done with this function.
-        break;
-      }
-    }
+    call_error_result = executor::run(this, op_data);
   }
 
   // Reset the base object.
@@ -990,27 +1205,8 @@ zs::error_result virtual_machine::tail_call_closure(
     //    _stack.push_n(fpo->_stack_size - n_params);
 
     // Execute.
-    zs::instruction_vector& instructions = fpo->_instructions;
     exec_op_data_t op_data{ closure, fpo, ret_value };
-    const instruction_iterator end_it = instructions.end();
-
-    for (zs::instruction_iterator it = instructions.begin(); it != end_it;) {
-      // Keeping the last instruction iterator in case of an error.
-      const zs::instruction_iterator inst_it = it;
-
-      call_error_result = executor::call_op(this, *it, it, op_data);
-
-      if (call_error_result) {
-        (void)runtime_action<runtime_code::handle_error>(fpo, inst_it, call_error_result.code);
-        break;
-      }
-
-      else if (call_error_result == errc::returned) {
-        // The `op_return` returns zs::error_code::returned on success.
-        // We are done with this function.
-        break;
-      }
-    }
+    call_error_result = executor::run(this, op_data);
   }
 
   // Reset the base object.
@@ -2022,34 +2218,31 @@ error_result virtual_machine::binary_delegate_operation(
 error_result virtual_machine::find_meta_method(
     meta_method mt, const object& obj, object& delegate_out, object& dest, meta_method alt) {
 
-  static constexpr auto _get_meta_method
-      = [](const object& delegate, const object& mt_name) -> const object* {
+  // The tables remember which meta methods they have, see `table_object::get_meta_method()`.
+  static constexpr auto _get_meta_method = [](const object& delegate, meta_method mt) -> const object* {
     if (delegate.is_table()) {
-      return delegate.as_table().get(mt_name);
+      return delegate.as_table().get_meta_method(mt);
     }
     else {
-      return delegate.as_struct_instance().get_meta_method(mt_name);
+      return delegate.as_struct_instance().get_meta_method(zs::get_meta_method_name_object(mt));
     }
   };
 
   object delegate = start_delegate_chain(obj);
 
-  const object mt_name = zs::get_meta_method_name_object(mt);
-  const object mt_alt_name = zs::get_meta_method_name_object(alt);
-
   while (delegate.is_meta_type()) {
 
     // We look directly in the delegate table for the meta function.
     // We never call '__get' when looking for a meta method.
 
-    if (const zs::object* meta_func = _get_meta_method(delegate, mt_name)) {
+    if (const zs::object* meta_func = _get_meta_method(delegate, mt)) {
       dest = *meta_func;
       delegate_out = delegate;
       return {};
     }
 
     if (const zs::object* meta_func = nullptr;
-        alt != meta_method::mt_none and (meta_func = _get_meta_method(delegate, mt_alt_name))) {
+        alt != meta_method::mt_none and (meta_func = _get_meta_method(delegate, alt))) {
       dest = *meta_func;
       delegate_out = delegate;
       return {};
@@ -32,34 +32,52 @@ struct virtual_machine::proxy {
     return {};
   }
 
+  /// Finds the `__get` meta method of `delegate`.
+  /// Returns false when there is none, or when it is null or none.
+  static bool find_meta_get_func(virtual_machine* vm, const object& delegate, object& fct);
+
   static error_result find_and_call_meta_get_func(virtual_machine* vm, const object& obj, const object& key,
       const object& delegate, object& dest, bool& keep_looking);
 
   static zs::error_result get(virtual_machine* vm, const object& obj, const object& key,
       const object& delegate, object& dest, bool use_meta_get = true);
+
+  /// Returns the cached member `key` of `obj` (table or struct instance),
+  /// or nullptr if the cache has no valid entry for it.
+  static object* find_cached_member(
+      virtual_machine* vm, const inline_cache& cache, const object& obj, const object& key) noexcept;
+
+  /// Adds `key` to the cache if it is a key of the table `obj` or a member of the
+  /// struct instance `obj`.
+  static void update_inline_cache(inline_cache& cache, const object& obj, const object& key) noexcept;
 };
 
 } // namespace zs.
 
 namespace zs {
 
-zs::error_result virtual_machine::proxy::find_and_call_meta_get_func(virtual_machine* vm, const object& obj,
-    const object& key, const object& delegate, object& dest, bool& keep_looking) {
-
-  object fct;
+bool virtual_machine::proxy::find_meta_get_func(virtual_machine* vm, const object& delegate, object& fct) {
+  if (delegate.is_table()) {
+    // Skips the hash lookup when the table has no '__get'.
+    const object* meta_get = delegate.as_table().get_meta_method(meta_method::mt_get);
+    if (!meta_get) {
+      return false;
+    }
 
-  if (auto err = vm->raw_get(delegate, zs::_sv(constants::k_mt_get_string), fct)) {
-    keep_looking = true;
-    return {};
+    fct = *meta_get;
   }
-
-  if (fct.is_null()) {
-    keep_looking = true;
-    return {};
+  else if (auto err = vm->raw_get(delegate, zs::_sv(constants::k_mt_get_string), fct)) {
+    return false;
   }
 
-  // ?????
-  if (fct.is_none()) {
+  return !fct.is_null_or_none();
+}
+
+zs::error_result virtual_machine::proxy::find_and_call_meta_get_func(virtual_machine* vm, const object& obj,
+    const object& key, const object& delegate, object& dest, bool& keep_looking) {
+
+  object fct;
+  if (!find_meta_get_func(vm, delegate, fct)) {
     keep_looking = true;
     return {};
   }
@@ -217,4 +235,57 @@ zs::error_result virtual_machine::proxy::get(virtual_machine* vm, const object&
   return errc::not_found;
 }
 
+object* virtual_machine::proxy::find_cached_member(
+    virtual_machine* vm, const inline_cache& cache, const object& obj, const object& key) noexcept {
+
+  if (obj.is_table()) {
+    const inline_cache::entry* e = cache.find(obj._table->get_version(), key);
+    return e ? e->value : nullptr;
+  }
+
+  if (obj.is_struct_instance()) {
+    struct_instance_object& sobj = *obj._struct_instance;
+    const struct_object& sbase = sobj.get_base().as_struct();
+
+    if (const inline_cache::entry* e = cache.find(sbase.get_version(), key)) {
+      if (!sbase[e->slot].is_private or vm->_stack[0]._struct_instance == &sobj) {
+        return &sobj[e->slot];
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+void virtual_machine::proxy::update_inline_cache(
+    inline_cache& cache, const object& obj, const object& key) noexcept {
+
+  if (obj.is_table()) {
+    table_object& tbl = *obj._table;
+
+    // Only the keys owned by the table are cached, not the ones from the delegates.
+    if (object* value = tbl.get(key)) {
+      cache.add_value(tbl.get_version(), key, value);
+    }
+
+    return;
+  }
+
+  if (obj.is_struct_instance() and key.is_string()) {
+    const struct_object& sbase = obj._struct_instance->get_base().as_struct();
+
+    if (sbase.get_name() == key) {
+      return;
+    }
+
+    const int_t sz = sbase.size();
+    for (int_t i = 0; i < sz; i++) {
+      if (sbase[i].key == key) {
+        cache.add_slot(sbase.get_version(), key, i);
+        return;
+      }
+    }
+  }
+}
+
 } // namespace zs.
@@ -64,7 +64,7 @@ errc vm_t::exec_op<op_load_small_string>(inst_it_t& it, exec_op_data_t& op_data)
 template <>
 errc vm_t::exec_op<op_load_string>(inst_it_t& it, exec_op_data_t& op_data) {
   cinst_t<op_load_string> inst = it;
-  _stack[inst.target_idx] = op_data.fct->_literals[inst.idx];
+  _stack[inst.target_idx] = op_data.fct->get_literal(inst.idx);
   return errc::success;
 }
 
@@ -72,7 +72,7 @@ errc vm_t::exec_op<op_load_string>(inst_it_t& it, exec_op_data_t& op_data) {
 template <>
 errc vm_t::exec_op<op_load>(inst_it_t& it, exec_op_data_t& op_data) {
   cinst_t<op_load> inst = it;
-  _stack[inst.target_idx] = op_data.fct->_literals[inst.idx];
+  _stack[inst.target_idx] = op_data.fct->get_literal(inst.idx);
   return errc::success;
 }
 
@@ -218,41 +218,250 @@ errc vm_t::exec_op<op_triple_or>(inst_it_t& it, exec_op_data_t& op_data) {
 }
 
 //
-//
+// MARK: Foreach.
 //
 
-// op_get.
+// op_foreach_prep.
 template <>
-errc vm_t::exec_op<op_get>(inst_it_t& it, exec_op_data_t& op_data) {
-  cinst_t<op_get> inst = it;
+errc vm_t::exec_op<op_foreach_prep>(inst_it_t& it, exec_op_data_t& op_data) {
+  cinst_t<op_foreach_prep> inst = it;
+
+  const object container = _stack[inst.container_idx];
+
+  // Arrays, tables, strings and struct instances are iterated with an index.
+  // For strings, the second slot holds the code point index, for tables the key
+  // of the last visited pair.
+  if (container.is_array() or container.is_table() or container.is_string()) {
+    _stack[inst.iterator_idx] = 0;
+    _stack[inst.iterator_idx + 1] = 0;
+    return errc::success;
+  }
+
+  if (container.is_struct_instance()
+      and !container.as_struct_instance().get_base().as_struct().contains_method(zs::_ss("begin"))) {
+    _stack[inst.iterator_idx] = 0;
+    _stack[inst.iterator_idx + 1] = nullptr;
+    return errc::success;
+  }
+
+  // Any other type needs to provide `begin()` and `end()` iterators.
+  object begin_fct;
+  object end_fct;
+  if (this->get(container, zs::_ss("begin"), begin_fct) or this->get(container, zs::_ss("end"), end_fct)) {
+    return ZS_VM_ERROR(errc::invalid_type, "Can't iterate over type '", container.get_type(), "'.\n");
+  }
+
+  object begin_it;
+  object end_it;
+  ZS_RETURN_IF_ERROR(this->call(begin_fct, container, begin_it));
+  ZS_RETURN_IF_ERROR(this->call(end_fct, container, end_it));
+
+  _stack[inst.iterator_idx] = begin_it;
+  _stack[inst.iterator_idx + 1] = end_it;
+  return errc::success;
+}
+
+// op_foreach_next.
+template <>
+errc vm_t::exec_op<op_foreach_next>(inst_it_t& it, exec_op_data_t& op_data) {
+  cinst_t<op_foreach_next> inst = it;
+
+  const object& container = _stack[inst.container_idx];
+  object& iterator = _stack[inst.iterator_idx];
+
+  object key;
+  object value;
+
+  if (container.is_array()) {
+    const array_object& arr = container.as_array();
+    const int_t index = iterator._int;
+
+    if (index >= (int_t)arr.size()) {
+      it.data_ptr_ref() += inst.offset;
+      return errc::success;
+    }
+
+    key = index;
+    value = arr[index];
+    iterator._int = index + 1;
+  }
+
+  else if (container.is_string()) {
+    const std::string_view str = container.get_string_unchecked();
+    const int_t index = iterator._int;
+
+    if (index >= (int_t)str.size()) {
+      it.data_ptr_ref() += inst.offset;
+      return errc::success;
+    }
+
+    object& cp_index = _stack[inst.iterator_idx + 1];
+    key = cp_index._int++;
+
+    // Invalid or truncated sequences are returned one byte at a time.
+    const size_t length = zb::unicode::sequence_length((uint8_t)str[index]);
+    if (length == 0 or length > str.size() - (size_t)index) {
+      value = object::create_char((uint8_t)str[index]);
+      iterator._int = index + 1;
+    }
+    else {
+      value = object::create_char(zb::unicode::next_u8_to_u32_s(str.data() + index));
+      iterator._int = index + (int_t)length;
+    }
+  }
+
+  else if (container.is_table()) {
+    // An erase moves the last pair in place of the erased one. When the last
+    // visited pair isn't at its index anymore, it was erased by the loop body and
+    // the pair that took its place is visited instead of being skipped.
+    const table_object& tbl = container.as_table();
+    object& last_key = _stack[inst.iterator_idx + 1];
+    int_t index = iterator._int;
+
+    if (index > 0 and index <= (int_t)tbl.size() and !tbl.begin()[index - 1].first.strict_equal(last_key)) {
+      index--;
+    }
+
+    if (index >= (int_t)tbl.size()) {
+      it.data_ptr_ref() += inst.offset;
+      return errc::success;
+    }
+
+    const table_object::value_type& item = tbl.begin()[index];
+    key = item.first;
+    value = item.second;
+    last_key = item.first;
+    iterator._int = index + 1;
+  }
+
+  else if (container.is_struct_instance() and iterator.is_integer()) {
+    const struct_instance_object& sobj = container.as_struct_instance();
+    const zb::span<const struct_item> items = sobj.base_vector();
+    int_t index = iterator._int;
+
+    // Private members are skipped.
+    while (index < (int_t)items.size() and items[index].is_private) {
+      index++;
+    }
+
+    if (index >= (int_t)items.size()) {
+      it.data_ptr_ref() += inst.offset;
+      return errc::success;
+    }
+
+    key = items[index].key;
+    value = sobj[index];
+    iterator._int = index + 1;
+  }
+
+  else {
+    // Iterator protocol: `is_same(end)`, `get()`, `get_key()` and `next()`.
+    // Iterators without `get()` or `next()` use the previous protocol:
+    // `get_if_not(end)`, `get_key_if_not(end)` and `++it`.
+    const object it_obj = iterator;
+    const object end_obj = _stack[inst.iterator_idx + 1];
+
+    const object end_params[2] = { it_obj, end_obj };
+
+    object fct;
+    const auto has_method
+        = [&](const object& name) { return !this->get(it_obj, name, fct) and fct.is_function(); };
+
+    object is_same;
+    ZS_RETURN_IF_ERROR(this->get(it_obj, zs::_ss("is_same"), fct));
+    ZS_RETURN_IF_ERROR(this->call(fct, end_params, is_same));
+
+    if (is_same.is_if_true()) {
+      it.data_ptr_ref() += inst.offset;
+      return errc::success;
+    }
+
+    if (has_method(zs::_ss("get"))) {
+      ZS_RETURN_IF_ERROR(this->call(fct, it_obj, value));
+    }
+    else {
+      ZS_RETURN_IF_ERROR(this->get(it_obj, zs::_ss("get_if_not"), fct));
+      ZS_RETURN_IF_ERROR(this->call(fct, end_params, value));
+    }
+
+    if (inst.key_idx != k_invalid_target) {
+      if (has_method(zs::_ss("get_key"))) {
+        ZS_RETURN_IF_ERROR(this->call(fct, it_obj, key));
+      }
+      else {
+        ZS_RETURN_IF_ERROR(this->get(it_obj, zs::_ss("get_key_if_not"), fct));
+        ZS_RETURN_IF_ERROR(this->call(fct, end_params, key));
+      }
+    }
+
+    object next_it;
+    if (has_method(zs::_ss("next"))) {
+      ZS_RETURN_IF_ERROR(this->call(fct, it_obj, next_it));
+    }
+    else {
+      object src = it_obj;
+      ZS_RETURN_IF_ERROR(unary_arithmetic_operation(arithmetic_uop::uop_pre_incr, next_it, src));
+    }
+
+    _stack[inst.iterator_idx] = next_it;
+  }
+
+  if (inst.key_idx != k_invalid_target) {
+    _stack[inst.key_idx] = std::move(key);
+  }
+
+  _stack[inst.value_idx] = std::move(value);
+  it.data_ptr_ref() += zs::get_instruction_size<op_foreach_next>();
+  return errc::success;
+}
+
+//
+//
+//
+
+// op_get and op_get_method.
+inline errc vm_t::exec_get(uint8_t target_idx, uint8_t table_idx, uint8_t key_idx, get_op_flags_t flags,
+    uint16_t cache_idx, exec_op_data_t& op_data) {
+  inline_cache* cache
+      = cache_idx == k_invalid_inline_cache ? nullptr : &op_data.fct->_inline_caches[cache_idx];
+
+  if (cache) {
+    if (const object* value
+        = proxy::find_cached_member(this, *cache, _stack[table_idx], _stack[key_idx])) {
+      // The target could be the table itself, copy the value before releasing it.
+      object dst = *value;
+      _stack[target_idx] = std::move(dst);
+      return zs::error_code::success;
+    }
+  }
 
   object dst;
-  const object tbl = _stack[inst.table_idx];
-  const object key = _stack[inst.key_idx];
+  const object tbl = _stack[table_idx];
+  const object key = _stack[key_idx];
 
   if (auto err = this->get(tbl, key, dst)) {
 
     if (err == zs::error_code::not_found) {
-      if (zb::has_flag(inst.flags, get_op_flags_t::gf_look_in_root)) {
+      if (zb::has_flag(flags, get_op_flags_t::gf_look_in_root)) {
         // TODO: Use closure's root.
         if (auto err = this->get(_global_table, key, dst)) {
           zb::print("-------dsljkdjjksadl", key);
           return err;
         }
 
-        _stack[inst.target_idx] = dst;
+        _stack[target_idx] = dst;
         return zs::error_code::success;
       }
 
       set_error("Get failed in type: '", tbl.get_type(), "' with key: ", key, ".\n");
-      //      zb::print(stack_size(),inst.target_idx, key);
-      _stack[inst.target_idx].reset();
+      //      zb::print(stack_size(),target_idx, key);
+      _stack[target_idx].reset();
       return errc::inaccessible;
     }
 
     return err;
   }
-  //    if (err == zs::error_code::not_found && (inst.flags & get_op_flags_t::gf_look_in_root) != 0) {
+  //    if (err == zs::error_code::not_found && (flags & get_op_flags_t::gf_look_in_root) != 0) {
   //
   //      // TODO: Use closure's root.
   //      if (auto err = this->get(_root_table, key, dst)) {
@@ -264,16 +473,27 @@ errc vm_t::exec_op<op_get>(inst_it_t& it, exec_op_data_t& op_data) {
   //    }
   //    else {
   //      set_error("Get failed in type: '", tbl.get_type(), "' with key: ", key, ".\n");
-  //      zb::print(stack_size(),inst.target_idx, key);
-  //      _stack[inst.target_idx].reset();
+  //      zb::print(stack_size(),target_idx, key);
+  //      _stack[target_idx].reset();
   //      return err;
   //    }
   //  }
 
-  _stack[inst.target_idx] = dst;
+  if (cache) {
+    proxy::update_inline_cache(*cache, tbl, key);
+  }
+
+  _stack[target_idx] = dst;
   return zs::error_code::success;
 }
 
+// op_get.
+template <>
+errc vm_t::exec_op<op_get>(inst_it_t& it, exec_op_data_t& op_data) {
+  cinst_t<op_get> inst = it;
+  return exec_get(inst.target_idx, inst.table_idx, inst.key_idx, inst.flags, inst.cache_idx, op_data);
+}
+
 // op_set.
 template <>
 errc vm_t::exec_op<op_set>(inst_it_t& it, exec_op_data_t& op_data) {
@@ -282,9 +502,29 @@ errc vm_t::exec_op<op_set>(inst_it_t& it, exec_op_data_t& op_data) {
   object& tbl = _stack[inst.table_idx];
   const object& key = _stack[inst.key_idx];
   const object& value = _stack[inst.value_idx];
+
+  inline_cache* cache
+      = inst.cache_idx == k_invalid_inline_cache ? nullptr : &op_data.fct->_inline_caches[inst.cache_idx];
+
+  if (cache) {
+    if (object* dst = proxy::find_cached_member(this, *cache, tbl, key)) {
+      *dst = value;
+
+      if (inst.target_idx != k_invalid_target) {
+        _stack[inst.target_idx] = value;
+      }
+
+      return zs::error_code::success;
+    }
+  }
+
   //  zb::print("DSKLDKSLKDLKLDS", key, inst.can_create);
   zs::error_code err = inst.can_create ? this->set(tbl, key, value) : this->set_if_exists(tbl, key, value);
 
+  if (cache and err == zs::error_code::success) {
+    proxy::update_inline_cache(*cache, _stack[inst.table_idx], _stack[inst.key_idx]);
+  }
+
   if (inst.target_idx != k_invalid_target) {
     _stack[inst.target_idx] = value;
   }
@@ -374,11 +614,144 @@ errc vm_t::exec_op<op_rawset_ss>(inst_it_t& it, exec_op_data_t& op_data) {
 // MARK: Arithmetic.
 //
 
+/// Rewrites the opcode of the instruction at `it` in place, see the quickened
+/// instructions in `zopcode_def.h`.
+inline void quicken(const inst_it_t& it, opcode op) noexcept {
+  *const_cast<uint8_t*>(it.data()) = (uint8_t)op;
+}
+
+/// Returns the quickened `op_arith` for these operands, or `op_arith` if there is none.
+inline opcode get_quickened_arith_opcode(arithmetic_op aop, const object& lhs, const object& rhs) noexcept {
+  using enum arithmetic_op;
+
+  if (lhs.is_integer() and rhs.is_integer()) {
+    switch (aop) {
+    case aop_add:
+      return opcode::op_add_ii;
+    case aop_sub:
+      return opcode::op_sub_ii;
+    case aop_mul:
+      return opcode::op_mul_ii;
+    default:
+      return opcode::op_arith;
+    }
+  }
+
+  if (lhs.is_float() and rhs.is_float()) {
+    switch (aop) {
+    case aop_add:
+      return opcode::op_add_ff;
+    case aop_sub:
+      return opcode::op_sub_ff;
+    case aop_mul:
+      return opcode::op_mul_ff;
+    case aop_div:
+      return opcode::op_div_ff;
+    default:
+      return opcode::op_arith;
+    }
+  }
+
+  return opcode::op_arith;
+}
+
+/// Returns the quickened `op_cmp` for these operands, or `op_cmp` if there is none.
+inline opcode get_quickened_cmp_opcode(compare_op cmp_op, const object& lhs, const object& rhs) noexcept {
+  if (lhs.is_integer() and rhs.is_integer()) {
+    switch (cmp_op) {
+    case compare_op::eq:
+      return opcode::op_eq_ii;
+    case compare_op::ne:
+      return opcode::op_ne_ii;
+    case compare_op::lt:
+      return opcode::op_lt_ii;
+    case compare_op::le:
+      return opcode::op_le_ii;
+    case compare_op::gt:
+      return opcode::op_gt_ii;
+    case compare_op::ge:
+      return opcode::op_ge_ii;
+    default:
+      return opcode::op_cmp;
+    }
+  }
+
+  if (lhs.is_float() and rhs.is_float()) {
+    switch (cmp_op) {
+    case compare_op::lt:
+      return opcode::op_lt_ff;
+    case compare_op::le:
+      return opcode::op_le_ff;
+    case compare_op::gt:
+      return opcode::op_gt_ff;
+    case compare_op::ge:
+      return opcode::op_ge_ff;
+    default:
+      return opcode::op_cmp;
+    }
+  }
+
+  return opcode::op_cmp;
+}
+
+/// Returns the quickened `op_arith_int` for this `lhs`, or `op_arith_int` if there is none.
+/// The rhs of an `op_arith_int` is always an integer.
+inline opcode get_quickened_arith_int_opcode(arithmetic_op aop, const object& lhs) noexcept {
+  using enum arithmetic_op;
+
+  if (!lhs.is_integer()) {
+    return opcode::op_arith_int;
+  }
+
+  switch (aop) {
+  case aop_add:
+    return opcode::op_add_int_ii;
+  case aop_sub:
+    return opcode::op_sub_int_ii;
+  case aop_mul:
+    return opcode::op_mul_int_ii;
+  default:
+    return opcode::op_arith_int;
+  }
+}
+
+/// Returns the quickened `op_cmp_int_jz` for this `lhs`, or `op_cmp_int_jz` if there is none.
+/// The rhs of an `op_cmp_int_jz` is always an integer.
+inline opcode get_quickened_cmp_int_jz_opcode(compare_op cmp_op, const object& lhs) noexcept {
+  if (!lhs.is_integer()) {
+    return opcode::op_cmp_int_jz;
+  }
+
+  switch (cmp_op) {
+  case compare_op::eq:
+    return opcode::op_eq_int_jz_ii;
+  case compare_op::ne:
+    return opcode::op_ne_int_jz_ii;
+  case compare_op::lt:
+    return opcode::op_lt_int_jz_ii;
+  case compare_op::le:
+    return opcode::op_le_int_jz_ii;
+  case compare_op::gt:
+    return opcode::op_gt_int_jz_ii;
+  case compare_op::ge:
+    return opcode::op_ge_int_jz_ii;
+  default:
+    return opcode::op_cmp_int_jz;
+  }
+}
+
 // op_arith.
 template <>
 errc vm_t::exec_op<op_arith>(inst_it_t& it, exec_op_data_t& op_data) {
   cinst_t<op_arith> inst = it;
-  return arithmetic_operation(inst.aop, _stack[inst.target_idx], _stack[inst.lhs_idx], _stack[inst.rhs_idx]);
+  const object& lhs = _stack[inst.lhs_idx];
+  const object& rhs = _stack[inst.rhs_idx];
+
+  if (const opcode op = get_quickened_arith_opcode(inst.aop, lhs, rhs); op != op_arith) {
+    quicken(it, op);
+  }
+
+  return arithmetic_operation(inst.aop, _stack[inst.target_idx], lhs, rhs);
 }
 
 // op_arith_eq.
@@ -478,19 +851,30 @@ inline constexpr zb::enum_array<object (*)(const object&), compare_op> ds
         [](const object& obj) -> object { return obj._int >= 0; }, //
         [](const object& obj) { return obj; } };
 
+// op_cmp and the compare superinstructions.
+inline errc vm_t::exec_cmp(uint8_t target_idx, compare_op cmp_op, const object& lhs, const object& rhs) {
+  object result;
+  if (auto err = this->compare(result, lhs, rhs)) {
+    return err;
+  }
+
+  ZS_ASSERT(result.is_integer());
+  _stack[target_idx] = ds[cmp_op](result);
+  return errc::success;
+}
+
 // op_cmp.
 template <>
 errc vm_t::exec_op<op_cmp>(inst_it_t& it, exec_op_data_t& op_data) {
   cinst_t<op_cmp> inst = it;
+  const object& lhs = _stack[inst.lhs_idx];
+  const object& rhs = _stack[inst.rhs_idx];
 
-  object result;
-  if (auto err = this->compare(result, _stack[inst.lhs_idx], _stack[inst.rhs_idx])) {
-    return err;
+  if (const opcode op = get_quickened_cmp_opcode(inst.cmp_op, lhs, rhs); op != op_cmp) {
+    quicken(it, op);
   }
 
-  ZS_ASSERT(result.is_integer());
-  _stack[inst.target_idx] = ds[inst.cmp_op](result);
-  return errc::success;
+  return exec_cmp(inst.target_idx, inst.cmp_op, lhs, rhs);
 }
 
 // op_strict_eq
@@ -1002,11 +1386,39 @@ errc vm_t::exec_op<op_call>(inst_it_t& it, exec_op_data_t& op_data) {
   cinst_t<op_call> inst = it;
 
   object closure_obj = _stack[inst.closure_idx];
+
+  // A script closure doesn't need a native frame, `executor::run()` keeps going
+  // with the callee instructions and comes back here on return.
+  if (closure_obj.is_closure() and _registers[0].is_null()) {
+    zs::closure_object* closure = closure_obj._closure;
+    const zs::function_parameter_interface cl_info = closure->get_parameter_interface();
+    zs::parameter_list params = _stack.get_relative_subspan(inst.stack_base, inst.n_params);
+    const object* bound_this = cl_info.get_this();
+
+    ZS_RETURN_IF_ERROR(push_call_frame(
+        closure_obj, cl_info, params, bound_this and !bound_this->is_null() ? *bound_this : params[0]));
+
+    call_info& cinfo = _call_stack.back();
+    cinfo.call_ptr = it.data();
+    cinfo.caller_closure = op_data.closure;
+    cinfo.caller_fct = op_data.fct;
+
+    // We make room for the function stack by pushing some empty objects.
+    zs::function_prototype_object* fpo = closure->get_function_prototype();
+    _stack.push_n(fpo->_stack_size - stack_size());
+
+    op_data.closure = closure;
+    op_data.fct = fpo;
+    it = fpo->_instructions.begin();
+    return k_entered_call;
+  }
+
   object ret_value;
 
   ZS_RETURN_IF_ERROR(this->call(closure_obj, inst.n_params, inst.stack_base, ret_value, true));
   _stack[inst.target_idx] = ret_value;
 
+  it.data_ptr_ref() += get_instruction_size<op_call>();
   return zs::error_code::success;
 }
 
@@ -1086,4 +1498,240 @@ errc vm_t::exec_op<op_obj_not>(inst_it_t& it, exec_op_data_t& op_data) {
   return zs::error_code::success;
 }
 
+//
+// MARK: Superinstructions.
+//
+
+// op_arith_int.
+template <>
+errc vm_t::exec_op<op_arith_int>(inst_it_t& it, exec_op_data_t& op_data) {
+  cinst_t<op_arith_int> inst = it;
+  object& value = _stack[inst.value_idx];
+  value = inst.value;
+  const object& lhs = _stack[inst.lhs_idx];
+
+  if (const opcode op = get_quickened_arith_int_opcode(inst.aop, lhs); op != op_arith_int) {
+    quicken(it, op);
+  }
+
+  return arithmetic_operation(inst.aop, _stack[inst.target_idx], lhs, value);
+}
+
+// op_cmp_int.
+template <>
+errc vm_t::exec_op<op_cmp_int>(inst_it_t& it, exec_op_data_t& op_data) {
+  cinst_t<op_cmp_int> inst = it;
+  object& value = _stack[inst.value_idx];
+  value = inst.value;
+  return exec_cmp(inst.target_idx, inst.cmp_op, _stack[inst.lhs_idx], value);
+}
+
+// op_cmp_jz.
+template <>
+errc vm_t::exec_op<op_cmp_jz>(inst_it_t& it, exec_op_data_t& op_data) {
+  cinst_t<op_cmp_jz> inst = it;
+  ZS_RETURN_IF_ERROR(exec_cmp(inst.target_idx, inst.cmp_op, _stack[inst.lhs_idx], _stack[inst.rhs_idx]));
+
+  it.data_ptr_ref()
+      += !_stack[inst.target_idx].is_if_true() ? inst.offset : zs::get_instruction_size<op_cmp_jz>();
+  return errc::success;
+}
+
+// op_cmp_int_jz.
+template <>
+errc vm_t::exec_op<op_cmp_int_jz>(inst_it_t& it, exec_op_data_t& op_data) {
+  cinst_t<op_cmp_int_jz> inst = it;
+  object& value = _stack[inst.value_idx];
+  value = inst.value;
+  const object& lhs = _stack[inst.lhs_idx];
+
+  if (const opcode op = get_quickened_cmp_int_jz_opcode(inst.cmp_op, lhs); op != op_cmp_int_jz) {
+    quicken(it, op);
+  }
+
+  ZS_RETURN_IF_ERROR(exec_cmp(inst.target_idx, inst.cmp_op, lhs, value));
+
+  it.data_ptr_ref()
+      += !_stack[inst.target_idx].is_if_true() ? inst.offset : zs::get_instruction_size<op_cmp_int_jz>();
+  return errc::success;
+}
+
+// op_get_method.
+template <>
+errc vm_t::exec_op<op_get_method>(inst_it_t& it, exec_op_data_t& op_data) {
+  cinst_t<op_get_method> inst = it;
+  ZS_RETURN_IF_ERROR(
+      exec_get(inst.target_idx, inst.table_idx, inst.key_idx, inst.flags, inst.cache_idx, op_data));
+
+  _stack[inst.this_idx] = _stack[inst.table_idx];
+  return errc::success;
+}
+
+//
+// Struct member slots.
+//
+
+/// Returns the member at `slot_idx` of the struct instance `obj`, or nullptr if
+/// `obj` doesn't have a public member `key` at this slot (not the struct the
+/// compiler saw or not a struct instance at all).
+inline object* get_struct_slot(const object& obj, uint16_t slot_idx, const object& key) noexcept {
+  if (!obj.is_struct_instance()) {
+    return nullptr;
+  }
+
+  struct_instance_object& sobj = *obj._struct_instance;
+
+  // Members can be added to a struct after an instance was created.
+  if (slot_idx >= sobj.size()) {
+    return nullptr;
+  }
+
+  const struct_item& item = sobj.get_base().as_struct()[slot_idx];
+  return (item.is_private or item.key != key) ? nullptr : &sobj[slot_idx];
+}
+
+// op_get_struct_slot.
+template <>
+errc vm_t::exec_op<op_get_struct_slot>(inst_it_t& it, exec_op_data_t& op_data) {
+  cinst_t<op_get_struct_slot> inst = it;
+
+  if (const object* value = get_struct_slot(_stack[inst.table_idx], inst.slot_idx, _stack[inst.key_idx])) {
+    // The target could be the instance itself, copy the value before releasing it.
+    object dst = *value;
+    _stack[inst.target_idx] = std::move(dst);
+    return errc::success;
+  }
+
+  return exec_get(inst.target_idx, inst.table_idx, inst.key_idx, get_op_flags_t::gf_none,
+      k_invalid_inline_cache, op_data);
+}
+
+// op_set_struct_slot.
+template <>
+errc vm_t::exec_op<op_set_struct_slot>(inst_it_t& it, exec_op_data_t& op_data) {
+  cinst_t<op_set_struct_slot> inst = it;
+
+  object& tbl = _stack[inst.table_idx];
+  const object& key = _stack[inst.key_idx];
+  const object& value = _stack[inst.value_idx];
+
+  zs::error_code err = errc::success;
+
+  if (object* dst = get_struct_slot(tbl, inst.slot_idx, key)) {
+    *dst = value;
+  }
+  else {
+    err = inst.can_create ? this->set(tbl, key, value) : this->set_if_exists(tbl, key, value);
+  }
+
+  if (inst.target_idx != k_invalid_target) {
+    _stack[inst.target_idx] = value;
+  }
+
+  return err;
+}
+
+//
+// Quickened instructions.
+//
+
+// On a type miss, the instruction goes back to `BaseOp` which runs the
+// generic operation and quickens it again for the new types if it can.
+#define ZS_VM_DECL_QUICKENED_OP(Op, BaseOp, IsType, Member, Expr)    \
+  template <>                                                        \
+  errc vm_t::exec_op<Op>(inst_it_t & it, exec_op_data_t & op_data) { \
+    cinst_t<Op> inst = it;                                           \
+    const object& lhs = _stack[inst.lhs_idx];                        \
+    const object& rhs = _stack[inst.rhs_idx];                        \
+                                                                     \
+    if (ZBASE_UNLIKELY(!lhs.IsType() or !rhs.IsType())) {            \
+      quicken(it, BaseOp);                                           \
+      return exec_op<BaseOp>(it, op_data);                           \
+    }                                                                \
+                                                                     \
+    const auto a = lhs.Member;                                       \
+    const auto b = rhs.Member;                                       \
+    _stack[inst.target_idx] = Expr;                                  \
+    return errc::success;                                            \
+  }
+
+ZS_VM_DECL_QUICKENED_OP(op_add_ii, op_arith, is_integer, _int, a + b)
+ZS_VM_DECL_QUICKENED_OP(op_sub_ii, op_arith, is_integer, _int, a - b)
+ZS_VM_DECL_QUICKENED_OP(op_mul_ii, op_arith, is_integer, _int, a * b)
+ZS_VM_DECL_QUICKENED_OP(op_add_ff, op_arith, is_float, _float, a + b)
+ZS_VM_DECL_QUICKENED_OP(op_sub_ff, op_arith, is_float, _float, a - b)
+ZS_VM_DECL_QUICKENED_OP(op_mul_ff, op_arith, is_float, _float, a * b)
+ZS_VM_DECL_QUICKENED_OP(op_div_ff, op_arith, is_float, _float, a / b)
+
+ZS_VM_DECL_QUICKENED_OP(op_eq_ii, op_cmp, is_integer, _int, a == b)
+ZS_VM_DECL_QUICKENED_OP(op_ne_ii, op_cmp, is_integer, _int, a != b)
+ZS_VM_DECL_QUICKENED_OP(op_lt_ii, op_cmp, is_integer, _int, a < b)
+ZS_VM_DECL_QUICKENED_OP(op_le_ii, op_cmp, is_integer, _int, a <= b)
+ZS_VM_DECL_QUICKENED_OP(op_gt_ii, op_cmp, is_integer, _int, a > b)
+ZS_VM_DECL_QUICKENED_OP(op_ge_ii, op_cmp, is_integer, _int, a >= b)
+
+// `op_cmp` treats two unordered floats as `lhs > rhs`, so `gt` and `ge`
+// are written from `lt` and `le` to keep the same result with a NaN.
+ZS_VM_DECL_QUICKENED_OP(op_lt_ff, op_cmp, is_float, _float, a < b)
+ZS_VM_DECL_QUICKENED_OP(op_le_ff, op_cmp, is_float, _float, a <= b)
+ZS_VM_DECL_QUICKENED_OP(op_gt_ff, op_cmp, is_float, _float, !(a <= b))
+ZS_VM_DECL_QUICKENED_OP(op_ge_ff, op_cmp, is_float, _float, !(a < b))
+
+#undef ZS_VM_DECL_QUICKENED_OP
+
+// Same as above for the superinstructions, the rhs is the constant `value`
+// which is still stored at `value_idx` like the `op_load_int` it replaces.
+#define ZS_VM_DECL_QUICKENED_ARITH_INT_OP(Op, Expr)                  \
+  template <>                                                        \
+  errc vm_t::exec_op<Op>(inst_it_t & it, exec_op_data_t & op_data) { \
+    cinst_t<Op> inst = it;                                           \
+    _stack[inst.value_idx] = inst.value;                             \
+    const object& lhs = _stack[inst.lhs_idx];                        \
+                                                                     \
+    if (ZBASE_UNLIKELY(!lhs.is_integer())) {                         \
+      quicken(it, op_arith_int);                                     \
+      return exec_op<op_arith_int>(it, op_data);                     \
+    }                                                                \
+                                                                     \
+    const int_t a = lhs._int;                                        \
+    const int_t b = inst.value;                                      \
+    _stack[inst.target_idx] = Expr;                                  \
+    return errc::success;                                            \
+  }
+
+ZS_VM_DECL_QUICKENED_ARITH_INT_OP(op_add_int_ii, a + b)
+ZS_VM_DECL_QUICKENED_ARITH_INT_OP(op_sub_int_ii, a - b)
+ZS_VM_DECL_QUICKENED_ARITH_INT_OP(op_mul_int_ii, a * b)
+
+#undef ZS_VM_DECL_QUICKENED_ARITH_INT_OP
+
+#define ZS_VM_DECL_QUICKENED_CMP_INT_JZ_OP(Op, Expr)                             \
+  template <>                                                                    \
+  errc vm_t::exec_op<Op>(inst_it_t & it, exec_op_data_t & op_data) {             \
+    cinst_t<Op> inst = it;                                                       \
+    _stack[inst.value_idx] = inst.value;                                         \
+    const object& lhs = _stack[inst.lhs_idx];                                    \
+                                                                                 \
+    if (ZBASE_UNLIKELY(!lhs.is_integer())) {                                     \
+      quicken(it, op_cmp_int_jz);                                                \
+      return exec_op<op_cmp_int_jz>(it, op_data);                                \
+    }                                                                            \
+                                                                                 \
+    const int_t a = lhs._int;                                                    \
+    const int_t b = inst.value;                                                  \
+    const bool result = Expr;                                                    \
+    _stack[inst.target_idx] = result;                                            \
+    it.data_ptr_ref() += !result ? inst.offset : zs::get_instruction_size<Op>(); \
+    return errc::success;                                                        \
+  }
+
+ZS_VM_DECL_QUICKENED_CMP_INT_JZ_OP(op_eq_int_jz_ii, a == b)
+ZS_VM_DECL_QUICKENED_CMP_INT_JZ_OP(op_ne_int_jz_ii, a != b)
+ZS_VM_DECL_QUICKENED_CMP_INT_JZ_OP(op_lt_int_jz_ii, a < b)
+ZS_VM_DECL_QUICKENED_CMP_INT_JZ_OP(op_le_int_jz_ii, a <= b)
+ZS_VM_DECL_QUICKENED_CMP_INT_JZ_OP(op_gt_int_jz_ii, a > b)
+ZS_VM_DECL_QUICKENED_CMP_INT_JZ_OP(op_ge_int_jz_ii, a >= b)
+
+#undef ZS_VM_DECL_QUICKENED_CMP_INT_JZ_OP
+
 } // namespace zs.
@@ -0,0 +1,164 @@
+#include <zscript/zscript.h>
+#include <zscript/base/utility/scoped.h>
+#include "object/zfunction_prototype.h"
+
+namespace zs {
+
+namespace {
+  ZS_INLINE void add_bytes(allocation_stats& stats, size_t size) noexcept {
+    stats.live_bytes += size;
+    stats.peak_bytes = zb::maximum(stats.peak_bytes, stats.live_bytes);
+    stats.live_count++;
+    stats.allocation_count++;
+  }
+
+  ZS_INLINE void remove_bytes(allocation_stats& stats, size_t size) noexcept {
+    stats.live_bytes -= size;
+    stats.live_count--;
+  }
+
+  ZS_INLINE zs::string to_string(zs::engine* eng, const object& obj) {
+    return zs::string(obj.is_string() ? obj.get_string_unchecked() : std::string_view(),
+        zs::string_allocator(eng, memory_tag::nt_allocator));
+  }
+} // namespace.
+
+std::string_view allocation_tracker::get_tag_name(memory_tag tag) noexcept {
+  switch (tag) {
+  case memory_tag::nt_unknown:
+    return "unknown";
+  case memory_tag::nt_engine:
+    return "engine";
+  case memory_tag::nt_vm:
+    return "vm";
+  case memory_tag::nt_array:
+    return "array";
+  case memory_tag::nt_table:
+    return "table";
+  case memory_tag::nt_struct:
+    return "struct";
+  case memory_tag::nt_class:
+    return "class";
+  case memory_tag::nt_string:
+    return "string";
+  case memory_tag::nt_user_data:
+    return "user_data";
+  case memory_tag::nt_native_closure:
+    return "native_closure";
+  case memory_tag::nt_weak_ptr:
+    return "weak_ptr";
+  case memory_tag::nt_capture:
+    return "capture";
+  case memory_tag::nt_allocator:
+    return "allocator";
+  }
+
+  return "unknown";
+}
+
+allocation_tracker::allocation_tracker(zs::engine* eng)
+    : zs::engine_holder(eng)
+    , _blocks(zs::unordered_map_allocator<const void*, block>(eng, memory_tag::nt_allocator))
+    , _site_indices(zs::unordered_map_allocator<site_key, uint32_t>(eng, memory_tag::nt_allocator))
+    , _sites(zs::allocator<site>(eng, memory_tag::nt_allocator)) {}
+
+void allocation_tracker::add(const void* ptr, size_t size, alloc_info_t ainfo) {
+  if (!ptr or _is_paused) {
+    return;
+  }
+
+  // The tables allocate through the engine, these calls come back here.
+  _is_paused = true;
+  zb::scoped resume = [&]() { _is_paused = false; };
+
+  const uint32_t tag = ainfo < k_tag_count ? (uint32_t)ainfo : (uint32_t)memory_tag::nt_unknown;
+  const uint32_t site_index = get_site_index();
+
+  _blocks[ptr] = { size, tag, site_index };
+  add_bytes(_tag_stats[tag], size);
+
+  if (site_index != k_no_site) {
+    add_bytes(_sites[site_index].stats, size);
+  }
+}
+
+void allocation_tracker::remove(const void* ptr) noexcept {
+  // A block of the tracker itself, it was never added.
+  if (_is_paused) {
+    return;
+  }
+
+  _is_paused = true;
+  zb::scoped resume = [&]() { _is_paused = false; };
+
+  auto it = _blocks.find(ptr);
+  if (it == _blocks.end()) {
+    return;
+  }
+
+  const block b = it->second;
+  _blocks.erase(it);
+
+  remove_bytes(_tag_stats[b.tag], b.size);
+
+  if (b.site != k_no_site) {
+    remove_bytes(_sites[b.site].stats, b.size);
+  }
+}
+
+uint32_t allocation_tracker::get_site_index() {
+  const engine::script_position* pos = _engine->get_script_position();
+  if (!pos or !*pos->fct) {
+    return k_no_site;
+  }
+
+  const function_prototype_object* fct = *pos->fct;
+  const instruction_vector& insts = fct->_instructions;
+
+  // The iterator still points to the caller instruction on the first
+  // allocations of a call (or to the callee one after a return).
+  uint32_t line = 0;
+  if (pos->it->data() >= insts.begin().data() and pos->it->data() < insts.end().data()) {
+    if (const line_table::entry* linfo = fct->_line_info.find(pos->it->get_index(insts))) {
+      line = linfo->line;
+    }
+  }
+
+  const site_key key = { fct, line };
+  if (auto it = _site_indices.find(key); it != _site_indices.end()) {
+    return it->second;
+  }
+
+  // A site is identified by the prototype address, the names are copied since
+  // the prototype could be gone by the time the stats are read.
+  _sites.push_back({ to_string(_engine, fct->_name), to_string(_engine, fct->_source_name), line, {} });
+
+  const uint32_t index = (uint32_t)(_sites.size() - 1);
+  _site_indices.emplace(key, index);
+  return index;
+}
+
+zs::vector<allocation_site_stats> allocation_tracker::get_site_stats() {
+  _is_paused = true;
+
+  zs::vector<allocation_site_stats> stats((zs::allocator<allocation_site_stats>(_engine)));
+  stats.reserve(_sites.size());
+
+  for (const site& s : _sites) {
+    stats.push_back({ zs::string(s.name, zs::string_allocator(_engine)),
+        zs::string(s.source_name, zs::string_allocator(_engine)), s.line, s.stats });
+  }
+
+  _is_paused = false;
+
+  std::stable_sort(stats.begin(), stats.end(),
+      [](const allocation_site_stats& lhs, const allocation_site_stats& rhs) {
+        const allocation_stats& l = lhs.stats;
+        const allocation_stats& r = rhs.stats;
+        return l.live_bytes == r.live_bytes ? l.allocation_count > r.allocation_count
+                                            : l.live_bytes > r.live_bytes;
+      });
+
+  return stats;
+}
+} // namespace zs.
@@ -0,0 +1,178 @@
+#include <zscript/zscript.h>
+#include <zscript/utility/string_template.h>
+#include "object/zfunction_prototype.h"
+
+namespace zs {
+
+namespace {
+  /// Every block starts with its size, padded to keep the blocks 16 bytes aligned.
+  struct arena_block_header {
+    size_t size;
+    size_t padding;
+  };
+
+  inline constexpr size_t k_arena_alignment = sizeof(arena_block_header);
+
+  ZS_CK_INLINE_CXPR size_t arena_block_size(size_t size) noexcept {
+    return sizeof(arena_block_header) + ((size + k_arena_alignment - 1) & ~(k_arena_alignment - 1));
+  }
+
+  ZS_CK_INLINE arena_block_header* get_arena_block_header(void* ptr) noexcept {
+    return ((arena_block_header*)ptr) - 1;
+  }
+} // namespace.
+
+arena_allocator::arena_allocator(zs::engine* eng, size_t chunk_size)
+    : zs::engine_holder(eng)
+    , _chunks((zs::allocator<chunk>(eng, memory_tag::nt_allocator)))
+    , _chunk_size(zb::maximum(chunk_size, arena_block_size(0))) {}
+
+arena_allocator::~arena_allocator() {
+  // The chunks are given back to the engine allocator directly, the engine
+  // would see them as arena memory.
+  for (const chunk& c : _chunks) {
+    (*_engine->_allocator)(
+        _engine, _engine->_user_pointer, c.data, 0, c.size, (alloc_info_t)memory_tag::nt_allocator);
+  }
+}
+
+bool arena_allocator::add_chunk(size_t min_size) {
+  size_t size = _chunk_size;
+  while (size < min_size) {
+    size *= 2;
+  }
+
+  uint8_t* data = (uint8_t*)(*_engine->_allocator)(
+      _engine, _engine->_user_pointer, nullptr, size, 0, (alloc_info_t)memory_tag::nt_allocator);
+  if (!data) {
+    return false;
+  }
+
+  // Sorted by address for `contains()`.
+  const auto it = std::upper_bound(
+      _chunks.begin(), _chunks.end(), data, [](const uint8_t* lhs, const chunk& c) { return lhs < c.data; });
+  _chunks.insert(it, { data, size });
+  _begin = data;
+  _end = data + size;
+  _last_block = nullptr;
+  _chunk_size = zb::minimum(zb::maximum(size, _chunk_size * 2), constants::k_max_arena_chunk_size);
+  return true;
+}
+
+void* arena_allocator::allocate(size_t size) {
+  const size_t block_size = arena_block_size(size);
+
+  if ((size_t)(_end - _begin) < block_size and !add_chunk(block_size)) {
+    return nullptr;
+  }
+
+  arena_block_header* header = zb_placement_new(_begin) arena_block_header{ size, 0 };
+  _last_block = _begin;
+  _begin += block_size;
+  _live_count++;
+  return header + 1;
+}
+
+void* arena_allocator::reallocate(void* ptr, size_t size) {
+  arena_block_header* header = get_arena_block_header(ptr);
+  const size_t block_size = arena_block_size(header->size);
+  const size_t new_block_size = arena_block_size(size);
+
+  if (new_block_size <= block_size) {
+    header->size = size;
+    return ptr;
+  }
+
+  // The last block can grow in place.
+  if (_is_open and (uint8_t*)header == _last_block and (size_t)(_end - _last_block) >= new_block_size) {
+    header->size = size;
+    _begin = _last_block + new_block_size;
+    return ptr;
+  }
+
+  // A closed arena doesn't give new blocks, move the block to the engine allocator.
+  void* new_ptr = _is_open ? allocate(size) : _engine->allocate(size, (alloc_info_t)memory_tag::nt_unknown);
+  if (!new_ptr) {
+    return nullptr;
+  }
+
+  zb::memcpy(new_ptr, ptr, header->size);
+  deallocate(ptr);
+  return new_ptr;
+}
+
+void arena_allocator::deallocate(void* ptr) noexcept {
+  zbase_assert(_live_count, "invalid arena deallocation");
+  _live_count--;
+
+  // Give back the last block.
+  if ((uint8_t*)get_arena_block_header(ptr) == _last_block) {
+    _begin = _last_block;
+    _last_block = nullptr;
+  }
+}
+
+bool arena_allocator::contains(const void* ptr) const noexcept {
+  const uint8_t* p = (const uint8_t*)ptr;
+
+  // The last chunk starting at or before `p`.
+  const auto it = std::upper_bound(
+      _chunks.begin(), _chunks.end(), p, [](const uint8_t* lhs, const chunk& c) { return lhs < c.data; });
+
+  return it != _chunks.begin() and p < std::prev(it)->data + std::prev(it)->size;
+}
+
+//
+// MARK: engine
+//
+
+zs::error_result engine::begin_arena(size_t chunk_size) {
+  if (_arena) {
+    return _arena->_is_open ? zs::errc::already_exists : zs::errc::invalid_operation;
+  }
+
+  _arena = internal::zs_new<memory_tag::nt_allocator, arena_allocator>(this, this, chunk_size);
+  return {};
+}
+
+zs::error_result engine::end_arena() {
+  if (!_arena or !_arena->_is_open) {
+    return zs::errc::invalid_operation;
+  }
+
+  _arena->_is_open = false;
+
+  // The caches can keep arena objects alive after the scope.
+  clear_string_template_cache(this);
+
+  // The function prototypes are found in the objects tracked by the garbage collector.
+#if ZS_GARBAGE_COLLECTOR
+  zs::vector<zs::object> protos((zs::allocator<zs::object>(this)));
+
+  for (zs::reference_counted_object* obj : _gc._objs.get()) {
+    if (obj->get_object_type() == object_type::k_user_data) {
+      if (zs::object o(obj, true); function_prototype_object::is_proto(o)) {
+        protos.push_back(std::move(o));
+      }
+    }
+  }
+
+  for (const zs::object& proto : protos) {
+    function_prototype_object::as_proto(proto).clear_inline_caches();
+  }
+#endif // ZS_GARBAGE_COLLECTOR.
+
+  // Cycles of arena objects would otherwise look like escaped objects.
+  if (_arena->_live_count) {
+    (void)collect_garbage();
+  }
+
+  if (_arena->_live_count) {
+    // Released by `deallocate()` with the last escaped object.
+    return zs::errc::invalid_operation;
+  }
+
+  internal::zs_delete<memory_tag::nt_allocator>(this, std::exchange(_arena, nullptr));
+  return {};
+}
+} // namespace zs.
@@ -260,7 +260,10 @@ static inline constexpr __zb::error_code errno_to_error_code(int err) {
 struct file_view_impl {
 
 #if __FSX_FILE_VIEW_USE_WINDOWS_MEMORY_MAP
-  static __fsx::status open(const char* file_path, uint8_t*& _data, size_t& _size) noexcept {
+  static __fsx::status open(
+      const char* file_path, uint8_t*& _data, size_t& _size, file_view::open_mode mode) noexcept {
+    const bool cow = mode == file_view::open_mode::copy_on_write;
+
     HANDLE hFile = CreateFileA(
         file_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
 
@@ -283,13 +286,14 @@ struct file_view_impl {
       return __fsx::status_code::unknown;
     }
 
-    HANDLE hMap = CreateFileMappingA(hFile, nullptr, PAGE_READONLY, 0, file_size, nullptr);
+    HANDLE hMap
+        = CreateFileMappingA(hFile, nullptr, cow ? PAGE_WRITECOPY : PAGE_READONLY, 0, file_size, nullptr);
     if (!hMap) {
       CloseHandle(hFile);
       return __fsx::status_code::unknown;
     }
 
-    uint8_t* ptr = (uint8_t*)MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, file_size);
+    uint8_t* ptr = (uint8_t*)MapViewOfFile(hMap, cow ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, file_size);
 
     // We can call CloseHandle here, but it will not be closed until we unmap
     // the view.
@@ -310,7 +314,8 @@ struct file_view_impl {
   // mmap
   //
 #elif __FSX_FILE_VIEW_USE_POSIX_MEMORY_MAP
-  static __zb::error_result open(const char* file_path, uint8_t*& _data, size_t& _size) noexcept {
+  static __zb::error_result open(
+      const char* file_path, uint8_t*& _data, size_t& _size, file_view::open_mode mode) noexcept {
     int fd = ::open(file_path, O_RDONLY);
     if (fd < 0) {
       return errno_to_error_code(errno);
@@ -325,7 +330,8 @@ struct file_view_impl {
     }
 
     // Create file map.
-    uint8_t* data = (uint8_t*)mmap(nullptr, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int prot = mode == file_view::open_mode::copy_on_write ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    uint8_t* data = (uint8_t*)mmap(nullptr, (size_t)size, prot, MAP_PRIVATE, fd, 0);
 
     if (data == MAP_FAILED) {
       __zb::error_code ec = errno_to_error_code(errno);
@@ -345,7 +351,9 @@ struct file_view_impl {
   // Using c FILE*
   //
 #else
-  static __zb::error_result open(const char* file_path, uint8_t*& _data, size_t& _size) noexcept {
+  // The buffer is always writable.
+  static __zb::error_result open(
+      const char* file_path, uint8_t*& _data, size_t& _size, file_view::open_mode) noexcept {
     FILE* fd = nullptr;
 
 #ifdef _WIN32
@@ -400,9 +408,9 @@ struct file_view_impl {
 };
 } // namespace
 
-__zb::error_result file_view::open(const char* file_path) noexcept {
+__zb::error_result file_view::open(const char* file_path, open_mode mode) noexcept {
   close();
-  return file_view_impl::open(file_path, _data, _size);
+  return file_view_impl::open(file_path, _data, _size, mode);
 }
 
 void file_view::close() noexcept {
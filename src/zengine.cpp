@@ -1,5 +1,6 @@
 #include <zscript/zscript.h>
 #include <zscript/base/sys/path.h>
+#include "utility/zimport_archive.h"
 
 namespace zs {
 namespace {
@@ -9,7 +10,7 @@ namespace {
 template <>
 struct internal::proxy<engine_pimpl_proxy_tag> {
 
-  enum class objects { registry, import_directories, count };
+  enum class objects { registry, import_directories, import_archives, bytecode_cache_directory, count };
   using enum objects;
 
   using objects_array = std::array<zs::object, (size_t)objects::count>;
@@ -23,6 +24,7 @@ struct internal::proxy<engine_pimpl_proxy_tag> {
   static inline void init_objects(engine* eng) {
     zb_placement_new(eng->_objects.data()) objects_array();
     get_object<import_directories>(eng) = zs::_a(eng, 0);
+    get_object<import_archives>(eng) = zs::_a(eng, 0);
     get_object<registry>(eng) = zs::_t(eng);
   }
 
@@ -45,8 +47,10 @@ engine::engine(allocate_t alloc_cb, raw_pointer_t user_pointer, raw_pointer_rele
     : _allocator(alloc_cb)
     , _user_pointer(user_pointer)
     , _user_pointer_release(user_release)
+    , _user_pointer_releaser{ this }
     , _stream_getter(stream_getter)
-    , _initializer(initializer) //
+    , _initializer(initializer)
+    , _interned_strings(zs::allocator<string_object*>(this, memory_tag::nt_engine)) //
     ZS_IF_GARBAGE_COLLECTOR(, _gc(this)) {
 
   _engine_idx = (uint8_t)-1;
@@ -70,12 +74,11 @@ engine::~engine() {
 
   ZS_IF_GARBAGE_COLLECTOR(_gc.finalize());
 
-  if (_user_pointer_release) {
-    (*_user_pointer_release)(_allocator, _user_pointer);
+  if (_arena) {
+    internal::zs_delete<memory_tag::nt_allocator>(this, std::exchange(_arena, nullptr));
   }
 
-  _user_pointer = nullptr;
-  _user_pointer_release = nullptr;
+  stop_allocation_tracking();
 
   s_engines[_engine_idx] = nullptr;
 
@@ -83,21 +86,108 @@ engine::~engine() {
       _global_ref_count == 0, "Invalid reference count (", _global_ref_count, ") should be zero"));
 }
 
+engine::user_pointer_releaser::~user_pointer_releaser() {
+  // Without a release hook, the user pointer is kept for the deallocation of
+  // the engine (see `destroy_engine()` in zvirtual_machine.cpp).
+  if (eng->_user_pointer_release) {
+    (*eng->_user_pointer_release)(eng->_allocator, eng->_user_pointer);
+    eng->_user_pointer = nullptr;
+    eng->_user_pointer_release = nullptr;
+  }
+}
+
 void* engine::allocate(size_t size, alloc_info_t ainfo) {
   zbase_assert(_allocator, "invalid allocator callback");
-  return (*_allocator)(this, _user_pointer, nullptr, size, 0, ainfo);
+
+  // A storage flagged with `k_outside_arena_alloc_flag` is never an arena tag.
+  const bool in_arena = _arena and _arena->_is_open and arena_allocator::is_arena_tag(ainfo);
+  ainfo &= ~constants::k_outside_arena_alloc_flag;
+
+  void* ptr = in_arena ? _arena->allocate(size) : (*_allocator)(this, _user_pointer, nullptr, size, 0, ainfo);
+
+#if ZS_MEMORY_PROFILER
+  if (ZBASE_UNLIKELY(_alloc_tracker != nullptr)) {
+    _alloc_tracker->add(ptr, size, ainfo);
+  }
+#endif // ZS_MEMORY_PROFILER.
+
+  return ptr;
 }
 
 void* engine::reallocate(void* ptr, size_t size, size_t old_size, alloc_info_t ainfo) {
   zbase_assert(_allocator, "invalid allocator callback");
-  return (*_allocator)(this, _user_pointer, ptr, size, old_size, ainfo);
+
+  ainfo &= ~constants::k_outside_arena_alloc_flag;
+
+  void* new_ptr = (_arena and _arena->contains(ptr))
+      ? _arena->reallocate(ptr, size)
+      : (*_allocator)(this, _user_pointer, ptr, size, old_size, ainfo);
+
+#if ZS_MEMORY_PROFILER
+  // The old block is still valid when the reallocation failed.
+  if (ZBASE_UNLIKELY(_alloc_tracker != nullptr) and new_ptr) {
+    _alloc_tracker->remove(ptr);
+    _alloc_tracker->add(new_ptr, size, ainfo);
+  }
+#endif // ZS_MEMORY_PROFILER.
+
+  return new_ptr;
 }
 
 void engine::deallocate(void* ptr, alloc_info_t ainfo) {
   zbase_assert(_allocator, "invalid allocator callback");
+
+  ainfo &= ~constants::k_outside_arena_alloc_flag;
+
+#if ZS_MEMORY_PROFILER
+  if (ZBASE_UNLIKELY(_alloc_tracker != nullptr)) {
+    _alloc_tracker->remove(ptr);
+  }
+#endif // ZS_MEMORY_PROFILER.
+
+  if (_arena and _arena->contains(ptr)) {
+    _arena->deallocate(ptr);
+
+    // The last object that escaped a closed arena.
+    if (!_arena->_is_open and !_arena->_live_count) {
+      internal::zs_delete<memory_tag::nt_allocator>(this, std::exchange(_arena, nullptr));
+    }
+    return;
+  }
+
   (*_allocator)(this, _user_pointer, ptr, 0, 0, ainfo);
 }
 
+void engine::start_allocation_tracking() {
+#if ZS_MEMORY_PROFILER
+  stop_allocation_tracking();
+  _alloc_tracker = internal::zs_new<memory_tag::nt_allocator, allocation_tracker>(this, this);
+#endif // ZS_MEMORY_PROFILER.
+}
+
+void engine::stop_allocation_tracking() noexcept {
+  if (_alloc_tracker) {
+    // Detached first, the tracker would otherwise see its own deallocation.
+    internal::zs_delete<memory_tag::nt_allocator>(this, std::exchange(_alloc_tracker, nullptr));
+  }
+}
+
+allocation_stats engine::get_allocation_stats(memory_tag tag) const noexcept {
+  if (!_alloc_tracker or (size_t)tag >= allocation_tracker::k_tag_count) {
+    return {};
+  }
+
+  return _alloc_tracker->_tag_stats[(size_t)tag];
+}
+
+zs::vector<allocation_site_stats> engine::get_allocation_site_stats() const {
+  if (!_alloc_tracker) {
+    return zs::vector<allocation_site_stats>((zs::allocator<allocation_site_stats>((engine*)this)));
+  }
+
+  return _alloc_tracker->get_site_stats();
+}
+
 table_object& engine::get_registry_table_object() noexcept {
   return engine_proxy::get_object<engine_proxy::registry>(this).as_table();
 }
@@ -130,6 +220,18 @@ object engine::get_registry_object(std::string_view name) const noexcept {
   return nullptr;
 }
 
+size_t engine::interned_string_hash::operator()(const string_object* sobj) const noexcept {
+  return sobj->hash();
+}
+
+size_t engine::interned_string_hash::operator()(std::string_view s) const noexcept {
+  return object_table_hash()(s);
+}
+
+bool engine::interned_string_equal_to::operator()(const string_object* lhs, std::string_view rhs) const noexcept {
+  return lhs->get_string() == rhs;
+}
+
 void engine::set_user_pointer(raw_pointer_t uptr) { _user_pointer = uptr; }
 
 void engine::set_stream_getter(stream_getter_t stream_getter) { _stream_getter = stream_getter; }
@@ -183,6 +285,57 @@ zs::error_result engine::add_import_directory(const std::filesystem::path& direc
   return {};
 }
 
+zs::error_result engine::add_import_archive(const std::filesystem::path& archive) {
+  const zs::string path_str = archive.generic_string<char, std::char_traits<char>, zs::string_allocator>(
+      zs::string_allocator(this, memory_tag::nt_engine));
+
+  zs::array_object& archives = engine_proxy::get_object<engine_proxy::import_archives>(this).as_array();
+
+  for (const object& obj : archives) {
+    if (as_import_archive(obj).get_path() == std::string_view(path_str)) {
+      return {};
+    }
+  }
+
+  object obj;
+  if (auto err = create_import_archive(this, path_str.c_str(), obj)) {
+    return err;
+  }
+
+  archives.push_back(std::move(obj));
+  return {};
+}
+
+const object& engine::get_import_archives() const noexcept {
+  return engine_proxy::get_object<engine_proxy::import_archives>(this);
+}
+
+zs::error_result engine::set_bytecode_cache_directory(const std::filesystem::path& directory) {
+  object& dir = engine_proxy::get_object<engine_proxy::bytecode_cache_directory>(this);
+
+  if (directory.empty()) {
+    dir = nullptr;
+    return {};
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(directory, ec);
+
+  if (ec or !std::filesystem::is_directory(directory, ec)) {
+    return zs::error_code::invalid_directory;
+  }
+
+  const zs::string dir_str = directory.generic_string<char, std::char_traits<char>, zs::string_allocator>(
+      zs::string_allocator(this, memory_tag::nt_engine));
+
+  dir = zs::_s(this, std::string_view(dir_str));
+  return {};
+}
+
+const object& engine::get_bytecode_cache_directory() const noexcept {
+  return engine_proxy::get_object<engine_proxy::bytecode_cache_directory>(this);
+}
+
 std::ostream& engine::get_stream() { return _stream_getter(this, _user_pointer); }
 
 zs::error_result engine::resolve_file_path(std::string_view import_value, object& result) {
@@ -237,41 +390,4 @@ zs::error_result engine::resolve_file_path(std::string_view import_value, object
   result = zs::_ss("");
   return zs::errc::not_found;
 }
-
-garbage_collector::garbage_collector(zs::engine* eng)
-    : zs::engine_holder(eng)
-    , _objs(zb::aligned_type_storage_construct_tag{}, (zs::allocator<zs::reference_counted_object*>(eng))) {}
-
-void garbage_collector::finalize() {
-  {
-    zs::vector<zs::object> objs((zs::allocator<zs::object>(_engine)));
-    objs.reserve(_objs.get().size());
-
-    for (auto it : _objs.get()) {
-      objs.emplace_back(it, true);
-    }
-
-    for (auto& obj : objs) {
-      if (obj.is_table()) {
-        obj.as_table().clear();
-      }
-      else if (obj.is_array()) {
-        obj.as_array().clear();
-      }
-      else if (obj.is_closure()) {
-        obj.as_closure().clear();
-      }
-    }
-  }
-
-  _objs.destroy();
-}
-
-void garbage_collector::add(zs::engine* eng, zs::reference_counted_object* obj) {
-  ZS_IF_GARBAGE_COLLECTOR(eng->_gc._objs.data()->insert(obj));
-}
-
-void garbage_collector::remove(zs::engine* eng, zs::reference_counted_object* obj) {
-  ZS_IF_GARBAGE_COLLECTOR(eng->_gc._objs.data()->erase(obj));
-}
 } // namespace zs.
@@ -0,0 +1,513 @@
+#include <zscript/zscript.h>
+
+namespace zs {
+namespace {
+  struct garbage_collector_proxy_tag {};
+} // namespace.
+
+template <>
+struct internal::proxy<garbage_collector_proxy_tag> {
+
+  /// Calls `fct` for every counted reference held by `obj`.
+  template <class Fct>
+  static inline void traverse(reference_counted_object* obj, Fct&& fct) {
+    const auto visit = [&](const object_base& o) {
+      if (o.is_ref_counted()) {
+        fct(o._ref_counted);
+      }
+    };
+
+    const auto visit_delegate = [&](delegable_object* dobj) {
+      if (dobj->has_delegate()) {
+        fct(dobj->_delegate.get_pointer<table_object*>());
+      }
+    };
+
+    switch (obj->get_object_type()) {
+    case object_type::k_table: {
+      table_object* tbl = (table_object*)obj;
+      visit_delegate(tbl);
+
+      for (const auto& it : *tbl) {
+        visit(it.first);
+        visit(it.second);
+      }
+      return;
+    }
+
+    case object_type::k_array: {
+      array_object* arr = (array_object*)obj;
+      visit_delegate(arr);
+
+      for (const object& o : *arr) {
+        visit(o);
+      }
+      return;
+    }
+
+    case object_type::k_user_data: {
+      user_data_object* uobj = (user_data_object*)obj;
+      visit_delegate(uobj);
+
+      // An open capture points to a stack value, only a baked one owns its value.
+      if (capture::is_capture(*uobj)) {
+        visit(uobj->data_ref<capture>()._value);
+      }
+      return;
+    }
+
+    case object_type::k_closure: {
+      closure_object* cobj = (closure_object*)obj;
+      visit(cobj->_function);
+      visit(cobj->_root);
+      visit(cobj->_this);
+
+      for (const object& o : cobj->_default_params) {
+        visit(o);
+      }
+
+      for (const object& o : cobj->_captured_values) {
+        visit(o);
+      }
+      return;
+    }
+
+    case object_type::k_native_closure: {
+      native_closure_object* nobj = (native_closure_object*)obj;
+      visit(nobj->_this);
+
+      for (const object& o : nobj->_default_params) {
+        visit(o);
+      }
+      return;
+    }
+
+    case object_type::k_struct: {
+      struct_object* sobj = (struct_object*)obj;
+
+      for (const struct_item& item : *sobj) {
+        visit(item.value);
+      }
+
+      for (const struct_item& item : sobj->_statics) {
+        visit(item.value);
+      }
+
+      for (const struct_method& m : sobj->_methods) {
+        visit(m.closure);
+      }
+
+      visit(sobj->_constructors);
+      return;
+    }
+
+    case object_type::k_struct_instance: {
+      struct_instance_object* sobj = (struct_instance_object*)obj;
+      visit(sobj->_base);
+
+      for (const object& o : sobj->get_span()) {
+        visit(o);
+      }
+      return;
+    }
+
+    default:
+      return;
+    }
+  }
+
+  /// Drops the references held by `obj` that can be part of a cycle.
+  /// The caller must keep `obj` alive.
+  static inline void clear(reference_counted_object* obj) {
+    switch (obj->get_object_type()) {
+    case object_type::k_table:
+      ((table_object*)obj)->clear();
+      ((table_object*)obj)->reset();
+      return;
+
+    case object_type::k_array:
+      ((array_object*)obj)->clear();
+      ((array_object*)obj)->reset();
+      return;
+
+    case object_type::k_user_data: {
+      user_data_object* uobj = (user_data_object*)obj;
+      uobj->reset();
+
+      if (capture::is_capture(*uobj)) {
+        uobj->data_ref<capture>()._value.reset();
+      }
+      return;
+    }
+
+    case object_type::k_closure:
+      ((closure_object*)obj)->clear();
+      return;
+
+    case object_type::k_native_closure: {
+      native_closure_object* nobj = (native_closure_object*)obj;
+      nobj->_this.reset();
+      nobj->_default_params.clear();
+      return;
+    }
+
+    case object_type::k_struct: {
+      struct_object* sobj = (struct_object*)obj;
+
+      for (struct_item& item : *sobj) {
+        item.value.reset();
+      }
+
+      for (struct_item& item : sobj->_statics) {
+        item.value.reset();
+      }
+
+      for (struct_method& m : sobj->_methods) {
+        m.closure.reset();
+      }
+
+      sobj->_constructors.reset();
+      return;
+    }
+
+    case object_type::k_struct_instance:
+      for (object& o : ((struct_instance_object*)obj)->get_span()) {
+        o.reset();
+      }
+      return;
+
+    default:
+      return;
+    }
+  }
+};
+
+namespace {
+  using gc_proxy = internal::proxy<garbage_collector_proxy_tag>;
+} // namespace.
+
+garbage_collector::garbage_collector(zs::engine* eng)
+    : zs::engine_holder(eng)
+    , _objs(zb::aligned_type_storage_construct_tag{}, (zs::allocator<zs::reference_counted_object*>(eng)))
+    , _possible_roots((zs::allocator<zs::reference_counted_object*>(eng)))
+    , _nodes((zs::allocator<node>(eng)))
+    , _node_indices((zs::unordered_map_allocator<zs::reference_counted_object*, size_t>(eng)))
+    , _alive((zs::allocator<size_t>(eng))) {}
+
+void garbage_collector::finalize() {
+  reset_cycle();
+  _is_collecting = true;
+
+  {
+    zs::vector<zs::object> objs((zs::allocator<zs::object>(_engine)));
+    objs.reserve(_objs.get().size());
+
+    for (auto it : _objs.get()) {
+      objs.emplace_back(it, true);
+    }
+
+    for (auto& obj : objs) {
+      gc_proxy::clear(obj._ref_counted);
+    }
+  }
+
+  _possible_roots.clear();
+  _objs.destroy();
+}
+
+void garbage_collector::add(zs::engine* eng, zs::reference_counted_object* obj) {
+#if ZS_GARBAGE_COLLECTOR
+  eng->_gc._objs.data()->insert(obj);
+
+  // Object creation is where the collector keeps up with the program.
+  eng->_gc.step_if_needed();
+#endif // ZS_GARBAGE_COLLECTOR.
+}
+
+void garbage_collector::remove(zs::engine* eng, zs::reference_counted_object* obj) {
+#if ZS_GARBAGE_COLLECTOR
+  garbage_collector& gc = eng->_gc;
+  gc._objs.data()->erase(obj);
+
+  if (obj->_gc_possible_root) {
+    gc._possible_roots.erase(obj);
+  }
+
+  if (obj->_gc_node) {
+    auto it = gc._node_indices.find(obj);
+    ZS_ASSERT(it != gc._node_indices.end(), "invalid garbage collector node");
+    gc._nodes[it->second].obj = nullptr;
+    gc._node_indices.erase(it);
+  }
+#endif // ZS_GARBAGE_COLLECTOR.
+}
+
+void garbage_collector::add_possible_root(zs::engine* eng, zs::reference_counted_object* obj) {
+  ZS_IF_GARBAGE_COLLECTOR(eng->_gc._possible_roots.insert(obj));
+}
+
+void garbage_collector::step_if_needed() {
+  if (!_threshold or _is_collecting) {
+    return;
+  }
+
+  if (_phase == phase::idle) {
+    if (_possible_roots.size() >= _threshold) {
+      (void)step(_step_budget);
+    }
+  }
+  else if (!_step_countdown--) {
+    (void)step(_step_budget);
+  }
+}
+
+size_t garbage_collector::step(size_t budget) {
+  if (_is_collecting) {
+    return 0;
+  }
+
+  budget = zb::maximum(budget, (size_t)1);
+
+  if (_phase == phase::idle) {
+    if (_possible_roots.empty()) {
+      return 0;
+    }
+
+    for (auto it = _possible_roots.begin(); it != _possible_roots.end() and _nodes.size() < budget;) {
+      (*it)->_gc_possible_root = false;
+      add_node(*it);
+      it = _possible_roots.erase(it);
+    }
+
+    _phase = phase::mark;
+  }
+
+  _step_countdown = constants::k_gc_step_interval;
+  return run(budget);
+}
+
+size_t garbage_collector::collect() {
+  if (_is_collecting) {
+    return 0;
+  }
+
+  reset_cycle();
+
+  for (zs::reference_counted_object* obj : _possible_roots) {
+    obj->_gc_possible_root = false;
+  }
+
+  _possible_roots.clear();
+
+  for (zs::reference_counted_object* obj : _objs.get()) {
+    if (is_traversable(obj->get_object_type())) {
+      add_node(obj);
+    }
+  }
+
+  if (_nodes.empty()) {
+    return 0;
+  }
+
+  _phase = phase::mark;
+  return run((size_t)-1);
+}
+
+void garbage_collector::add_node(zs::reference_counted_object* obj) {
+  if (obj->_gc_node) {
+    return;
+  }
+
+  obj->_gc_node = true;
+  _node_indices.emplace(obj, _nodes.size());
+  _nodes.push_back({ obj, obj->ref_count() });
+}
+
+size_t garbage_collector::run(size_t budget) {
+  size_t work = 0;
+
+  // Build the graph of everything reachable from the roots.
+  // The count of a node is its reference count when it is found.
+  if (_phase == phase::mark) {
+    for (; _cursor < _nodes.size() and work < budget; _cursor++, work++) {
+      if (zs::reference_counted_object* obj = _nodes[_cursor].obj) {
+        gc_proxy::traverse(obj, [&](zs::reference_counted_object* child) {
+          if (is_traversable(child->get_object_type())) {
+            add_node(child);
+          }
+        });
+      }
+    }
+
+    if (_cursor < _nodes.size()) {
+      return 0;
+    }
+
+    _cursor = 0;
+    _phase = phase::trial_deletion;
+  }
+
+  // Trial deletion of the internal references.
+  if (_phase == phase::trial_deletion) {
+    for (; _cursor < _nodes.size() and work < budget; _cursor++, work++) {
+      if (zs::reference_counted_object* obj = _nodes[_cursor].obj) {
+        gc_proxy::traverse(obj, [&](zs::reference_counted_object* child) {
+          // The graph can change between two steps, the counts are only a hint
+          // and the garbage is validated in `finish()`.
+          if (child->_gc_node) {
+            size_t& count = _nodes[_node_indices.find(child)->second].count;
+            count -= count != 0;
+          }
+        });
+      }
+    }
+
+    if (_cursor < _nodes.size()) {
+      return 0;
+    }
+
+    _cursor = 0;
+    _phase = phase::scan;
+  }
+
+  // Everything reachable from an externally referenced object is alive.
+  while (work < budget) {
+    if (_alive.empty()) {
+      for (; _cursor < _nodes.size(); _cursor++) {
+        node& n = _nodes[_cursor];
+        if (n.obj and n.count and n.count != k_alive) {
+          n.count = k_alive;
+          _alive.push_back(_cursor++);
+          break;
+        }
+      }
+
+      if (_alive.empty()) {
+        return finish();
+      }
+    }
+
+    zs::reference_counted_object* obj = _nodes[_alive.get_pop_back()].obj;
+    if (!obj) {
+      continue;
+    }
+
+    work++;
+    gc_proxy::traverse(obj, [&](zs::reference_counted_object* child) {
+      if (child->_gc_node) {
+        const size_t index = _node_indices.find(child)->second;
+        if (_nodes[index].count != k_alive) {
+          _nodes[index].count = k_alive;
+          _alive.push_back(index);
+        }
+      }
+    });
+  }
+
+  return 0;
+}
+
+size_t garbage_collector::finish() {
+  // The rest is only referenced by unreachable objects.
+  zs::vector<zs::object> garbage((zs::allocator<zs::object>(_engine)));
+
+  for (const node& n : _nodes) {
+    if (n.obj and n.count == 0) {
+      garbage.emplace_back(n.obj, true);
+    }
+  }
+
+  // The program ran between the steps, this is only garbage if all the
+  // references to it come from the garbage itself. One reference per object
+  // is held by `garbage`.
+  size_t n_refs = 0;
+  size_t n_internal_refs = 0;
+
+  for (const zs::object& obj : garbage) {
+    n_refs += obj._ref_counted->ref_count() - 1;
+
+    gc_proxy::traverse(obj._ref_counted, [&](zs::reference_counted_object* child) {
+      if (child->_gc_node and _nodes[_node_indices.find(child)->second].count == 0) {
+        n_internal_refs++;
+      }
+    });
+  }
+
+  reset_cycle();
+
+  // Otherwise the objects become possible roots again when `garbage` is released.
+  if (n_refs != n_internal_refs) {
+    return 0;
+  }
+
+  _is_collecting = true;
+
+  for (zs::object& obj : garbage) {
+    gc_proxy::clear(obj._ref_counted);
+  }
+
+  const size_t count = garbage.size();
+  garbage.clear();
+
+  _is_collecting = false;
+  return count;
+}
+
+void garbage_collector::reset_cycle() {
+  for (const node& n : _nodes) {
+    if (n.obj) {
+      n.obj->_gc_node = false;
+    }
+  }
+
+  _nodes.clear();
+  _node_indices.clear();
+  _alive.clear();
+  _cursor = 0;
+  _phase = phase::idle;
+}
+
+//
+// MARK: engine
+//
+
+size_t engine::collect_garbage() {
+#if ZS_GARBAGE_COLLECTOR
+  return _gc.collect();
+#else
+  return 0;
+#endif // ZS_GARBAGE_COLLECTOR.
+}
+
+size_t engine::collect_garbage_step() {
+#if ZS_GARBAGE_COLLECTOR
+  return _gc.step(_gc._step_budget);
+#else
+  return 0;
+#endif // ZS_GARBAGE_COLLECTOR.
+}
+
+void engine::set_garbage_collector_threshold(size_t threshold) noexcept {
+  ZS_IF_GARBAGE_COLLECTOR(_gc._threshold = threshold);
+}
+
+size_t engine::get_garbage_collector_threshold() const noexcept {
+#if ZS_GARBAGE_COLLECTOR
+  return _gc._threshold;
+#else
+  return 0;
+#endif // ZS_GARBAGE_COLLECTOR.
+}
+
+void engine::set_garbage_collector_step_budget(size_t budget) noexcept {
+  ZS_IF_GARBAGE_COLLECTOR(_gc._step_budget = budget);
+}
+
+size_t engine::get_garbage_collector_step_budget() const noexcept {
+#if ZS_GARBAGE_COLLECTOR
+  return _gc._step_budget;
+#else
+  return 0;
+#endif // ZS_GARBAGE_COLLECTOR.
+}
+} // namespace zs.
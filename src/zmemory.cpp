@@ -118,6 +118,8 @@ namespace {
 reference_counted_object::reference_counted_object(zs::engine* eng, object_type obj_type) noexcept
     : engine_holder(eng)
     , _ref_count(1)
+    , _gc_possible_root(0)
+    , _gc_node(0)
     , _obj_type(obj_type) {
 
   ZS_IF_USE_ENGINE_GLOBAL_REF_COUNT(engine_rc_proxy::incr_global_ref_count(eng));
@@ -154,6 +156,14 @@ bool reference_counted_object::release() noexcept {
     return true;
   }
 
+#if ZS_GARBAGE_COLLECTOR
+  // Still referenced, this object could now be part of an unreachable cycle.
+  if (!_gc_possible_root and zs::garbage_collector_rc_proxy::is_traversable(_obj_type)) {
+    _gc_possible_root = 1;
+    zs::garbage_collector_rc_proxy::add_possible_root(eng, this);
+  }
+#endif // ZS_GARBAGE_COLLECTOR.
+
   return false;
 }
 
@@ -1241,7 +1241,7 @@ zs::error_result object_base::to_debug_string(zs::string& s) const {
   return {};
 }
 
-ZB_CHECK zs::object_map* object_base::get_table_internal_map() const noexcept {
+ZB_CHECK zs::table_map* object_base::get_table_internal_map() const noexcept {
   if (!is_table()) {
     return nullptr;
   }
@@ -1367,6 +1367,21 @@ namespace {
 bool object_base::strict_equal(const object_base& rhs) const noexcept {
   // Any string with the same values are considered equals.
   if (is_string() and rhs.is_string()) {
+    if (_type == object_type::k_long_string and rhs._type == object_type::k_long_string) {
+      if (_lstring == rhs._lstring) {
+        return true;
+      }
+
+      // Two different interned strings can't have the same content.
+      if (_lstring->is_interned() and rhs._lstring->is_interned()) {
+        return false;
+      }
+
+      if (_lstring->hash() != rhs._lstring->hash()) {
+        return false;
+      }
+    }
+
     return get_string_unchecked() == rhs.get_string_unchecked();
   }
 
@@ -25,6 +25,7 @@
 #include <zscript/zscript.h>
 #include "vm/object_stack.h"
 #include "bytecode/zinstruction_vector.h"
+#include "vm/zprofiler.h"
 
 namespace zs {
 
@@ -63,6 +64,12 @@ struct call_info {
   int_t previous_stack_base;
   int_t previous_top_index;
 
+  /// Caller state of a script closure entered by an `op_call` without leaving
+  /// `executor::run()`, `call_ptr` is null for any other call.
+  const uint8_t* call_ptr = nullptr;
+  zs::closure_object* caller_closure = nullptr;
+  zs::function_prototype_object* caller_fct = nullptr;
+
   friend std::ostream& operator<<(std::ostream& s, const call_info& ci);
 };
 
@@ -150,6 +157,18 @@ public:
   /// @brief Get a reference to the module loaders table object.
   ZS_CHECK table_object& get_module_loaders() noexcept;
 
+  //
+  // MARK: Arena.
+  //
+
+  /// @brief Allocate the short lived objects in an arena until `end_arena()`.
+  /// See `engine::begin_arena()`.
+  ZS_CHECK zs::error_result begin_arena(size_t chunk_size = constants::k_default_arena_chunk_size);
+
+  /// @brief Release the arena, fails if some arena objects escaped the scope.
+  /// See `engine::end_arena()`.
+  ZS_CHECK zs::error_result end_arena();
+
   //
   // MARK: Calls.
   //
@@ -267,6 +286,19 @@ public:
 
   ZS_CK_INLINE const zs::vector<call_info>& get_call_stack() const noexcept { return _call_stack; }
 
+  //
+  // MARK: Profiler.
+  //
+
+  /// Starts sampling the script call stack, the previous samples are cleared.
+  /// Returns `errc::unimplemented` when `ZS_SCRIPT_PROFILER` is disabled.
+  ZS_CHECK zs::error_result start_profiler(const sampling_profiler::options& opts = {});
+
+  /// Stops sampling, the samples are kept until the next `start_profiler()`.
+  void stop_profiler() noexcept;
+
+  ZS_CK_INLINE const sampling_profiler& get_profiler() const noexcept { return _profiler; }
+
   //
   // MARK: Errors.
   //
@@ -314,6 +346,7 @@ private:
   zs::vector<object> _open_captures;
 
   zs::error_stack _errors;
+  sampling_profiler _profiler;
 
   bool _owns_engine;
 
@@ -338,12 +371,23 @@ private:
     zs::instruction_vector::iterator get_instruction(size_t index) const noexcept;
   };
 
+  /// Returned by `op_call` once the frame of a script closure was pushed and
+  /// `op_data` points to it, `executor::run()` carries on with its instructions.
+  static constexpr zs::error_code k_entered_call = (zs::error_code)-1;
+
   template <opcode Op>
   zs::error_code exec_op_wrapper(zs::instruction_iterator& it, exec_op_data_t& op_data);
 
   template <opcode Op>
   zs::error_code exec_op(zs::instruction_iterator& it, exec_op_data_t& op_data);
 
+  /// Shared by `op_get` and `op_get_method`.
+  zs::error_code exec_get(uint8_t target_idx, uint8_t table_idx, uint8_t key_idx, get_op_flags_t flags,
+      uint16_t cache_idx, exec_op_data_t& op_data);
+
+  /// Shared by `op_cmp` and the compare superinstructions.
+  zs::error_code exec_cmp(uint8_t target_idx, compare_op cmp_op, const object& lhs, const object& rhs);
+
   struct proxy;
   struct runtime_table_proxy;
 
@@ -356,6 +400,16 @@ private:
   ZS_CHECK zs::error_result call_closure(
       const object& closure, zs::parameter_list params, object& ret_value, bool is_protected_call = false);
 
+  /// Pushes the call info, the parameters (with the missing default ones or the
+  /// variadic array) and `this`. The function stack is left to the caller.
+  ZS_CHECK zs::error_result push_call_frame(const object& closure_obj,
+      const zs::function_parameter_interface& cl_info, zs::parameter_list params, const object& this_obj);
+
+  /// Leaves the frame entered by `op_call` in `executor::run()` and resumes the caller
+  /// after its `op_call`.
+  ZS_CHECK zs::error_result leave_call_frame(
+      zs::instruction_iterator& it, exec_op_data_t& op_data, bool has_returned);
+
   zs::error_result tail_call_closure(const object& closure_obj, zs::parameter_list params, object& ret_value,
       bool is_protected_call = false);
 
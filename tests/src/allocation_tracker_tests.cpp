@@ -0,0 +1,75 @@
+#include "unit_tests.h"
+
+using namespace utest;
+
+TEST_CASE("allocation-tracker") {
+  constexpr std::string_view code = R"""(
+function grow(n) {
+  var r = [];
+  for(var i = 0; i < n; i++) {
+    r.push({ i = i, s = "a string longer than a small string " + i });
+  }
+  return r;
+}
+
+var kept = grow(100);
+var stats = zs.mem_stats();
+return [kept, stats];
+)""";
+
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+
+  zs::object proto;
+  {
+    zs::jit_compiler compiler(eng);
+    REQUIRE(!compiler.compile(code, "test", proto));
+  }
+
+  REQUIRE(!eng->is_tracking_allocations());
+  REQUIRE(eng->get_allocation_stats(zs::memory_tag::nt_table).allocation_count == 0);
+
+  eng->start_allocation_tracking();
+  REQUIRE(eng->is_tracking_allocations());
+
+  zs::object value;
+  REQUIRE(!vm->call(zs::_c(eng, proto, vm->global()), vm->global(), value));
+
+  const zs::allocation_stats table_stats = eng->get_allocation_stats(zs::memory_tag::nt_table);
+  REQUIRE(table_stats.live_count >= 100);
+  REQUIRE(table_stats.live_bytes > 0);
+  REQUIRE(table_stats.peak_bytes >= table_stats.live_bytes);
+  REQUIRE(table_stats.allocation_count >= table_stats.live_count);
+
+  // The tables and strings are allocated on the `r.push(...)` line.
+  {
+    const zs::vector<zs::allocation_site_stats> sites = eng->get_allocation_site_stats();
+    REQUIRE(!sites.empty());
+    REQUIRE(sites[0].name == "grow");
+    REQUIRE(sites[0].source_name == "test");
+    REQUIRE(sites[0].line == 5);
+    REQUIRE(sites[0].stats.live_count >= 200);
+  }
+
+  // Same from the script.
+  zs::object script_stats = value.as_array()[1];
+  REQUIRE(script_stats.is_table());
+  REQUIRE(script_stats.as_table()["tags"].as_table()["table"].as_table()["live_count"]._int >= 100);
+  REQUIRE(script_stats.as_table()["sites"].as_array()[0].as_table()["name"] == zs::_ss("grow"));
+
+  // Freeing the kept array gives the memory back.
+  value = nullptr;
+  REQUIRE(eng->get_allocation_stats(zs::memory_tag::nt_table).live_count < table_stats.live_count);
+
+  eng->stop_allocation_tracking();
+  REQUIRE(!eng->is_tracking_allocations());
+  REQUIRE(eng->get_allocation_site_stats().empty());
+}
+
+TEST_CASE("allocation-tracker-off") {
+  zs::vm vm;
+
+  zs::object value;
+  REQUIRE(!vm->call_buffer("return zs.mem_stats();", "test", value));
+  REQUIRE(value.is_null());
+}
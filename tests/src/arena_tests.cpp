@@ -0,0 +1,99 @@
+#include "unit_tests.h"
+
+using namespace utest;
+
+TEST_CASE("arena") {
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+
+  REQUIRE(!vm->begin_arena());
+  REQUIRE(eng->is_arena_open());
+  REQUIRE(vm->begin_arena());
+
+  {
+    zs::object closure;
+    REQUIRE(!vm->compile_buffer(R"""(
+var r = [];
+
+for(var i = 0; i < 1000; i++) {
+  r.push({ i = i, s = "a string longer than a small string " + i });
+}
+
+return r[999].i + r.size();
+)""", "arena", closure));
+
+    zs::object value;
+    REQUIRE(!vm->call(closure, vm->global(), value));
+    REQUIRE(value == 1999);
+  }
+
+  REQUIRE(!vm->end_arena());
+  REQUIRE(!eng->is_arena_open());
+  REQUIRE(vm->end_arena());
+}
+
+TEST_CASE("arena-escape") {
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+
+  REQUIRE(!vm->begin_arena());
+  zs::object escaped = zs::_a(eng, { 1, 2, 3 });
+
+  // The array is still referenced.
+  REQUIRE(vm->end_arena());
+  REQUIRE(!eng->is_arena_open());
+  REQUIRE(escaped == zs::_a(eng, { 1, 2, 3 }));
+
+  // Can't begin a new arena until the escaped array is destroyed.
+  REQUIRE(vm->begin_arena());
+
+  escaped.reset();
+  REQUIRE(!vm->begin_arena());
+  REQUIRE(!vm->end_arena());
+}
+
+TEST_CASE("arena-long-lived-table") {
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+
+  zs::object tbl = zs::_t(eng);
+
+  REQUIRE(!vm->begin_arena());
+
+  // The table storage follows the table, it is not an arena allocation.
+  for (zs::int_t i = 0; i < 100; i++) {
+    tbl.as_table()[i] = i;
+  }
+
+  zs::object arena_tbl = zs::_t(eng);
+  REQUIRE(eng->is_arena_allocation(arena_tbl._table));
+  REQUIRE(!eng->is_arena_allocation(tbl._table));
+  arena_tbl.reset();
+
+  REQUIRE(!vm->end_arena());
+  REQUIRE(tbl.as_table()[99] == 99);
+}
+
+TEST_CASE("arena-inline-cache") {
+  zs::vm vm;
+
+  zs::object closure;
+  REQUIRE(!vm->compile_buffer(R"""(
+var key = "a key longer than " + "a small string";
+var t = {};
+t[key] = 12;
+return t[key];
+)""", "arena", closure));
+
+  REQUIRE(!vm->begin_arena());
+
+  zs::object value;
+  REQUIRE(!vm->call(closure, vm->global(), value));
+  REQUIRE(value == 12);
+
+  // The key is still in the inline caches of the closure.
+  REQUIRE(!vm->end_arena());
+
+  REQUIRE(!vm->call(closure, vm->global(), value));
+  REQUIRE(value == 12);
+}
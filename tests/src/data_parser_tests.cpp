@@ -0,0 +1,66 @@
+#include "unit_tests.h"
+#include "utility/zdata_parser.h"
+#include "utility/zvm_load.h"
+
+using namespace utest;
+
+TEST_CASE("data-parser") {
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+
+  zs::object value;
+  REQUIRE(!zs::data_parser(eng).parse(R"""(
+// Comment.
+{
+  name = "data"
+  "quoted key": "a\tb",
+  [12] = -3.5,
+  values = [1, -2, 'c', 2.5, true, false, null, none, [], {}],
+  nested = { a = { b = [ { c = 1 } ] } }
+};
+)""",
+      value));
+
+  zs::table_object& tbl = value.as_table();
+  REQUIRE(tbl["name"] == zs::_ss("data"));
+  REQUIRE(tbl["quoted key"] == zs::_ss("a\tb"));
+  REQUIRE(tbl[12] == -3.5);
+
+  const zs::array_object& values = tbl["values"].as_array();
+  REQUIRE(values.size() == 10);
+  REQUIRE(values[0] == 1);
+  REQUIRE(values[1] == -2);
+  REQUIRE(values[2] == (zs::int_t)'c');
+  REQUIRE(values[3] == 2.5);
+  REQUIRE(values[4] == true);
+  REQUIRE(values[5] == false);
+  REQUIRE(values[6].is_null());
+  REQUIRE(values[7].is_none());
+  REQUIRE(values[8].is_array());
+  REQUIRE(values[9].is_table());
+
+  REQUIRE(tbl["nested"].as_table()["a"].as_table()["b"].as_array()[0].as_table()["c"] == 1);
+
+  // Expressions are not data.
+  zs::object other;
+  REQUIRE(zs::data_parser(eng).parse("{ a = 1 + 2 }", other) == zs::errc::unimplemented);
+  REQUIRE(zs::data_parser(eng).parse("{ a = b }", other) == zs::errc::unimplemented);
+  REQUIRE(zs::data_parser(eng).parse("[1, 2][0]", other) == zs::errc::unimplemented);
+  REQUIRE(zs::data_parser(eng).parse("{ a = 1 } print(1);", other) == zs::errc::unimplemented);
+  REQUIRE(other.is_null());
+}
+
+TEST_CASE("load_buffer_as_value") {
+  zs::vm vm;
+  vm->global().as_table()["b"] = 32;
+
+  zs::object value;
+  REQUIRE(!zs::load_buffer_as_value(vm, "{ a = [1, 2], b = { c = \"d\" } }", "data", value));
+  REQUIRE(value.as_table()["a"].as_array()[1] == 2);
+  REQUIRE(value.as_table()["b"].as_table()["c"] == zs::_ss("d"));
+
+  // Compiled and executed.
+  REQUIRE(!zs::load_buffer_as_value(vm, "{ a = 1 + 2, b = b }", "expr", value));
+  REQUIRE(value.as_table()["a"] == 3);
+  REQUIRE(value.as_table()["b"] == 32);
+}
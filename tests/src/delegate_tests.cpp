@@ -509,3 +509,41 @@ return k;
   //  zb::print(value);
   //  REQUIRE(value ==55);
 }
+
+ZTEST_CASE("delegate-meta-method-cache", R"""(
+var d = {
+  __sub = $(rhs) return 1;
+};
+
+var t = zs::set_delegate({}, d);
+var r = [t - 1];
+
+// The table had no '__sub' the first time.
+t.__sub = $(rhs) return 2;
+r.push(t - 1);
+
+t.__sub = $(rhs) return 3;
+r.push(t - 1);
+
+d.__get = $(key, delegate) return 4;
+r.push(t.a);
+return r;
+)""") {
+  REQUIRE(value == zs::_a(vm, { 1, 2, 3, 4 }));
+}
+
+TEST_CASE("table-meta-method-cache") {
+  zs::vm vm;
+  zs::object tbl = zs::_t(vm.get_engine());
+  zs::table_object& t = tbl.as_table();
+
+  REQUIRE(!t.get_meta_method(zs::meta_method::mt_add));
+
+  t[zs::constants::get<zs::meta_method::mt_add>()] = 32;
+  REQUIRE(t.get_meta_method(zs::meta_method::mt_add));
+  REQUIRE(*t.get_meta_method(zs::meta_method::mt_add) == 32);
+  REQUIRE(!t.get_meta_method(zs::meta_method::mt_sub));
+
+  REQUIRE(!t.erase(zs::constants::get<zs::meta_method::mt_add>()));
+  REQUIRE(!t.get_meta_method(zs::meta_method::mt_add));
+}
@@ -0,0 +1,234 @@
+#include "unit_tests.h"
+
+using namespace utest;
+
+ZTEST_CASE("for-auto-array", R"""(
+var a = [1, 2, 3, 4];
+var sum = 0;
+
+for(var v : a) {
+  sum += v;
+}
+
+return sum;
+)""") {
+  REQUIRE(value == 10);
+}
+
+ZTEST_CASE("for-auto-array-key", R"""(
+var a = [5, 6, 7];
+var b = [];
+
+for(var k, v : a) {
+  b.push(k * 10 + v);
+}
+
+return b;
+)""") {
+  REQUIRE(value == zs::_a(vm, { 5, 16, 27 }));
+}
+
+ZTEST_CASE("for-auto-empty", R"""(
+var count = 0;
+
+for(var v : []) {
+  count++;
+}
+
+for(var k, v : {}) {
+  count++;
+}
+
+return count;
+)""") {
+  REQUIRE(value == 0);
+}
+
+ZTEST_CASE("for-auto-break-continue", R"""(
+var a = [1, 2, 3, 4, 5, 6];
+var b = [];
+
+for(var v : a) {
+  if(v == 2) {
+    continue;
+  }
+
+  if(v == 5) {
+    break;
+  }
+
+  b.push(v);
+}
+
+return b;
+)""") {
+  REQUIRE(value == zs::_a(vm, { 1, 3, 4 }));
+}
+
+ZTEST_CASE("for-auto-nested", R"""(
+var a = [[1, 2], [3, 4]];
+var sum = 0;
+
+for(var row : a) {
+  for(var v : row) {
+    sum += v;
+  }
+}
+
+return sum;
+)""") {
+  REQUIRE(value == 10);
+}
+
+ZTEST_CASE("for-auto-string", R"""(
+var a = [];
+
+for(var k, c : "AπC") {
+  a.push(k);
+  a.push(c);
+}
+
+return a;
+)""") {
+  REQUIRE(value == zs::_a(vm, { 0, 'A', 1, u'π', 2, 'C' }));
+}
+
+ZTEST_CASE("for-auto-type", R"""(
+var sum = 0;
+
+for(int v : [1, 2, 3]) {
+  sum += v;
+}
+
+return sum;
+)""") {
+  REQUIRE(value == 6);
+}
+
+ZTEST_CASE("for-auto-type-error", R"""(
+for(int v : [1, "A"]) {
+}
+)""",
+    compile_good | call_fail) {}
+
+ZTEST_CASE("for-auto-struct", R"""(
+struct A {
+  var a = 1;
+  var b = 2;
+  private var c = 3;
+};
+
+var keys = "";
+var sum = 0;
+
+for(var k, v : A()) {
+  keys += k;
+  sum += v;
+}
+
+return { keys = keys, sum = sum };
+)""") {
+  REQUIRE(value.as_table()["keys"] == "ab");
+  REQUIRE(value.as_table()["sum"] == 3);
+}
+
+ZTEST_CASE("for-auto-type-null", R"""(
+var count = 0;
+
+for(int v : [1, null, 3]) {
+  count++;
+}
+
+return count;
+)""") {
+  REQUIRE(value == 3);
+}
+
+ZTEST_CASE("for-auto-user-iterator", R"""(
+struct Range {
+  var n = 3;
+
+  function begin() {
+    return {
+      i = 0,
+      function is_same(e) { return this.i == e.i; },
+      function get() { return this.i * 10; },
+      function get_key() { return this.i; },
+      function next() {
+        this.i = this.i + 1;
+        return this;
+      }
+    };
+  }
+
+  function end() {
+    return { i = this.n };
+  }
+};
+
+var a = [];
+
+for(var k, v : Range()) {
+  a.push(k);
+  a.push(v);
+}
+
+return a;
+)""") {
+  REQUIRE(value == zs::_a(vm, { 0, 0, 1, 10, 2, 20 }));
+}
+
+ZTEST_CASE("for-auto-user-iterator-legacy", R"""(
+struct Range {
+  var n = 3;
+
+  function begin() {
+    return {
+      i = 0,
+      function is_same(e) { return this.i == e.i; },
+      function get_if_not(e) { return this.i * 10; },
+      function get_key_if_not(e) { return this.i; },
+      function __pre_incr() {
+        this.i = this.i + 1;
+        return this;
+      }
+    };
+  }
+
+  function end() {
+    return { i = this.n };
+  }
+};
+
+var a = [];
+
+for(var k, v : Range()) {
+  a.push(k);
+  a.push(v);
+}
+
+return a;
+)""") {
+  REQUIRE(value == zs::_a(vm, { 0, 0, 1, 10, 2, 20 }));
+}
+
+TEST_CASE("for-auto-invalid-utf8") {
+  zs::vm vm;
+
+  // A lone continuation byte and a truncated sequence.
+  vm->global().as_table()["s"] = zs::_s(vm, "a\x80\xE2" "b");
+
+  zs::object value;
+  REQUIRE(!vm->call_buffer(R"""(
+var a = [];
+
+for(var c : s) {
+  a.push(c);
+}
+
+return a;
+)""",
+      "test", value));
+
+  REQUIRE(value == zs::_a(vm, { 'a', 0x80, 0xE2, 'b' }));
+}
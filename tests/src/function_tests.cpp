@@ -596,3 +596,133 @@ return B(12, 12, 13, 14, [15, 16]);
 )""") {
   REQUIRE(value == zs::_a(vm, { 15, 16 }));
 }
+
+ZTEST_CASE("stackless-call", R"""(
+function sum(n) {
+  if(n == 0) {
+    return 0;
+  }
+
+  return n + sum(n - 1);
+}
+
+function fib(n) {
+  if(n < 2) {
+    return n;
+  }
+
+  return fib(n - 1) + fib(n - 2);
+}
+
+function mul(a, b = 2) {
+  return a * b;
+}
+
+function no_return(a) {
+  var b = a;
+}
+
+var k = 3;
+function add_k(a) {
+  return a + k;
+}
+
+var t = {
+  v = 5,
+  function get(a) { return this.v + a; }
+};
+
+return [sum(100), fib(15), mul(4), no_return(1) == null, add_k(1), t.get(1)];
+)""") {
+  REQUIRE(value == zs::_a(vm, { 5050, 610, 8, true, 4, 6 }));
+}
+
+TEST_CASE("stackless-call-error") {
+  constexpr std::string_view code = R"""(function A(a) {
+  var t = {};
+  return t.fct(a);
+}
+
+function B(a) {
+  return 1 + A(a);
+}
+
+return B(1);
+)""";
+
+  zs::vm vm;
+
+  zs::object closure;
+  REQUIRE(!vm->compile_buffer(code, "test", closure));
+
+  zs::object value;
+  REQUIRE(vm->call(closure, vm->global(), value));
+
+  // One error for each script frame, from the innermost one.
+  const std::string_view err = vm.get_error();
+  REQUIRE(err.find("line: 3:") != std::string_view::npos);
+  REQUIRE(err.find("line: 7:") != std::string_view::npos);
+  REQUIRE(err.find("line: 3:") < err.find("line: 7:"));
+}
+
+TEST_CASE("stackless-call-error-frames") {
+  constexpr std::string_view code = R"""(function C(a) {
+  var f = function() { return a; };
+  var t = {};
+  return t.fct(f);
+}
+
+function B(a) {
+  return 1 + C(a);
+}
+
+function A(a) {
+  return 1 + B(a);
+}
+
+return A(1);
+)""";
+
+  zs::vm vm;
+
+  zs::object closure;
+  REQUIRE(!vm->compile_buffer(code, "test", closure));
+
+  const size_t call_stack_size = vm->get_call_stack().size();
+
+  zs::object value;
+  REQUIRE(vm->call(closure, vm->global(), value));
+
+  // Only the frame of the called closure is left, B and C were popped.
+  REQUIRE(vm->get_call_stack().size() == call_stack_size + 1);
+
+  const std::string_view err = vm.get_error();
+  REQUIRE(err.find("line: 4:") < err.find("line: 8:"));
+  REQUIRE(err.find("line: 8:") < err.find("line: 12:"));
+  REQUIRE(err.find("line: 12:") != std::string_view::npos);
+}
+
+TEST_CASE("stackless-call-deep-recursion") {
+  constexpr std::string_view code = R"""(
+function sum(n) {
+  if(n == 0) {
+    return 0;
+  }
+
+  return n + sum(n - 1);
+}
+
+return sum(100000);
+)""";
+
+  // Far deeper than the native stack allowed when each call nested a run(),
+  // only the vm stack needs room for the frames.
+  zs::vm vm(1024 * 1024);
+
+  zs::object closure;
+  REQUIRE(!vm->compile_buffer(code, "test", closure));
+
+  zs::object value;
+  REQUIRE(!vm->call(closure, vm->global(), value));
+  REQUIRE(value == 5000050000);
+}
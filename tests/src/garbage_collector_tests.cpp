@@ -0,0 +1,223 @@
+#include "unit_tests.h"
+
+using namespace utest;
+
+TEST_CASE("garbage-collector-cycles") {
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+  eng->set_garbage_collector_threshold(0);
+
+  (void)eng->collect_garbage();
+
+  zs::object live_tbl = zs::_t(eng);
+
+  {
+    zs::object t1 = zs::_t(eng);
+    zs::object t2 = zs::_t(eng);
+    zs::object arr = zs::_a(eng, 0);
+
+    t1.as_table()["t2"] = t2;
+    t2.as_table()["t1"] = t1;
+    t2.as_table()["arr"] = arr;
+    arr.as_array().push_back(t1);
+
+    // Referenced by the cycle, but still alive.
+    t1.as_table()["live"] = live_tbl;
+    live_tbl.as_table()["value"] = 12;
+
+    // Not a cycle, nothing to collect while it's referenced.
+    REQUIRE(eng->collect_garbage() == 0);
+  }
+
+  REQUIRE(eng->collect_garbage() == 3);
+  REQUIRE(live_tbl.as_table()["value"] == 12);
+  REQUIRE(eng->collect_garbage() == 0);
+}
+
+TEST_CASE("garbage-collector-step") {
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+  eng->set_garbage_collector_threshold(0);
+  eng->set_garbage_collector_step_budget(1);
+
+  (void)eng->collect_garbage();
+
+  {
+    zs::object t1 = zs::_t(eng);
+    zs::object t2 = zs::_t(eng);
+    t1.as_table()["t2"] = t2;
+    t2.as_table()["t1"] = t1;
+
+    zs::object t3 = zs::_t(eng);
+    t3.as_table()["t3"] = t3;
+  }
+
+  size_t count = 0;
+  for (size_t i = 0; i < 64; i++) {
+    count += eng->collect_garbage_step();
+  }
+
+  REQUIRE(count == 3);
+}
+
+TEST_CASE("garbage-collector-step-budget") {
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+  eng->set_garbage_collector_threshold(0);
+  eng->set_garbage_collector_step_budget(4);
+
+  (void)eng->collect_garbage();
+
+  {
+    zs::object first = zs::_t(eng);
+    zs::object last = first;
+
+    for (size_t i = 1; i < 64; i++) {
+      zs::object t = zs::_t(eng);
+      last.as_table()["next"] = t;
+      last = t;
+    }
+
+    last.as_table()["next"] = first;
+  }
+
+  // A step only traverses a few objects of the ring.
+  size_t count = eng->collect_garbage_step();
+  REQUIRE(count == 0);
+
+  for (size_t i = 0; i < 256 and count == 0; i++) {
+    count = eng->collect_garbage_step();
+  }
+
+  REQUIRE(count == 64);
+}
+
+TEST_CASE("garbage-collector-step-reference-between-steps") {
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+  eng->set_garbage_collector_threshold(0);
+  eng->set_garbage_collector_step_budget(1);
+
+  (void)eng->collect_garbage();
+
+  zs::object weak;
+
+  {
+    zs::object t1 = zs::_t(eng);
+    zs::object t2 = zs::_t(eng);
+    t1.as_table()["t2"] = t2;
+    t2.as_table()["t1"] = t1;
+    weak = t1.get_weak_ref();
+  }
+
+  REQUIRE(eng->collect_garbage_step() == 0);
+
+  // The cycle is referenced again while the collection is in progress.
+  zs::object t1 = weak.get_weak_ref_value();
+  REQUIRE(t1.is_table());
+
+  size_t count = 0;
+  for (size_t i = 0; i < 64; i++) {
+    count += eng->collect_garbage_step();
+  }
+
+  REQUIRE(count == 0);
+  REQUIRE(t1.as_table()["t2"].as_table()["t1"] == t1);
+
+  t1.reset();
+  REQUIRE(eng->collect_garbage() == 2);
+}
+
+TEST_CASE("garbage-collector-delegate-cycle") {
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+  eng->set_garbage_collector_threshold(0);
+
+  (void)eng->collect_garbage();
+
+  {
+    zs::object t1 = zs::_t(eng);
+    zs::object t2 = zs::_t(eng);
+    REQUIRE(!t1.as_table().set_delegate(t2));
+    REQUIRE(!t2.as_table().set_delegate(t1));
+  }
+
+  REQUIRE(eng->collect_garbage() == 2);
+}
+
+namespace {
+struct gc_tracker {
+  static inline int destroyed = 0;
+  ~gc_tracker() { destroyed++; }
+};
+
+void add_gc_tracker_functions(zs::vm& vm) {
+  vm->global()._table->emplace("tracker", [](zs::vm_ref vm) -> zs::int_t {
+    return vm.push(zs::object(zs::user_data_object::create<gc_tracker>(vm.get_engine()), false));
+  });
+
+  vm->global()._table->emplace("destroyed", [](zs::vm_ref vm) -> zs::int_t {
+    return vm.push((zs::int_t)gc_tracker::destroyed);
+  });
+}
+
+/// Runs `code` with the given threshold, returns the number of cycles
+/// collected before the script returned.
+zs::int_t run_gc_cycles_script(size_t threshold, std::string_view code) {
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+  eng->set_garbage_collector_threshold(threshold);
+  add_gc_tracker_functions(vm);
+
+  gc_tracker::destroyed = 0;
+
+  zs::object value;
+  REQUIRE(!vm->call_buffer(code, "test", value));
+
+  // Everything left is collected once the script is done.
+  (void)eng->collect_garbage();
+  REQUIRE(gc_tracker::destroyed == 100);
+  return value._int;
+}
+} // namespace
+
+TEST_CASE("garbage-collector-script-table-closure-cycle") {
+  constexpr std::string_view code = R"""(
+var tracker = this.tracker;
+var destroyed = this.destroyed;
+
+for (var i = 0; i < 100; i++) {
+  var t = { value = tracker() };
+  t.f = function() { return t; };
+}
+
+return destroyed();
+)""";
+
+  // Without the automatic steps, nothing is collected while the script runs.
+  REQUIRE(run_gc_cycles_script(0, code) == 0);
+  REQUIRE(run_gc_cycles_script(8, code) > 0);
+}
+
+TEST_CASE("garbage-collector-script-capture-cycle") {
+  constexpr std::string_view code = R"""(
+var tracker = this.tracker;
+var destroyed = this.destroyed;
+
+function make_cycle() {
+  var value = tracker();
+  var a = null;
+  var b = function() { return [a, value]; };
+  a = function() { return b; };
+}
+
+for (var i = 0; i < 100; i++) {
+  make_cycle();
+}
+
+return destroyed();
+)""";
+
+  REQUIRE(run_gc_cycles_script(0, code) == 0);
+  REQUIRE(run_gc_cycles_script(8, code) > 0);
+}
@@ -2,6 +2,12 @@
 
 using namespace utest;
 #include <zscript/base/sys/path.h>
+#include <zscript/base/sys/zip.h>
+#include "utility/zbytecode_cache.h"
+#include "bytecode/zmapped_module.h"
+#include "object/zfunction_prototype.h"
+#include "utility/zvm_module.h"
+#include <fstream>
 
 ZTEST_CASE("import", R"""(
 const math = import("math");
@@ -45,6 +51,226 @@ return m1;
 ZTEST_CASE("import", ZSCRIPT_TESTS_RESOURCES_DIRECTORY "/tests/test_01.zs") { /*zb::print(get_test_name());*/
 }
 
+TEST_CASE("bytecode-cache") {
+  namespace fs = std::filesystem;
+  const fs::path cache_dir = ZSCRIPT_TESTS_OUTPUT_DIRECTORY "/bytecode_cache";
+  const std::string module_path = ZSCRIPT_TESTS_OUTPUT_DIRECTORY "/cached_module.zs";
+
+  std::error_code ec;
+  fs::remove_all(cache_dir, ec);
+
+  const auto write_module = [&](std::string_view code) {
+    std::ofstream file(module_path, std::ios::binary);
+    file << code;
+  };
+
+  const auto import_value = [&](zs::int_t& result) {
+    zs::vm vm;
+    REQUIRE(!vm.get_engine()->set_bytecode_cache_directory(cache_dir));
+
+    zs::object closure;
+    REQUIRE(!zs::compile_or_load_file(vm, std::string_view(module_path), closure));
+
+    zs::object value;
+    REQUIRE(!vm->call(closure, vm->global(), value));
+    result = value.as_table()["a"]._int;
+  };
+
+  const auto entry_count = [&]() {
+    return std::distance(fs::directory_iterator(cache_dir), fs::directory_iterator());
+  };
+
+  zs::int_t result = 0;
+  write_module("return { a = 12 };");
+  import_value(result);
+  REQUIRE(result == 12);
+  REQUIRE(entry_count() == 1);
+
+  // Replace the entry by another compiled code for the same source, the next
+  // load can only get it from the cache.
+  {
+    zs::vm vm;
+    REQUIRE(!vm.get_engine()->set_bytecode_cache_directory(cache_dir));
+
+    zs::object closure;
+    REQUIRE(!vm->compile_buffer("return { a = 34 };", "other", closure));
+
+    zs::file_loader loader(vm.get_engine());
+    REQUIRE(!loader.open(module_path));
+    REQUIRE(!zs::store_cached_bytecode(vm.get_engine(), module_path, loader.data(), closure));
+  }
+
+  import_value(result);
+  REQUIRE(result == 34);
+
+  // A modified source doesn't match the entry anymore, it gets replaced.
+  write_module("return { a = 56 };");
+  import_value(result);
+  REQUIRE(result == 56);
+  REQUIRE(entry_count() == 1);
+
+  import_value(result);
+  REQUIRE(result == 56);
+}
+
+TEST_CASE("bytecode-cache-variadic") {
+  namespace fs = std::filesystem;
+  const fs::path cache_dir = ZSCRIPT_TESTS_OUTPUT_DIRECTORY "/bytecode_cache_variadic";
+  const std::string module_path = ZSCRIPT_TESTS_OUTPUT_DIRECTORY "/cached_variadic_module.zs";
+
+  std::error_code ec;
+  fs::remove_all(cache_dir, ec);
+
+  {
+    std::ofstream file(module_path, std::ios::binary);
+    file << R"""(
+var add = function(a, values = ...) {
+  var sum = a;
+  for(int i = 0; i < values.size(); i++) {
+    sum += values[i];
+  }
+  return sum;
+}
+
+return { a = add(1, 2, 3, 4) };
+)""";
+  }
+
+  // The first import compiles and stores the entry, the second one loads it.
+  for (int i = 0; i < 2; i++) {
+    zs::vm vm;
+    REQUIRE(!vm.get_engine()->set_bytecode_cache_directory(cache_dir));
+
+    zs::object closure;
+    REQUIRE(!zs::compile_or_load_file(vm, std::string_view(module_path), closure));
+
+    zs::object value;
+    REQUIRE(!vm->call(closure, vm->global(), value));
+    REQUIRE(value.as_table()["a"] == 10);
+    REQUIRE(std::distance(fs::directory_iterator(cache_dir), fs::directory_iterator()) == 1);
+  }
+}
+
+TEST_CASE("mapped-module") {
+  const std::string module_path = ZSCRIPT_TESTS_OUTPUT_DIRECTORY "/mapped_module.zsm";
+
+  zb::byte_vector data;
+  {
+    zs::vm vm;
+    zs::object closure;
+    REQUIRE(!vm->compile_buffer(R"""(
+var prefix = "value ";
+
+function sum(n, step = 1) {
+  var r = 0;
+  for(var i = 0; i < n; i += step) {
+    r += i;
+  }
+  return r;
+}
+
+return { a = sum(10), b = prefix + sum(10, 2), f = function(x) { return prefix + x; } };
+)""",
+        "mapped", closure));
+
+    REQUIRE(!zs::save_mapped_module(closure.as_closure()._function, data));
+    REQUIRE(zs::is_mapped_module_data(data));
+
+    std::ofstream file(module_path, std::ios::binary);
+    file.write((const char*)data.data(), data.size());
+  }
+
+  zs::vm vm;
+  zs::object closure;
+  REQUIRE(!zs::compile_or_load_file(vm, std::string_view(module_path), closure));
+
+  // The instructions are used in place and the literals are not created yet.
+  const zs::function_prototype_object& fpo = closure.as_closure().get_proto();
+  REQUIRE(fpo._instructions.has_external_data());
+  REQUIRE(fpo._literals.size() > 0);
+  REQUIRE(fpo._literals[0].is_null());
+  REQUIRE(fpo._functions.size() == 2);
+
+  // The second call goes through the instructions quickened by the first one.
+  for (int i = 0; i < 2; i++) {
+    zs::object value;
+    REQUIRE(!vm->call(closure, vm->global(), value));
+    REQUIRE(value.as_table()["a"] == 45);
+    REQUIRE(value.as_table()["b"] == zs::_ss("value 20"));
+
+    zs::object f_value;
+    REQUIRE(!vm->call(value.as_table()["f"], { vm->global(), zs::_ss("f") }, f_value));
+    REQUIRE(f_value == zs::_ss("value f"));
+  }
+
+  // The quickened pages are private, the file is unchanged.
+  {
+    zs::file_loader loader(vm.get_engine());
+    REQUIRE(!loader.open(module_path));
+    REQUIRE(loader.data() == zb::byte_view(data.data(), data.size()));
+  }
+
+  // A mapped prototype can still be serialized.
+  zb::byte_vector compiled;
+  REQUIRE(!closure.as_closure().get_proto().save(compiled));
+  REQUIRE(zs::function_prototype_object::is_compiled_data(compiled));
+
+  // A truncated module is rejected.
+  {
+    std::ofstream file(module_path, std::ios::binary);
+    file.write((const char*)data.data(), data.size() / 2);
+  }
+
+  zs::object other;
+  REQUIRE(zs::compile_or_load_file(vm, std::string_view(module_path), other));
+}
+
+TEST_CASE("import-archive") {
+  const std::string archive_path = ZSCRIPT_TESTS_OUTPUT_DIRECTORY "/import_archive.zip";
+
+  {
+    zs::vm vm;
+    zs::object closure;
+    REQUIRE(!vm->compile_buffer("return { c = 3 };", "compiled", closure));
+
+    zb::byte_vector compiled;
+    REQUIRE(!closure.as_closure().get_proto().save(compiled));
+
+    zb::zip_file archive;
+    archive.writestr("lib/util.zs", "return { a = 1, b = \"util\" };");
+    archive.writestr("pkg/main.zs", "var u = import(\"lib.util\"); return { a = u.a + 1 };");
+    archive.writestr("compiled.zsc", std::string((const char*)compiled.data(), compiled.size()));
+    archive.save(archive_path);
+  }
+
+  zs::vm vm;
+  REQUIRE(!vm.get_engine()->add_import_archive(archive_path.c_str()));
+  REQUIRE(vm.get_engine()->get_import_archives().as_array().size() == 1);
+
+  // Adding the same archive twice is a no-op.
+  REQUIRE(!vm.get_engine()->add_import_archive(archive_path.c_str()));
+  REQUIRE(vm.get_engine()->get_import_archives().as_array().size() == 1);
+
+  zs::object main_module;
+  REQUIRE(!zs::import_module(vm, zs::_ss("pkg/main"), main_module));
+  REQUIRE(main_module.as_table()["a"] == 2);
+
+  // Imported once, the nested import is already in the modules.
+  zs::object util_module;
+  REQUIRE(!zs::import_module(vm, zs::_ss("lib/util.zs"), util_module));
+  REQUIRE(util_module.as_table()["b"] == zs::_ss("util"));
+  REQUIRE(vm->get_imported_modules().size() == 2);
+
+  zs::object compiled_module;
+  REQUIRE(!zs::import_module(vm, zs::_ss("compiled"), compiled_module));
+  REQUIRE(compiled_module.as_table()["c"] == 3);
+
+  zs::object missing;
+  REQUIRE(zs::import_module(vm, zs::_ss("missing"), missing));
+
+  REQUIRE(vm.get_engine()->add_import_archive(ZSCRIPT_TESTS_OUTPUT_DIRECTORY "/missing_archive.zip"));
+}
+
 // TEST_CASE("proto-serialize") {
 //   const char* filepath = ZSCRIPT_TESTS_RESOURCES_DIRECTORY "/module_01.zs";
 //   zs::vm vm;
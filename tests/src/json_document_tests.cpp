@@ -0,0 +1,146 @@
+#include "unit_tests.h"
+#include "utility/json/zjson_document.h"
+#include "utility/zvm_load.h"
+
+using namespace utest;
+
+TEST_CASE("json-document") {
+  zs::vm vm;
+  zs::engine* eng = vm.get_engine();
+
+  const std::string_view content = R"""({
+  "name": "json",
+  "escaped \"key\"": "a\tb\\\\\"c\u00e9\ud83d\ude00",
+  "values": [1, -2, 2.5, 1e3, true, false, null, [], {}],
+  "nested": { "a": { "b": [ { "c": 1 } ] } },
+  "big": 92233720368547758070
+})""";
+
+  zs::json_document doc(eng);
+  REQUIRE(!doc.parse(content));
+
+  const zs::int_t values = doc.find(0, "values");
+  REQUIRE(values != -1);
+  REQUIRE(doc.get_entry(values).size == 9);
+  REQUIRE(doc.get_entry(doc.at(values, 6)).type == zs::json_document::value_type::null);
+  REQUIRE(doc.at(values, 9) == -1);
+  REQUIRE(doc.find(0, "escaped \"key\"") != -1);
+  REQUIRE(doc.find(0, "missing") == -1);
+
+  zs::object value;
+  REQUIRE(!doc.to_object(0, value));
+
+  zs::table_object& tbl = value.as_table();
+  REQUIRE(tbl["name"] == zs::_ss("json"));
+  REQUIRE(tbl["escaped \"key\""] == zs::_s(eng, "a\tb\\\\\"c\xC3\xA9\xF0\x9F\x98\x80"));
+  REQUIRE(tbl["big"].is_float());
+
+  const zs::array_object& arr = tbl["values"].as_array();
+  REQUIRE(arr.size() == 9);
+  REQUIRE(arr[0] == 1);
+  REQUIRE(arr[1] == -2);
+  REQUIRE(arr[2] == 2.5);
+  REQUIRE(arr[3] == 1000.0);
+  REQUIRE(arr[4] == true);
+  REQUIRE(arr[5] == false);
+  REQUIRE(arr[6].is_null());
+  REQUIRE(arr[7].is_array());
+  REQUIRE(arr[8].is_table());
+
+  REQUIRE(tbl["nested"].as_table()["a"].as_table()["b"].as_array()[0].as_table()["c"] == 1);
+}
+
+TEST_CASE("json-document::blocks") {
+  zs::vm vm;
+
+  // Strings and backslash runs across the 64 bytes blocks.
+  std::string content = "[";
+  for (int i = 0; i < 100; i++) {
+    content += "\"";
+    content.append(i % 67, 'x');
+    content.append(i % 5, '\\');
+    content.append((i % 5) & 1, '"');
+    content += "\", ";
+    content += std::to_string(i);
+    content += i == 99 ? "]" : ", ";
+  }
+
+  zs::json_document doc(vm.get_engine());
+  REQUIRE(!doc.parse(content));
+  REQUIRE(doc.get_entry(0).size == 200);
+
+  zs::object value;
+  REQUIRE(!doc.to_object(0, value));
+
+  const zs::array_object& arr = value.as_array();
+  for (int i = 0; i < 100; i++) {
+    REQUIRE(arr[i * 2].get_string_unchecked().size() == (size_t)(i % 67 + (i % 5) / 2 + ((i % 5) & 1)));
+    REQUIRE(arr[i * 2 + 1] == i);
+  }
+}
+
+TEST_CASE("json-document::invalid") {
+  zs::vm vm;
+
+  for (std::string_view content : { "", "{", "[1, 2", "{\"a\" 1}", "{\"a\": 1,}", "[1 2]", "\"abc", "tru",
+           "nulls", "[01a]", "-", "1.", "1e", "[1] 2", "{a: 1}", "[\"\\x\"]" }) {
+    zs::json_document doc(vm.get_engine());
+    zs::object value;
+    REQUIRE((doc.parse(content) or doc.to_object(0, value)));
+  }
+}
+
+TEST_CASE("json-document::script") {
+  zs::vm vm;
+
+  zs::object value;
+  REQUIRE(!vm->call_buffer(R"""(
+var doc = zs.json_document("{ \"a\": { \"b\": [10, 20, { \"c\": \"d\" }] }, \"size\": 3, \"n\": null }");
+
+return [
+  typeof(doc),
+  doc.a.b[1],
+  doc.a.b[-1].c,
+  doc.a.b.size(),
+  doc.get("size"),
+  doc.get("n"),
+  doc.get("missing"),
+  doc.a.to_object().b[0],
+  zs.json_document("12")
+];
+)""",
+      "test", value));
+
+  const zs::array_object& arr = value.as_array();
+  REQUIRE(arr[0] == zs::_ss("json_value"));
+  REQUIRE(arr[1] == 20);
+  REQUIRE(arr[2] == zs::_ss("d"));
+  REQUIRE(arr[3] == 3);
+  REQUIRE(arr[4] == 3);
+  REQUIRE(arr[5].is_null());
+  REQUIRE(arr[6].is_none());
+  REQUIRE(arr[7] == 10);
+  REQUIRE(arr[8] == 12);
+
+  REQUIRE(vm->call_buffer("return zs.json_document(\"[1, \");", "test", value));
+}
+
+TEST_CASE("load_json_table") {
+  zs::vm vm;
+
+  zs::object value;
+  REQUIRE(!zs::load_json_table(vm, R"""({ "a": [1, 2], "b": { "c": "d" } })""", nullptr, value));
+  REQUIRE(value.as_table()["a"].as_array()[1] == 2);
+  REQUIRE(value.as_table()["b"].as_table()["c"] == zs::_ss("d"));
+
+  // Identifiers are resolved from the table by the json parser.
+  zs::object table = zs::_t(vm);
+  table.as_table()["e"] = 5;
+  REQUIRE(!zs::load_json_table(vm, R"""({ "a": e })""", table, value));
+  REQUIRE(value.as_table()["a"] == 5);
+
+  // The output is left untouched on error.
+  value = 12;
+  REQUIRE(zs::load_json_table(vm, R"""({ "a": [1, 2 })""", nullptr, value));
+  REQUIRE(value == 12);
+}
@@ -0,0 +1,62 @@
+#include "unit_tests.h"
+
+using namespace utest;
+
+TEST_CASE("line-table") {
+  constexpr std::string_view code = R"""(var a = 1;
+var b = 2;
+
+var t = {};
+for(var i = 0; i < 3; i++) {
+  b += i;
+}
+
+var c = a + b;
+var d = t.fct(c);
+return d;
+)""";
+
+  zs::vm vm;
+
+  zs::object proto;
+  {
+    zs::jit_compiler compiler(vm.get_engine());
+    REQUIRE(!compiler.compile(code, "test", proto));
+  }
+
+  const zs::function_prototype_object& fpo = zs::function_prototype_object::as_proto(proto);
+
+  // The lines are only kept in the side table.
+  for (auto it = fpo._instructions.begin(); it != fpo._instructions.end(); ++it) {
+    REQUIRE(it.get_opcode() != zs::opcode::op_line);
+  }
+
+  REQUIRE(!fpo._line_info.empty());
+  REQUIRE(fpo._line_info.find(0)->line == 1);
+
+  // Run length encoded, sorted by instruction offset.
+  for (size_t i = 1; i < fpo._line_info.size(); i++) {
+    REQUIRE(fpo._line_info._entries[i - 1].op_index < fpo._line_info._entries[i].op_index);
+    REQUIRE(fpo._line_info._entries[i - 1].line != fpo._line_info._entries[i].line);
+  }
+
+  zs::object value;
+  REQUIRE(vm->call(zs::_c(vm.get_engine(), proto, vm->global()), vm->global(), value));
+  REQUIRE(vm.get_error().find("line: 10:") != std::string_view::npos);
+
+  SECTION("save-load") {
+    zb::byte_vector buffer;
+    REQUIRE(!zs::function_prototype_object::as_proto(proto).save(buffer));
+
+    zs::object loaded_proto = zs::function_prototype_object::create(vm.get_engine());
+    zs::function_prototype_object& loaded_fpo = zs::function_prototype_object::as_proto(loaded_proto);
+    REQUIRE(!loaded_fpo.load(buffer));
+
+    REQUIRE(loaded_fpo._line_info.size() == fpo._line_info.size());
+
+    for (size_t i = 0; i < fpo._line_info.size(); i++) {
+      REQUIRE(loaded_fpo._line_info._entries[i].op_index == fpo._line_info._entries[i].op_index);
+      REQUIRE(loaded_fpo._line_info._entries[i].line == fpo._line_info._entries[i].line);
+    }
+  }
+}
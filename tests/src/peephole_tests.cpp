@@ -0,0 +1,94 @@
+#include "unit_tests.h"
+
+using namespace utest;
+
+namespace {
+bool has_opcode(const zs::object& proto, zs::opcode op) {
+  const zs::instruction_vector& insts = zs::function_prototype_object::as_proto(proto)._instructions;
+
+  for (auto it = insts.begin(); it != insts.end(); ++it) {
+    if (it.get_opcode() == op) {
+      return true;
+    }
+  }
+
+  return false;
+}
+} // namespace.
+
+TEST_CASE("peephole-optimizer") {
+  constexpr std::string_view code = R"""(
+var t = {
+  a = 2,
+  fct = function(x) { return this.a * x; }
+};
+
+var sum = 0;
+
+for(var i = 0; i < 10; i++) {
+  sum += i + 3;
+  sum += t.fct(i);
+}
+
+if(sum > 100) {
+  sum = sum - 1;
+}
+
+return sum;
+)""";
+
+  zs::vm vm;
+
+  zs::object proto;
+  {
+    zs::jit_compiler compiler(vm.get_engine());
+    REQUIRE(!compiler.compile(code, "test", proto));
+  }
+
+  zs::object unoptimized_proto;
+  {
+    zs::jit_compiler compiler(vm.get_engine());
+    REQUIRE(!compiler.compile(
+        code, "test", unoptimized_proto, nullptr, nullptr, false, true, zs::optimization_level::ol_none));
+  }
+
+  REQUIRE(has_opcode(proto, zs::opcode::op_cmp_int_jz));
+  REQUIRE(has_opcode(proto, zs::opcode::op_arith_int));
+  REQUIRE(has_opcode(proto, zs::opcode::op_get_method));
+  REQUIRE(!has_opcode(unoptimized_proto, zs::opcode::op_cmp_int_jz));
+
+  // Same size, the jumps and line infos are still valid.
+  REQUIRE(zs::function_prototype_object::as_proto(proto)._instructions._data.size()
+      == zs::function_prototype_object::as_proto(unoptimized_proto)._instructions._data.size());
+
+  zs::object value;
+  REQUIRE(!vm->call(zs::_c(vm.get_engine(), proto, vm->global()), vm->global(), value));
+
+  zs::object unoptimized_value;
+  REQUIRE(!vm->call(
+      zs::_c(vm.get_engine(), unoptimized_proto, vm->global()), vm->global(), unoptimized_value));
+
+  REQUIRE(value == 164);
+  REQUIRE(value == unoptimized_value);
+}
+
+ZTEST_CASE("peephole-cmp-jz", R"""(
+var a = [];
+var b = 5;
+
+for(var i = 0; i < 8; i++) {
+  if(i == b) {
+    continue;
+  }
+
+  if(i >= 6) {
+    break;
+  }
+
+  a.push(i * 2);
+}
+
+return a;
+)""") {
+  REQUIRE(value == zs::_a(vm, { 0, 2, 4, 6, 8 }));
+}
@@ -0,0 +1,141 @@
+#include "unit_tests.h"
+#include <zscript/utility/pool_allocator.h>
+
+using namespace utest;
+
+TEST_CASE("pool_allocator") {
+  zs::pool_allocator pool;
+
+  void* p1 = pool.allocate(10, (zs::alloc_info_t)zs::memory_tag::nt_table);
+  void* p2 = pool.allocate(16, (zs::alloc_info_t)zs::memory_tag::nt_table);
+  void* p3 = pool.allocate(1000, (zs::alloc_info_t)zs::memory_tag::nt_string);
+
+  REQUIRE(p1);
+  REQUIRE(p2);
+  REQUIRE(p3);
+  REQUIRE(((uintptr_t)p1 % 16) == 0);
+  REQUIRE(((uintptr_t)p3 % 16) == 0);
+
+  const zs::pool_allocator::stats& stats = pool.get_stats();
+  REQUIRE(stats[zs::memory_tag::nt_table].allocations == 2);
+  REQUIRE(stats[zs::memory_tag::nt_string].allocations == 1);
+  REQUIRE(stats.slab_count == 1);
+  REQUIRE(stats.large_allocation_count == 1);
+  REQUIRE(stats.live_bytes == 16 + 16 + 1000);
+
+  // Same size class.
+  REQUIRE(pool.reallocate(p1, 12, 0) == p1);
+
+  // A freed block is reused.
+  pool.deallocate(p2, (zs::alloc_info_t)zs::memory_tag::nt_table);
+  REQUIRE(pool.allocate(8, 0) == p2);
+
+  std::memset(p1, 7, 16);
+  void* p4 = pool.reallocate(p1, 2000, 0);
+  REQUIRE(((uint8_t*)p4)[15] == 7);
+  REQUIRE(stats.large_allocation_count == 2);
+
+  p4 = pool.reallocate(p4, 64, 0);
+  REQUIRE(((uint8_t*)p4)[15] == 7);
+  REQUIRE(stats.large_allocation_count == 1);
+  REQUIRE(stats.slab_count == 2);
+
+  // The rest is released with the pool.
+  pool.deallocate(p3, 0);
+  REQUIRE(stats.large_allocation_count == 0);
+  REQUIRE(stats.live_bytes == 16 + 64);
+  REQUIRE(stats.peak_live_bytes >= 16 + 2000 + 1000);
+}
+
+TEST_CASE("pool_allocator_vm") {
+  zs::vm vm(zs::pool_allocator::create_config());
+
+  zs::pool_allocator* pool = zs::pool_allocator::get(vm.get_engine());
+  REQUIRE(pool);
+
+  zs::object closure;
+  REQUIRE(!vm->compile_buffer(R"""(
+var t = { a = 1, b = [1, 2, 3], c = "a string longer than a small string" };
+var r = [];
+
+for(var i = 0; i < 100; i++) {
+  r.push({ i = i, s = "value_" + i });
+}
+
+return r[99].i + t.b[2];
+)""", "pool_allocator_vm", closure));
+
+  zs::object value;
+  REQUIRE(!vm->call(closure, vm->global(), value));
+  REQUIRE(value == 102);
+
+  const zs::pool_allocator::stats& stats = pool->get_stats();
+  REQUIRE(stats[zs::memory_tag::nt_engine].allocations == 1);
+  REQUIRE(stats[zs::memory_tag::nt_table].allocations >= 100);
+  REQUIRE(stats.slab_count > 0);
+}
+
+TEST_CASE("pool_allocator_vm_teardown") {
+  static size_t live_bytes_at_release = (size_t)-1;
+
+  zs::config_t config = zs::pool_allocator::create_config();
+
+  // Called once the engine block was deallocated.
+  config.user_release = [](zs::allocate_t alloc_cb, zs::raw_pointer_t user_ptr) {
+    live_bytes_at_release = ((zs::pool_allocator*)user_ptr)->get_stats().live_bytes;
+    zs::pool_allocator::release(alloc_cb, user_ptr);
+  };
+
+  {
+    zs::vm vm(config);
+
+    zs::object value;
+    REQUIRE(!vm->call_buffer(R"""(
+var s = "a string longer than a small string";
+var t = { a = [1, 2, 3], s = s + "_" + s };
+
+function make_counter() {
+  var count = 0;
+  return function() {
+    count += 1;
+    return count;
+  };
+}
+
+t.counter = make_counter();
+t.counter();
+t.f = function() { return t.s; };
+
+this.kept = t;
+return t;
+)""", "pool_allocator_vm_teardown", value));
+
+    REQUIRE(value.is_table());
+  }
+
+  REQUIRE(live_bytes_at_release == 0);
+}
+
+TEST_CASE("pool_allocator_engine_teardown") {
+  static size_t live_bytes_at_release = (size_t)-1;
+
+  zs::config_t config = zs::pool_allocator::create_config();
+
+  // Called once all the engine members were destroyed.
+  config.user_release = [](zs::allocate_t alloc_cb, zs::raw_pointer_t user_ptr) {
+    live_bytes_at_release = ((zs::pool_allocator*)user_ptr)->get_stats().live_bytes;
+    zs::pool_allocator::release(alloc_cb, user_ptr);
+  };
+
+  {
+    zs::engine eng(config);
+
+    zs::object t1 = zs::_t(&eng);
+    zs::object t2 = zs::_t(&eng);
+    t1.as_table()["t2"] = t2;
+    t2.as_table()["t1"] = t1;
+    t1.as_table()["s"] = zs::_s(&eng, "a string longer than a small string");
+  }
+
+  REQUIRE(live_bytes_at_release == 0);
+}
@@ -0,0 +1,69 @@
+#include "unit_tests.h"
+
+using namespace utest;
+
+TEST_CASE("sampling-profiler") {
+  constexpr std::string_view code = R"""(
+function hot(n) {
+  var sum = 0;
+  for(var i = 0; i < n; i++) {
+    sum += i % 7;
+  }
+  return sum;
+}
+
+function cold(n) {
+  return hot(n / 10);
+}
+
+var total = 0;
+for(var i = 0; i < 20; i++) {
+  total += hot(2000) + cold(2000);
+}
+
+return total;
+)""";
+
+  zs::vm vm;
+
+  zs::object proto;
+  {
+    zs::jit_compiler compiler(vm.get_engine());
+    REQUIRE(!compiler.compile(code, "test", proto));
+  }
+
+  // A sample at every safe point.
+  const zs::error_result err = vm->start_profiler({ std::chrono::microseconds(0), 64, 8 });
+
+  // The safe points are only compiled in with ZS_SCRIPT_PROFILER.
+  if constexpr (!ZS_SCRIPT_PROFILER) {
+    REQUIRE(err == zs::errc::unimplemented);
+    return;
+  }
+
+  REQUIRE(!err);
+
+  zs::object value;
+  REQUIRE(!vm->call(zs::_c(vm.get_engine(), proto, vm->global()), vm->global(), value));
+  vm->stop_profiler();
+
+  const zs::sampling_profiler& profiler = vm->get_profiler();
+  REQUIRE(!profiler.is_running());
+  REQUIRE(profiler.size() == 64);
+  REQUIRE(profiler.get_dropped_count() > 0);
+
+  // The caller lines are known for the calls made by the script.
+  const zs::string stacks = profiler.get_collapsed_stacks();
+  REQUIRE(stacks.find(";hot (test:") != zs::string::npos);
+  REQUIRE(stacks.find(":16);hot (test:") != zs::string::npos);
+
+  const zs::vector<zs::sampling_profiler::function_stats> stats = profiler.get_function_stats();
+  REQUIRE(!stats.empty());
+
+  // Sorted by self time, `hot` is the one running the loop.
+  REQUIRE(stats[0].name == zs::_ss("hot"));
+  REQUIRE(stats[0].self_samples > 0);
+  REQUIRE(stats[0].total_samples >= stats[0].self_samples);
+
+  REQUIRE(profiler.get_function_table().find("hot (test)") != zs::string::npos);
+}
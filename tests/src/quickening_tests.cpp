@@ -0,0 +1,122 @@
+#include "unit_tests.h"
+
+using namespace utest;
+
+namespace {
+bool has_opcode(const zs::object& proto, zs::opcode op) {
+  const zs::instruction_vector& insts = zs::function_prototype_object::as_proto(proto)._instructions;
+
+  for (auto it = insts.begin(); it != insts.end(); ++it) {
+    if (it.get_opcode() == op) {
+      return true;
+    }
+  }
+
+  return false;
+}
+} // namespace.
+
+TEST_CASE("quickening") {
+  constexpr std::string_view code = R"""(
+var a = 2;
+var b = 3;
+var x = 1.5;
+var y = 0.5;
+
+return [a * b, a < b, x / y, x >= y];
+)""";
+
+  zs::vm vm;
+
+  zs::object proto;
+  {
+    zs::jit_compiler compiler(vm.get_engine());
+    REQUIRE(!compiler.compile(code, "test", proto));
+  }
+
+  REQUIRE(!has_opcode(proto, zs::opcode::op_mul_ii));
+
+  zs::object value;
+  REQUIRE(!vm->call(zs::_c(vm.get_engine(), proto, vm->global()), vm->global(), value));
+  REQUIRE(value == zs::_a(vm, { 6, true, 3.0, true }));
+
+  REQUIRE(has_opcode(proto, zs::opcode::op_mul_ii));
+  REQUIRE(has_opcode(proto, zs::opcode::op_lt_ii));
+  REQUIRE(has_opcode(proto, zs::opcode::op_div_ff));
+  REQUIRE(has_opcode(proto, zs::opcode::op_ge_ff));
+
+  // Same result once quickened.
+  REQUIRE(!vm->call(zs::_c(vm.get_engine(), proto, vm->global()), vm->global(), value));
+  REQUIRE(value == zs::_a(vm, { 6, true, 3.0, true }));
+}
+
+ZTEST_CASE("quickening-type-miss", R"""(
+function add(a, b) {
+  return a + b;
+}
+
+function lt(a, b) {
+  return a < b;
+}
+
+return [
+  add(1, 2), add(1.5, 2.0), add(1, 2.5), add("a", "b"), add(3, 4),
+  lt(1, 2), lt(2.5, 1.5), lt(1, 2.5), lt(3, 4)
+];
+)""") {
+  REQUIRE(value == zs::_a(vm, { 3, 3.5, 3.5, zs::_ss("ab"), 7, true, false, true, true }));
+}
+
+TEST_CASE("quickening-superinstructions") {
+  constexpr std::string_view code = R"""(
+var sum = 0;
+
+for(var i = 0; i < 10; i++) {
+  sum += i * 2;
+}
+
+return sum;
+)""";
+
+  zs::vm vm;
+
+  zs::object proto;
+  {
+    zs::jit_compiler compiler(vm.get_engine());
+    REQUIRE(!compiler.compile(code, "test", proto));
+  }
+
+  REQUIRE(has_opcode(proto, zs::opcode::op_cmp_int_jz));
+  REQUIRE(has_opcode(proto, zs::opcode::op_arith_int));
+
+  zs::object value;
+  REQUIRE(!vm->call(zs::_c(vm.get_engine(), proto, vm->global()), vm->global(), value));
+  REQUIRE(value == 90);
+
+  REQUIRE(has_opcode(proto, zs::opcode::op_lt_int_jz_ii));
+  REQUIRE(has_opcode(proto, zs::opcode::op_mul_int_ii));
+  REQUIRE(!has_opcode(proto, zs::opcode::op_cmp_int_jz));
+
+  // Same result once quickened.
+  REQUIRE(!vm->call(zs::_c(vm.get_engine(), proto, vm->global()), vm->global(), value));
+  REQUIRE(value == 90);
+}
+
+ZTEST_CASE("quickening-superinstructions-type-miss", R"""(
+function add_one(a) {
+  return a + 1;
+}
+
+function count(a) {
+  var n = 0;
+  while(a < 3) {
+    a += 1;
+    n += 1;
+  }
+  return n;
+}
+
+return [add_one(1), add_one(1.5), add_one(2), count(0), count(0.5), count(1)];
+)""") {
+  REQUIRE(value == zs::_a(vm, { 2, 2.5, 3, 3, 3, 2 }));
+}
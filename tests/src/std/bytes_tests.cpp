@@ -0,0 +1,94 @@
+#include "unit_tests.h"
+#include <fstream>
+
+using namespace utest;
+
+TEST_CASE("bytes") {
+  const std::string filepath = ZSCRIPT_TESTS_OUTPUT_DIRECTORY "/bytes_map.bin";
+
+  {
+    // u16 0x0102, u32 0x01020304 (little endian), f32 1.5, "zscript".
+    const uint8_t data[]
+        = { 0x02, 0x01, 0x04, 0x03, 0x02, 0x01, 0x00, 0x00, 0xC0, 0x3F, 'z', 's', 'c', 'r', 'i', 'p', 't' };
+    std::ofstream file(filepath, std::ios::binary);
+    file.write((const char*)data, sizeof(data));
+  }
+
+  zs::vm vm;
+  vm->global().as_table()["file_path"] = zs::_s(vm, filepath);
+
+  zs::object value;
+  REQUIRE(!vm->call_buffer(R"""(
+var b = fs.map_file(file_path);
+var s = b.slice(10);
+
+var a = bytes([1, 2, 255]);
+
+return [
+  b.size(),
+  b.u16(0),
+  b.u16(0, true),
+  b.u32(2),
+  b.f32(6),
+  s.to_string(),
+  s.to_string(1, -1),
+  b.find("rip"),
+  b.find(s.slice(2, 4)),
+  b.find(0x01, 2),
+  b.find("nope"),
+  s[-1],
+  a.i8(2),
+  a.u8(2),
+  typeof(a),
+  b.is_mapped(),
+  a.is_mapped(),
+  bytes("abc").size()
+];
+)""",
+      "test", value));
+
+  const zs::array_object& arr = value.as_array();
+  REQUIRE(arr[0] == 17);
+  REQUIRE(arr[1] == 0x0102);
+  REQUIRE(arr[2] == 0x0201);
+  REQUIRE(arr[3] == 0x01020304);
+  REQUIRE(arr[4] == 1.5);
+  REQUIRE(arr[5] == zs::_ss("zscript"));
+  REQUIRE(arr[6] == zs::_ss("scrip"));
+  REQUIRE(arr[7] == 13);
+  REQUIRE(arr[8] == 12);
+  REQUIRE(arr[9] == 5);
+  REQUIRE(arr[10] == -1);
+  REQUIRE(arr[11] == (zs::int_t)'t');
+  REQUIRE(arr[12] == -1);
+  REQUIRE(arr[13] == 255);
+  REQUIRE(arr[14] == zs::_ss("bytes"));
+  REQUIRE(arr[15] == true);
+  REQUIRE(arr[16] == false);
+  REQUIRE(arr[17] == 3);
+}
+
+TEST_CASE("bytes::out_of_bounds") {
+  zs::vm vm;
+  zs::object value;
+  REQUIRE(vm->call_buffer("return bytes(3).u32(0);", "test", value));
+  REQUIRE(vm->call_buffer("return bytes(0x7FFFFFFFFFFFFFFF);", "test", value));
+}
+
+TEST_CASE("bytes::u64") {
+  zs::vm vm;
+  zs::object value;
+  REQUIRE(!vm->call_buffer(R"""(
+var a = bytes([255, 255, 255, 255, 255, 255, 255, 127, 0, 0, 0, 0, 0, 0, 0, 128]);
+return [a.u64(0), a.u64(8), a.i64(8)];
+)""",
+      "test", value));
+
+  const zs::array_object& arr = value.as_array();
+  REQUIRE(arr[0] == INT64_MAX);
+
+  // Above INT64_MAX, the bit pattern as a two's complement integer.
+  REQUIRE(arr[1].is_integer());
+  REQUIRE(arr[1] == INT64_MIN);
+  REQUIRE(arr[2] == INT64_MIN);
+}
@@ -0,0 +1,58 @@
+#include "unit_tests.h"
+#include <fstream>
+
+using namespace utest;
+
+TEST_CASE("fs::file::read") {
+  const std::string filepath = ZSCRIPT_TESTS_OUTPUT_DIRECTORY "/file_read.txt";
+
+  std::string content;
+  {
+    // Lines longer than the read buffer and a last line without line ending.
+    std::ofstream file(filepath, std::ios::binary);
+    for (int i = 0; i < 3; i++) {
+      file << "line " << i << "\r\n";
+    }
+
+    content = std::string(100000, 'a');
+    file << content << "\n";
+    file << "last word";
+  }
+
+  zs::vm vm;
+  vm->global().as_table()["file_path"] = zs::_s(vm, filepath);
+
+  zs::object value;
+  REQUIRE(!vm->call_buffer(R"""(
+var file = fs.file(file_path, fs.mode.read);
+
+var lines = [];
+var total = 0;
+for(var i, line : file.lines()) {
+  if(i < 3) {
+    lines.push(line);
+  }
+  total += line.size();
+}
+
+file.close();
+
+var f2 = fs.file(file_path, fs.mode.read);
+var words = [f2.read(), f2.read()];
+var bytes = f2.read(3);
+var line = f2.read_line();
+
+return [lines, total, words, bytes, line, f2.read_all().size()];
+)""",
+      "test", value));
+
+  const zs::array_object& arr = value.as_array();
+  REQUIRE(arr[0].as_array()[0] == zs::_ss("line 0"));
+  REQUIRE(arr[0].as_array()[2] == zs::_ss("line 2"));
+  REQUIRE(arr[1] == (zs::int_t)(3 * 6 + content.size() + 9));
+  REQUIRE(arr[2].as_array()[0] == zs::_ss("line"));
+  REQUIRE(arr[2].as_array()[1] == zs::_ss("0"));
+  REQUIRE(arr[3] == zs::_ss("\r\nl"));
+  REQUIRE(arr[4] == zs::_ss("ine 1"));
+  REQUIRE(arr[5] == (zs::int_t)(3 * 8 + content.size() + 1 + 9));
+}
@@ -90,3 +90,128 @@ return {"r1":r1, "s1":s1};
   //   zb::print("N", value);
   //   zb::print(vm->get_root());
 }
+
+ZTEST_CASE("struct-inline-cache", R"""(
+struct A {
+  var x = 1;
+  private var p = 2;
+
+  function get_p() {
+    return this.p;
+  }
+
+  function set_p(v) {
+    this.p = v;
+  }
+};
+
+struct B {
+  var y = 0;
+  var x = 10;
+};
+
+function get_x(o) {
+  return o.x;
+}
+
+var a = A();
+var r = [];
+
+for(var i = 0; i < 3; i++) {
+  a.set_p(a.get_p() + i);
+  a.x = a.x + get_x(a);
+}
+
+r.push(a.x);
+r.push(a.get_p());
+r.push(get_x(B()));
+r.push(get_x(a));
+return r;
+)""") {
+  REQUIRE(value == zs::_a(vm, { 8, 5, 10, 8 }));
+}
+
+ZTEST_CASE("struct-inline-cache-private", R"""(
+struct A {
+  private var p = 2;
+
+  function get(o) {
+    return o.p;
+  }
+};
+
+var a = A();
+var v = a.get(a);
+return a.get(A());
+)""",
+    compile_good | call_fail) {}
+
+ZTEST_CASE("struct-slot", R"""(
+struct Point {
+  var x = 0;
+  static var count = 0;
+  private var id = 7;
+  var y = 0;
+};
+
+struct Other {
+  var y = 1;
+  var x = 2;
+};
+
+function len2(Point p) {
+  return p.x * p.x + p.y * p.y;
+}
+
+var<Point> p = Point();
+p.x = 3;
+p.y = 4;
+
+// Not a `Point`, the members are not at the same slots.
+var<Point> o = Other();
+o.x = 5;
+
+return [p.x, p.y, len2(p), len2(o), o.x, o.y];
+)""") {
+  REQUIRE(value == zs::_a(vm, { 3, 4, 25, 26, 5, 1 }));
+}
+
+TEST_CASE("struct-slot-opcodes") {
+  constexpr std::string_view code = R"""(
+struct Point {
+  var x = 0;
+  var y = 0;
+};
+
+var<Point> p = Point();
+var q = Point();
+p.x = 1;
+q.y = 2;
+return p.x + q.y;
+)""";
+
+  zs::vm vm;
+
+  zs::object proto;
+  {
+    zs::jit_compiler compiler(vm.get_engine());
+    REQUIRE(!compiler.compile(code, "test", proto));
+  }
+
+  size_t n_get = 0;
+  size_t n_set = 0;
+
+  const zs::instruction_vector& insts = zs::function_prototype_object::as_proto(proto)._instructions;
+  for (auto it = insts.begin(); it != insts.end(); ++it) {
+    n_get += it.get_opcode() == zs::opcode::op_get_struct_slot;
+    n_set += it.get_opcode() == zs::opcode::op_set_struct_slot;
+  }
+
+  // Only `p` is typed.
+  REQUIRE(n_get == 1);
+  REQUIRE(n_set == 1);
+
+  zs::object value;
+  REQUIRE(!vm->call(zs::_c(vm.get_engine(), proto, vm->global()), vm->global(), value));
+  REQUIRE(value == 3);
+}
@@ -430,8 +430,13 @@ var a = "@<<john>>@";
 
     zs::table_object& files = vm[0].as_table()["files"].as_table();
     if (auto it = files.find(name); it != files.end()) {
-      return vm.push_string(zs::render_template_string(
-          vm, nargs >= 3 ? vm[2] : vm[0], it->second.get_string_unchecked(), "@<<", ">>@"));
+      zs::string output(vm.get_engine());
+      if (auto err = zs::render_template_string(
+              vm, nargs >= 3 ? vm[2] : vm[0], it->second.get_string_unchecked(), output, "@<<", ">>@")) {
+        return -1;
+      }
+
+      return vm.push_string(output);
     }
 
     return -1;
@@ -443,11 +448,67 @@ var a = "@<<john>>@";
 @<<inplace("body")>>@
 )"""";
 
-  zs::string result = zs::render_template_string(vm, tbl, content, "@<<", ">>@");
+  zs::string result(vm.get_engine());
+  REQUIRE(!zs::render_template_string(vm, tbl, content, result, "@<<", ">>@"));
 
   //  zb::print("--------------", result);
 }
 
+TEST_CASE("string_template") {
+  zs::vm vm;
+
+  zs::object tbl = zs::_t(vm);
+  tbl.as_table()["name"] = zs::_ss("Alex");
+  tbl.as_table()["n"] = 3;
+
+  {
+    zs::object tmpl;
+    REQUIRE(!zs::create_string_template(vm, "Hello @<name>@, @<n * 2>@.", "@<", ">@", tmpl));
+    REQUIRE(zs::is_string_template(tmpl));
+
+    zs::string output(vm.get_engine());
+    REQUIRE(!zs::as_string_template(tmpl).render(vm, tbl, output));
+    REQUIRE(output == "Hello Alex, 6.");
+
+    tbl.as_table()["n"] = 4;
+    REQUIRE(!zs::as_string_template(tmpl).render(vm, tbl, output));
+    REQUIRE(output == "Hello Alex, 8.");
+  }
+
+  // A fragment that doesn't compile.
+  {
+    zs::object tmpl;
+    REQUIRE(zs::create_string_template(vm, "Hello @<name +>@.", "@<", ">@", tmpl));
+
+    zs::string output(vm.get_engine());
+    REQUIRE(zs::as_string_template(tmpl).render(vm, tbl, output));
+    REQUIRE(zs::render_template_string(vm, tbl, "Hello @<name +>@.", output, "@<", ">@"));
+  }
+
+  // Cached by the engine.
+  for (int i = 0; i < 3; i++) {
+    zs::string output(vm.get_engine());
+    REQUIRE(!zs::render_template_string(vm, tbl, "@<name>@ @<n>@", output, "@<", ">@"));
+    REQUIRE(output == "Alex 4");
+  }
+
+  zs::set_string_template_cache_size(vm.get_engine(), 0);
+
+  zs::string output(vm.get_engine());
+  REQUIRE(!zs::render_template_string(vm, tbl, "@<name>@ @<n>@", output, "@<", ">@"));
+  REQUIRE(output == "Alex 4");
+
+  zs::object value;
+  REQUIRE(!vm->call_buffer(R"""(
+var t = zs.template("<@<name>@>", "@<", ">@");
+return [t.render({ name = "a" }), t.render({ name = "b" })];
+)""",
+      "test", value));
+
+  REQUIRE(value.as_array()[0] == zs::_ss("<a>"));
+  REQUIRE(value.as_array()[1] == zs::_ss("<b>"));
+}
+
 // TEST_CASE("render_template_string") {
 //
 //   zs::vm vm;
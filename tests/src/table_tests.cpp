@@ -15,3 +15,216 @@ return t2;
   REQUIRE(value.as_table()["a"] == 32);
   REQUIRE(value.as_table()["b"] == 44);
 }
+
+ZTEST_CASE("table-inline-cache", R"""(
+var t = { a = 1 };
+var r = [];
+
+for(var i = 0; i < 4; i++) {
+  r.push(t.a);
+  t.a = t.a + 1;
+
+  if(i == 1) {
+    t.clear();
+    t.a = 10;
+  }
+}
+
+return r;
+)""") {
+  REQUIRE(value == zs::_a(vm, { 1, 2, 10, 11 }));
+}
+
+ZTEST_CASE("table-inline-cache-polymorphic", R"""(
+function get_x(o) {
+  return o.x;
+}
+
+var d = { x = 100 };
+var t = {};
+t.set_delegate(d);
+
+var objs = [{ x = 1 }, { x = 2, y = 3 }, { y = 4, x = 3 }, { x = 4 }, { x = 5 }, t];
+var r = [];
+
+for(var o : objs) {
+  r.push(get_x(o) + get_x(o));
+}
+
+d.x = 200;
+r.push(get_x(t));
+
+t.emplace("x", 7);
+r.push(get_x(t));
+
+return r;
+)""") {
+  REQUIRE(value == zs::_a(vm, { 2, 4, 6, 8, 10, 200, 200, 7 }));
+}
+
+TEST_CASE("table_map") {
+  zs::vm vm;
+  zs::object obj = zs::_t(vm);
+  zs::table_object& tbl = obj.as_table();
+
+  for (zs::int_t i = 0; i < 100; i++) {
+    tbl[i] = i * 2;
+  }
+
+  REQUIRE(tbl.size() == 100);
+
+  for (zs::int_t i = 0; i < 100; i++) {
+    REQUIRE(tbl[i] == i * 2);
+  }
+
+  for (zs::int_t i = 0; i < 100; i += 2) {
+    REQUIRE(!tbl.erase(i));
+  }
+
+  REQUIRE(tbl.size() == 50);
+
+  for (zs::int_t i = 0; i < 100; i++) {
+    REQUIRE(tbl.contains(zs::object(i)) == (i % 2 == 1));
+  }
+
+  // Assigning a value from the same table while it grows.
+  zs::object small_obj = zs::_t(vm);
+  zs::table_object& small_tbl = small_obj.as_table();
+  small_tbl["a"] = 1;
+
+  for (zs::int_t i = 0; i < 20; i++) {
+    REQUIRE(!small_tbl.set(zs::object(i), small_tbl.get_map().begin()->second));
+  }
+
+  REQUIRE(small_tbl.size() == 21);
+  REQUIRE(small_tbl[19] == 1);
+  REQUIRE(small_tbl.contains(std::string_view("a")));
+
+  zs::object t1 = zs::_t(vm, { { zs::_ss("a"), 1 }, { zs::_ss("b"), 2 } });
+  zs::object t2 = zs::_t(vm, { { zs::_ss("b"), 2 }, { zs::_ss("a"), 1 } });
+  REQUIRE(t1.as_table() == t2.as_table());
+}
+
+TEST_CASE("interned-string-keys") {
+  zs::vm vm;
+  const size_t count = vm.get_engine()->get_interned_string_count();
+
+  {
+    zs::object k1 = zs::object::create_interned_string(vm.get_engine(), "a_key_longer_than_small_string");
+    zs::object k2 = zs::object::create_interned_string(vm.get_engine(), "a_key_longer_than_small_string");
+    REQUIRE(k1.is_long_string());
+    REQUIRE(k1._lstring == k2._lstring);
+    REQUIRE(k1._lstring->is_interned());
+    REQUIRE(vm.get_engine()->get_interned_string_count() == count + 1);
+
+    // Only identifier sized strings are interned.
+    REQUIRE_FALSE(zs::_s(vm, "a_key_longer_than_small_string")._lstring->is_interned());
+    const std::string too_long(zs::constants::k_max_interned_string_size + 1, 'a');
+    REQUIRE_FALSE(zs::object::create_interned_string(vm.get_engine(), too_long)._lstring->is_interned());
+
+    zs::object k3 = zs::object::create_concat_string(vm.get_engine(), "a_key_longer_than_", "small_string");
+    REQUIRE_FALSE(k3._lstring->is_interned());
+    REQUIRE(k1.strict_equal(k3));
+
+    zs::object obj = zs::_t(vm);
+    zs::table_object& tbl = obj.as_table();
+    tbl[k1] = 1;
+    REQUIRE(tbl[k3] == 1);
+    REQUIRE(tbl.contains(std::string_view("a_key_longer_than_small_string")));
+  }
+
+  // The engine doesn't keep the strings alive.
+  REQUIRE(vm.get_engine()->get_interned_string_count() == count);
+}
+
+namespace {
+/// Runs `code` with an `erase(table, key)` function.
+zs::object run_table_erase_script(zs::vm& vm, std::string_view code) {
+  vm->global()._table->emplace("erase", [](zs::vm_ref vm) -> zs::int_t {
+    return vm.push(!vm[1].as_table().erase(vm[2]));
+  });
+
+  zs::object value;
+  REQUIRE(!vm->call_buffer(code, "test", value));
+  return value;
+}
+} // namespace
+
+TEST_CASE("table-erase-in-foreach") {
+  zs::vm vm;
+
+  // The current pair is erased, the last pair takes its place and is still visited.
+  const zs::object value = run_table_erase_script(vm, R"""(
+var t = { a = 1, b = 2, c = 3, d = 4, e = 5 };
+var sum = 0;
+var count = 0;
+var keys = "";
+
+for(var k, v : t) {
+  sum += v;
+  count++;
+  keys += k;
+
+  if(v % 2 == 0) {
+    this.erase(t, k);
+  }
+}
+
+return [sum, count, t.size(), t.contains("b"), t.contains("c"), keys];
+)""");
+
+  const zs::array_object& arr = value.as_array();
+  REQUIRE(arr[0] == 15);
+  REQUIRE(arr[1] == 5);
+  REQUIRE(arr[2] == 3);
+  REQUIRE(arr[3] == false);
+  REQUIRE(arr[4] == true);
+
+  // Forward, same order as the table iterators.
+  REQUIRE(arr[5] == zs::_ss("abecd"));
+}
+
+TEST_CASE("table-erase-unvisited-in-foreach") {
+  zs::vm vm;
+
+  // Erasing a key that wasn't visited yet doesn't visit a pair twice.
+  const zs::object value = run_table_erase_script(vm, R"""(
+var t = { a = 1, b = 2, c = 3, d = 4, e = 5 };
+var keys = "";
+
+for(var k, v : t) {
+  keys += k;
+
+  if(k == "a") {
+    this.erase(t, "b");
+  }
+}
+
+return keys;
+)""");
+
+  REQUIRE(value == zs::_ss("aecd"));
+}
+
+TEST_CASE("table-erase-all-in-foreach") {
+  zs::vm vm;
+  const zs::object value = run_table_erase_script(vm, R"""(
+var t = {};
+for(var i = 0; i < 20; i++) {
+  t[i] = i;
+}
+
+var sum = 0;
+var count = 0;
+
+for(var k, v : t) {
+  sum += v;
+  count++;
+  this.erase(t, k);
+}
+
+return [sum, count, t.size()];
+)""");
+
+  REQUIRE(value == zs::_a(vm, { 190, 20, 0 }));
+}
@@ -0,0 +1,134 @@
+#include <catch2.h>
+#include <zscript/base/container/flat_hash_map.h>
+#include <string>
+
+TEST_CASE("zb::flat_hash_map") {
+  zb::flat_hash_map<int, int> map;
+  REQUIRE(map.empty());
+  REQUIRE(map.find(1) == map.end());
+  REQUIRE(map.begin() == map.end());
+
+  for (int i = 0; i < 1000; i++) {
+    REQUIRE(map.emplace(i, i * 2).second);
+  }
+
+  REQUIRE(map.size() == 1000);
+  REQUIRE_FALSE(map.emplace(10, 0).second);
+  REQUIRE(map[10] == 20);
+
+  for (int i = 0; i < 1000; i += 2) {
+    REQUIRE(map.erase(i) == 1);
+  }
+
+  REQUIRE(map.size() == 500);
+
+  int sum = 0;
+  for (const auto& it : map) {
+    REQUIRE(it.first % 2 == 1);
+    REQUIRE(it.second == it.first * 2);
+    sum += it.first;
+  }
+
+  REQUIRE(sum == 250000);
+  REQUIRE_FALSE(map.contains(10));
+  REQUIRE(map.contains(11));
+}
+
+TEST_CASE("zb::flat_hash_map tombstones") {
+  // Insert and erase a lot more keys than the capacity, the tombstones must be
+  // reused or cleaned up without growing forever.
+  zb::flat_hash_map<int, int> map;
+
+  for (int i = 0; i < 100000; i++) {
+    map[i] = i;
+    map.erase(i - 16);
+  }
+
+  REQUIRE(map.size() == 16);
+  REQUIRE(map.capacity() < 64);
+
+  for (int i = 100000 - 16; i < 100000; i++) {
+    REQUIRE(map.find(i)->second == i);
+  }
+}
+
+struct string_hash {
+  inline size_t operator()(std::string_view s) const noexcept { return zb::rapid_hash(s); }
+};
+
+struct string_equal {
+  inline bool operator()(std::string_view a, std::string_view b) const noexcept { return a == b; }
+};
+
+TEST_CASE("zb::flat_hash_map transparent") {
+  zb::flat_hash_map<std::string, int, string_hash, string_equal> map;
+  map["john"] = 1;
+  map.insert_or_assign("bingo", 2);
+  map.insert_or_assign(std::string_view("bingo"), 3);
+
+  REQUIRE(map.size() == 2);
+  REQUIRE(map.find(std::string_view("bingo"))->second == 3);
+  REQUIRE(map.contains("john"));
+
+  zb::flat_hash_map<std::string, int, string_hash, string_equal> map2 = map;
+  REQUIRE(map2 == map);
+
+  map2.erase(map2.find("john"));
+  REQUIRE(map2.size() == 1);
+  REQUIRE_FALSE(map2 == map);
+
+  map2 = std::move(map);
+  REQUIRE(map2.size() == 2);
+  REQUIRE(map.empty());
+}
+
+TEST_CASE("zb::flat_hash_set") {
+  int values[64];
+  zb::flat_hash_set<int*> set;
+
+  for (int& v : values) {
+    REQUIRE(set.insert(&v).second);
+  }
+
+  REQUIRE_FALSE(set.insert(values + 3).second);
+  REQUIRE(set.size() == 64);
+
+  set.erase(values + 3);
+  REQUIRE_FALSE(set.contains(values + 3));
+
+  set.clear();
+  REQUIRE(set.empty());
+  REQUIRE(set.begin() == set.end());
+}
+
+TEST_CASE("zb::flat_hash_map rehash empty") {
+  zb::flat_hash_map<int, int> map;
+  map.rehash(16);
+  REQUIRE(map.capacity() >= 16);
+  REQUIRE(map.capacity() < 64);
+  REQUIRE(map.empty());
+
+  map.emplace(1, 2);
+  REQUIRE(map[1] == 2);
+
+  map.clear();
+  map.rehash(0);
+  REQUIRE(map.empty());
+  REQUIRE(map.find(1) == map.end());
+}
+
+TEST_CASE("zb::flat_hash_map emplace from an element") {
+  zb::flat_hash_map<int, std::string> map;
+  map.emplace(0, std::string(64, 'a'));
+
+  // The value refers to an element while the table grows.
+  for (int i = 1; i < 200; i++) {
+    REQUIRE(map.try_emplace(i, map[i - 1]).second);
+    REQUIRE(map.emplace(i + 1000, map.find(0)->second).second);
+  }
+
+  REQUIRE(map.size() == 399);
+  for (const auto& it : map) {
+    REQUIRE(it.second == std::string(64, 'a'));
+  }
+}